@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compares formatting of numeric feed values with dtoa against snprintf.
+ * Usage: benchmark_dtoa [number_of_values]
+ */
+
+#include "utility/dtoa.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_NUMBER_OF_VALUES 1000000
+
+typedef size_t (*format_t)(double value, char* buffer);
+
+static size_t format_snprintf_fixed(double value, char* buffer)
+{
+    return (size_t)snprintf(buffer, DTOA_BUFFER_SIZE, "%f", value);
+}
+
+static size_t format_snprintf_roundtrip(double value, char* buffer)
+{
+    return (size_t)snprintf(buffer, DTOA_BUFFER_SIZE, "%.17g", value);
+}
+
+static size_t format_dtoa_shortest(double value, char* buffer)
+{
+    return dtoa_shortest(value, buffer);
+}
+
+static size_t format_dtoa_fixed(double value, char* buffer)
+{
+    return dtoa_fixed(value, 2, buffer);
+}
+
+static void run(const char* name, format_t format, const double* values, size_t number_of_values)
+{
+    char buffer[DTOA_BUFFER_SIZE];
+    size_t total_length = 0;
+
+    const clock_t start = clock();
+    for (size_t i = 0; i < number_of_values; ++i) {
+        total_length += format(values[i], buffer);
+    }
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-24s %8.1f ns/value %6.2f chars/value\n", name, seconds * 1e9 / (double)number_of_values,
+           (double)total_length / (double)number_of_values);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t number_of_values = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_NUMBER_OF_VALUES;
+
+    double* values = malloc(number_of_values * sizeof(double));
+    if (!values) {
+        return 1;
+    }
+
+    /* Sensor-like readings with a few decimals, and arbitrary doubles */
+    srand(1);
+    for (size_t i = 0; i < number_of_values; ++i) {
+        if (i % 2 == 0) {
+            values[i] = (double)(rand() % 200000 - 100000) / 100.0;
+        } else {
+            values[i] = ((double)rand() / RAND_MAX - 0.5) * 1e6;
+        }
+    }
+
+    run("snprintf(\"%f\")", format_snprintf_fixed, values, number_of_values);
+    run("snprintf(\"%.17g\")", format_snprintf_roundtrip, values, number_of_values);
+    run("dtoa_shortest", format_dtoa_shortest, values, number_of_values);
+    run("dtoa_fixed, 2 decimals", format_dtoa_fixed, values, number_of_values);
+
+    free(values);
+    return 0;
+}
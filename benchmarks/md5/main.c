@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Measures MD5 throughput of whole-file verification, for several sizes of md5_update calls.
+ * Usage: benchmark_md5 [file_size_in_MB]
+ */
+
+#include "utility/md5.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_FILE_SIZE_MB 64
+
+static void run(const char* name, const uint8_t* file, size_t file_size, size_t update_size)
+{
+    uint8_t hash[16];
+    MD5_CTX md5_ctx;
+
+    const clock_t start = clock();
+    md5_init(&md5_ctx);
+    for (size_t offset = 0; offset < file_size; offset += update_size) {
+        md5_update(&md5_ctx, file + offset, file_size - offset < update_size ? file_size - offset : update_size);
+    }
+    md5_final(&md5_ctx, hash);
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-32s %8.1f MB/s (%02x%02x)\n", name, (double)file_size / seconds / 1e6, (unsigned int)hash[0],
+           (unsigned int)hash[1]);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t file_size = (argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_FILE_SIZE_MB) * 1024 * 1024;
+
+    /* One extra byte for unaligned input */
+    uint8_t* file = malloc(file_size + 1);
+    if (!file) {
+        return 1;
+    }
+
+    srand(1);
+    for (size_t i = 0; i < file_size + 1; ++i) {
+        file[i] = (uint8_t)rand();
+    }
+
+    run("single update", file, file_size, file_size);
+    run("single update, unaligned", file + 1, file_size, file_size);
+    run("1 KB updates (verification read)", file, file_size, 1024);
+    run("960 B updates (transfer chunks)", file, file_size, 960);
+    run("61 B updates", file, file_size, 61);
+
+    free(file);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compares SHA-256 implementations on file transfer sized chunks.
+ * Usage: benchmark_sha256 [chunk_size] [number_of_chunks]
+ */
+
+#include "utility/sha256.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_CHUNK_SIZE 1024
+#define DEFAULT_NUMBER_OF_CHUNKS 100000
+
+static void run(const char* name, sha256_implementation_t implementation, const uint8_t* chunk, size_t chunk_size,
+                size_t number_of_chunks)
+{
+    uint8_t hash[32];
+    uint8_t checksum = 0;
+
+    if (!sha256_set_implementation(implementation)) {
+        printf("%-24s not supported\n", name);
+        return;
+    }
+
+    const clock_t start = clock();
+    for (size_t i = 0; i < number_of_chunks; ++i) {
+        sha256(chunk, chunk_size, hash);
+        checksum = (uint8_t)(checksum + hash[0]);
+    }
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%-24s %8.1f us/chunk %8.1f MB/s (%02x)\n", name, seconds * 1e6 / (double)number_of_chunks,
+           (double)(chunk_size * number_of_chunks) / seconds / 1e6, (unsigned int)checksum);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t chunk_size = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_CHUNK_SIZE;
+    const size_t number_of_chunks = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : DEFAULT_NUMBER_OF_CHUNKS;
+
+    uint8_t* chunk = malloc(chunk_size);
+    if (!chunk) {
+        return 1;
+    }
+
+    srand(1);
+    for (size_t i = 0; i < chunk_size; ++i) {
+        chunk[i] = (uint8_t)rand();
+    }
+
+    run("portable", SHA256_IMPLEMENTATION_PORTABLE, chunk, chunk_size, number_of_chunks);
+    run("SHA-NI", SHA256_IMPLEMENTATION_SHA_NI, chunk, chunk_size, number_of_chunks);
+
+    free(chunk);
+    return 0;
+}
@@ -18,53 +18,68 @@
 #include "data_transmission.h"
 #include "utility/wolk_utils.h"
 
-static transmission_io_functions_t* io_functions = NULL;
-static unsigned char* starting_add = NULL;
-static int number_of_bytes;
+static int io_send(transmission_io_functions_t* io_functions, unsigned char* buffer, int count)
+{
+    if (io_functions->send_with_context) {
+        return io_functions->send_with_context(io_functions->context, buffer, (unsigned int)count);
+    }
+
+    return io_functions->send(buffer, (unsigned int)count);
+}
+
+static int io_recv(transmission_io_functions_t* io_functions, unsigned char* buffer, int count)
+{
+    if (io_functions->recv_with_context) {
+        return io_functions->recv_with_context(io_functions->context, buffer, (unsigned int)count);
+    }
 
+    return io_functions->recv(buffer, (unsigned int)count);
+}
 
-int transmission_open(transmission_io_functions_t* trans_io)
+int transmission_open(transmission_t* transmission, const transmission_io_functions_t* trans_io)
 {
-    io_functions = trans_io;
+    WOLK_ASSERT(transmission != NULL);
+    WOLK_ASSERT(trans_io != NULL);
+
+    transmission->io_functions = *trans_io;
+    transmission->starting_add = NULL;
+    transmission->number_of_bytes = 0;
 
     return 0;
 }
 
-int transmission_get_data_nb(void* socket, unsigned char* buffer, int count)
+int transmission_get_data_nb(void* transmission, unsigned char* buffer, int count)
 {
-    transmission_io_functions_t* tmp_io = io_functions;
+    transmission_io_functions_t* tmp_io = &((transmission_t*)transmission)->io_functions;
     int length = 0;
 
-    WOLK_ASSERT((tmp_io != NULL) && (tmp_io->recv != NULL));
+    WOLK_ASSERT((tmp_io->recv != NULL) || (tmp_io->recv_with_context != NULL));
 
-    if ((length = tmp_io->recv(buffer, count)) >= 0) {
+    if ((length = io_recv(tmp_io, buffer, count)) >= 0) {
         return length;
     }
 
     return TRANSPORT_ERROR;
 }
 
-void transmission_buffer_nb_start(int socket, unsigned char* buffer, int buffer_length)
+void transmission_buffer_nb_start(transmission_t* transmission, unsigned char* buffer, int buffer_length)
 {
-    WOLK_UNUSED(socket);
-
-    starting_add = buffer;
-    number_of_bytes = buffer_length;
+    transmission->starting_add = buffer;
+    transmission->number_of_bytes = buffer_length;
 }
 
-int transmission_buffer_nb(int socket)
+int transmission_buffer_nb(transmission_t* transmission)
 {
-    WOLK_UNUSED(socket);
-
-    transmission_io_functions_t* tmp_io = io_functions;
+    transmission_io_functions_t* tmp_io = &transmission->io_functions;
     int length;
 
-    WOLK_ASSERT((tmp_io != NULL) && (tmp_io->send != NULL) && (starting_add != NULL));
+    WOLK_ASSERT((tmp_io->send != NULL) || (tmp_io->send_with_context != NULL));
+    WOLK_ASSERT(transmission->starting_add != NULL);
 
-    if ((length = tmp_io->send(starting_add, number_of_bytes)) > 0) {
-        starting_add += length;
+    if ((length = io_send(tmp_io, transmission->starting_add, transmission->number_of_bytes)) > 0) {
+        transmission->starting_add += length;
 
-        if ((number_of_bytes -= length) <= 0) {
+        if ((transmission->number_of_bytes -= length) <= 0) {
             return TRANSPORT_DONE;
         }
     } else if (length < 0) {
@@ -73,12 +88,12 @@ int transmission_buffer_nb(int socket)
     return TRANSPORT_AGAIN;
 }
 
-int transmission_buffer(int socket, unsigned char* buffer, int buffer_length)
+int transmission_buffer(transmission_t* transmission, unsigned char* buffer, int buffer_length)
 {
     int response = 0;
 
-    transmission_buffer_nb_start(socket, buffer, buffer_length);
-    while ((response = transmission_buffer_nb(socket)) == TRANSPORT_AGAIN) {
+    transmission_buffer_nb_start(transmission, buffer, buffer_length);
+    while ((response = transmission_buffer_nb(transmission)) == TRANSPORT_AGAIN) {
     }
 
     if (response == TRANSPORT_DONE) {
@@ -86,4 +101,4 @@ int transmission_buffer(int socket, unsigned char* buffer, int buffer_length)
     }
 
     return TRANSPORT_ERROR;
-}
\ No newline at end of file
+}
@@ -19,16 +19,30 @@
 typedef struct {
     int (*send)(unsigned char* address, unsigned int bytes);
     int (*recv)(unsigned char* address, unsigned int max_bytes_number);
+
+    /* Used instead of send/recv when set, receive 'context' of the connection */
+    int (*send_with_context)(void* context, unsigned char* address, unsigned int bytes);
+    int (*recv_with_context)(void* context, unsigned char* address, unsigned int max_bytes_number);
+    void* context;
 } transmission_io_functions_t;
 
+/* State of single connection, pointer to it is passed as 'sck' of MQTTTransport */
+typedef struct {
+    transmission_io_functions_t io_functions;
+
+    /* Write in progress */
+    unsigned char* starting_add;
+    int number_of_bytes;
+} transmission_t;
+
 enum { TRANSPORT_ERROR = -1, TRANSPORT_AGAIN = 0, TRANSPORT_DONE = 1 };
 
-int transmission_open(transmission_io_functions_t* trans_io);
+int transmission_open(transmission_t* transmission, const transmission_io_functions_t* trans_io);
 
-int transmission_get_data_nb(void* socket, unsigned char* buffer, int count);
+int transmission_get_data_nb(void* transmission, unsigned char* buffer, int count);
 
-void transmission_buffer_nb_start(int socket, unsigned char* buffer, int buffer_length);
-int transmission_buffer_nb(int socket);
-int transmission_buffer(int socket, unsigned char* buffer, int buffer_length);
+void transmission_buffer_nb_start(transmission_t* transmission, unsigned char* buffer, int buffer_length);
+int transmission_buffer_nb(transmission_t* transmission);
+int transmission_buffer(transmission_t* transmission, unsigned char* buffer, int buffer_length);
 
 #endif
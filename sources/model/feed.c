@@ -74,6 +74,46 @@ uint64_t feed_get_utc(feed_t* feed)
     return feed->utc;
 }
 
+static void typed_feed_init(typed_feed_t* feed, const char* reference, data_type_t type, uint64_t utc)
+{
+    feed->reference = reference;
+    feed->key = NULL;
+    feed->key_length = 0;
+    feed->type = type;
+    feed->vector = NULL;
+    feed->size = 1;
+    feed->decimals = -1;
+    feed->utc = utc;
+}
+
+void typed_feed_init_numeric(typed_feed_t* feed, const char* reference, double value, uint64_t utc)
+{
+    typed_feed_init(feed, reference, NUMERIC, utc);
+    feed->value.numeric = value;
+}
+
+void typed_feed_init_boolean(typed_feed_t* feed, const char* reference, bool value, uint64_t utc)
+{
+    typed_feed_init(feed, reference, BOOLEAN, utc);
+    feed->value.boolean = value;
+}
+
+void typed_feed_init_string(typed_feed_t* feed, const char* reference, const char* value, size_t length,
+                            uint64_t utc)
+{
+    typed_feed_init(feed, reference, STRING, utc);
+    feed->value.string.data = value;
+    feed->value.string.length = length;
+}
+
+void typed_feed_init_vector(typed_feed_t* feed, const char* reference, const double* values, uint16_t size,
+                            uint64_t utc)
+{
+    typed_feed_init(feed, reference, VECTOR, utc);
+    feed->vector = values;
+    feed->size = size;
+}
+
 void feed_initialize_registration(feed_registration_t* feed, char* name, const char* reference, char* unit,
                                   const feed_type_t feedType)
 {
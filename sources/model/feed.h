@@ -47,6 +47,51 @@ typedef struct {
     uint64_t utc;
 } feed_t;
 
+/**
+ * Receives feeds one at a time while message is being deserialized. Feed is valid only during the call.
+ */
+typedef void (*feed_callback_t)(void* context, feed_t* feed);
+
+/* String value of a typed feed, does not have to be null terminated */
+typedef struct {
+    const char* data;
+    size_t length;
+} feed_string_t;
+
+typedef union {
+    double numeric;
+    bool boolean;
+    feed_string_t string;
+} feed_value_t;
+
+/**
+ * Feed kept in its native type instead of text, serialized without intermediate conversion and taking a few dozen
+ * bytes instead of the FEEDS_MAX_NUMBER * FEED_ELEMENT_SIZE of feed_t.
+ *
+ * Single value is held in 'value'; VECTOR feed references 'size' numeric values in 'vector'. Reference, string data
+ * and vector values are not copied and have to outlive the feed.
+ */
+typedef struct {
+    const char* reference;
+    const char* key;   /* Reference already serialized as key by parser_serialize_typed_feed_key(), or NULL */
+    size_t key_length;
+    data_type_t type;
+
+    feed_value_t value;
+    const double* vector;
+    uint16_t size;
+
+    int8_t decimals; /* Decimals numeric values are rounded to, negative for the shortest form */
+
+    uint64_t utc;
+} typed_feed_t;
+
+/**
+ * Receives typed feeds one at a time while message is being deserialized. Feed and the strings it references are
+ * valid only during the call.
+ */
+typedef void (*typed_feed_callback_t)(void* context, const typed_feed_t* feed);
+
 void feed_initialize(feed_t* feed, uint16_t feed_size, const char* reference);
 
 void feed_clear(feed_t* feed);
@@ -60,6 +105,13 @@ char* feed_get_data_at(feed_t* feed, size_t data_position);
 void feed_set_utc(feed_t* feed, uint64_t utc);
 uint64_t feed_get_utc(feed_t* feed);
 
+void typed_feed_init_numeric(typed_feed_t* feed, const char* reference, double value, uint64_t utc);
+void typed_feed_init_boolean(typed_feed_t* feed, const char* reference, bool value, uint64_t utc);
+void typed_feed_init_string(typed_feed_t* feed, const char* reference, const char* value, size_t length,
+                            uint64_t utc);
+void typed_feed_init_vector(typed_feed_t* feed, const char* reference, const double* values, uint16_t size,
+                            uint64_t utc);
+
 void feed_initialize_registration(feed_registration_t* feed, char* name, const char* reference, char* unit,
                                   feed_type_t feedType);
 
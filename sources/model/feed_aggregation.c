@@ -0,0 +1,122 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/feed_aggregation.h"
+#include "utility/wolk_utils.h"
+
+#include <string.h>
+
+void feed_aggregation_init(feed_aggregation_t* aggregation, const char* reference, feed_aggregation_type_t type,
+                           uint64_t window)
+{
+    /* Sanity check */
+    WOLK_ASSERT(aggregation);
+    WOLK_ASSERT(reference);
+    WOLK_ASSERT(window > 0);
+
+    strncpy(aggregation->reference, reference, REFERENCE_SIZE - 1);
+    aggregation->reference[REFERENCE_SIZE - 1] = '\0';
+    aggregation->type = type;
+    aggregation->window = window;
+
+    aggregation->window_start = 0;
+    aggregation->window_opened = 0;
+    aggregation->has_utc = false;
+    aggregation->count = 0;
+    aggregation->min = 0;
+    aggregation->max = 0;
+    aggregation->sum = 0;
+}
+
+bool feed_aggregation_add(feed_aggregation_t* aggregation, double value, uint64_t time, bool has_utc,
+                          uint64_t uptime, typed_feed_t* reading)
+{
+    /* Sanity check */
+    WOLK_ASSERT(aggregation);
+    WOLK_ASSERT(reading);
+
+    /* Value outside of the window, or timed differently, starts the next one */
+    bool closed = false;
+    if (aggregation->count > 0
+        && (has_utc != aggregation->has_utc || time < aggregation->window_start
+            || time - aggregation->window_start >= aggregation->window)) {
+        closed = feed_aggregation_close(aggregation, uptime, true, reading);
+    }
+
+    if (aggregation->count == 0) {
+        aggregation->window_start = time - time % aggregation->window;
+        aggregation->window_opened = uptime;
+        aggregation->has_utc = has_utc;
+        aggregation->min = value;
+        aggregation->max = value;
+        aggregation->sum = 0;
+    }
+
+    aggregation->count++;
+    aggregation->sum += value;
+    if (value < aggregation->min) {
+        aggregation->min = value;
+    }
+    if (value > aggregation->max) {
+        aggregation->max = value;
+    }
+
+    return closed;
+}
+
+bool feed_aggregation_close(feed_aggregation_t* aggregation, uint64_t uptime, bool force, typed_feed_t* reading)
+{
+    /* Sanity check */
+    WOLK_ASSERT(aggregation);
+    WOLK_ASSERT(reading);
+
+    if (aggregation->count == 0) {
+        return false;
+    }
+
+    /* Window of values without UTC time starts at uptime multiple of its length */
+    const uint64_t start = aggregation->has_utc ? aggregation->window_opened : aggregation->window_start;
+    if (!force && uptime >= start && uptime - start < aggregation->window) {
+        return false;
+    }
+
+    aggregation->summary[0] = aggregation->min;
+    aggregation->summary[1] = aggregation->max;
+    aggregation->summary[2] = aggregation->sum / aggregation->count;
+    aggregation->summary[3] = aggregation->count;
+
+    const uint64_t utc = aggregation->has_utc ? aggregation->window_start : 0;
+    switch (aggregation->type) {
+    case FEED_AGGREGATION_MIN:
+        typed_feed_init_numeric(reading, aggregation->reference, aggregation->summary[0], utc);
+        break;
+    case FEED_AGGREGATION_MAX:
+        typed_feed_init_numeric(reading, aggregation->reference, aggregation->summary[1], utc);
+        break;
+    case FEED_AGGREGATION_COUNT:
+        typed_feed_init_numeric(reading, aggregation->reference, aggregation->summary[3], utc);
+        break;
+    case FEED_AGGREGATION_SUMMARY:
+        typed_feed_init_vector(reading, aggregation->reference, aggregation->summary, 4, utc);
+        break;
+    default:
+        typed_feed_init_numeric(reading, aggregation->reference, aggregation->summary[2], utc);
+        break;
+    }
+
+    aggregation->count = 0;
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FEED_AGGREGATION_H
+#define FEED_AGGREGATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "model/feed.h"
+#include "size_definitions.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Value reported for each window of an aggregated feed.
+ */
+typedef enum {
+    FEED_AGGREGATION_AVERAGE = 0,
+    FEED_AGGREGATION_MIN,
+    FEED_AGGREGATION_MAX,
+    FEED_AGGREGATION_COUNT,
+    FEED_AGGREGATION_SUMMARY /**< Multi-value reading of minimum, maximum, average and count */
+} feed_aggregation_type_t;
+
+/**
+ * Accumulator of numeric values of a single feed over windows of fixed length.
+ */
+typedef struct {
+    char reference[REFERENCE_SIZE];
+    feed_aggregation_type_t type;
+    uint64_t window; /**< Length of window in milliseconds, windows start at multiples of it */
+
+    uint64_t window_start;
+    uint64_t window_opened; /**< Uptime in milliseconds at which the first value of the window was added */
+    bool has_utc; /**< Values of the window carry UTC time, reading is timestamped with start of the window */
+    uint32_t count;
+    double min;
+    double max;
+    double sum;
+
+    double summary[4]; /**< Values of the last reading */
+} feed_aggregation_t;
+
+void feed_aggregation_init(feed_aggregation_t* aggregation, const char* reference, feed_aggregation_type_t type,
+                           uint64_t window);
+
+/**
+ * Adds value taken at 'time' in milliseconds, with or without UTC time, at 'uptime' in milliseconds.
+ * Returns true if the value closed the previous window, whose reading is then set to 'reading'.
+ */
+bool feed_aggregation_add(feed_aggregation_t* aggregation, double value, uint64_t time, bool has_utc,
+                          uint64_t uptime, typed_feed_t* reading);
+
+/**
+ * Closes window which ended by 'uptime' in milliseconds, or any open window if 'force' is set.
+ * Window of values with UTC time ends once it was open for its length of uptime, as it certainly ended by then.
+ * Returns true if reading of the closed window is set to 'reading'.
+ * Reading refers to the aggregation and is valid until the next window is closed.
+ */
+bool feed_aggregation_close(feed_aggregation_t* aggregation, uint64_t uptime, bool force, typed_feed_t* reading);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/feed_filter.h"
+#include "utility/wolk_utils.h"
+
+#include <string.h>
+
+static double absolute(double value)
+{
+    return value < 0 ? -value : value;
+}
+
+/* FNV-1a */
+static uint32_t hash(const void* data, size_t size)
+{
+    const uint8_t* byte = (const uint8_t*)data;
+    uint32_t value = 2166136261u;
+
+    for (size_t i = 0; i < size; ++i) {
+        value ^= byte[i];
+        value *= 16777619u;
+    }
+
+    return value;
+}
+
+/* Time rules, 'changed' tells whether value exceeds the deadbands */
+static bool accept(feed_filter_t* filter, bool changed, uint64_t time)
+{
+    if (!filter->has_reported || time < filter->last_time) {
+        return true;
+    }
+
+    const uint64_t elapsed = time - filter->last_time;
+    if (filter->settings.min_interval != 0 && elapsed < filter->settings.min_interval) {
+        return false;
+    }
+
+    if (filter->settings.max_silence != 0 && elapsed >= filter->settings.max_silence) {
+        return true;
+    }
+
+    return changed;
+}
+
+void feed_filter_init(feed_filter_t* filter, const char* reference, const feed_filter_settings_t* settings)
+{
+    /* Sanity check */
+    WOLK_ASSERT(filter);
+    WOLK_ASSERT(reference);
+    WOLK_ASSERT(settings);
+
+    strncpy(filter->reference, reference, REFERENCE_SIZE - 1);
+    filter->reference[REFERENCE_SIZE - 1] = '\0';
+    filter->settings = *settings;
+
+    filter->has_reported = false;
+    filter->last_value = 0;
+    filter->last_hash = 0;
+    filter->last_time = 0;
+}
+
+bool feed_filter_accept_numeric(feed_filter_t* filter, double value, uint64_t time)
+{
+    /* Sanity check */
+    WOLK_ASSERT(filter);
+
+    const double change = absolute(value - filter->last_value);
+    bool changed = !(change <= 0); /* NaN is a change */
+    if (filter->settings.absolute_deadband > 0) {
+        changed = changed && !(change <= filter->settings.absolute_deadband);
+    }
+    if (filter->settings.percent_deadband > 0) {
+        changed = changed && !(change <= absolute(filter->last_value) * filter->settings.percent_deadband / 100);
+    }
+
+    if (!accept(filter, changed, time)) {
+        return false;
+    }
+
+    filter->has_reported = true;
+    filter->last_value = value;
+    filter->last_time = time;
+    return true;
+}
+
+bool feed_filter_accept_data(feed_filter_t* filter, const void* data, size_t size, uint64_t time)
+{
+    /* Sanity check */
+    WOLK_ASSERT(filter);
+
+    const uint32_t value_hash = hash(data, size);
+    if (!accept(filter, value_hash != filter->last_hash, time)) {
+        return false;
+    }
+
+    filter->has_reported = true;
+    filter->last_hash = value_hash;
+    filter->last_time = time;
+    return true;
+}
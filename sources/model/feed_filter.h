@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FEED_FILTER_H
+#define FEED_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "size_definitions.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Report by exception settings of a feed, zero disables the setting.
+ */
+typedef struct {
+    double absolute_deadband; /**< Smallest change of value which is reported */
+    double percent_deadband;  /**< Smallest change which is reported, in percents of the last reported value */
+    uint64_t min_interval;    /**< Shortest time between two reported values, in milliseconds */
+    uint64_t max_silence;     /**< Longest time without reported value, value is reported regardless of change */
+} feed_filter_settings_t;
+
+/**
+ * Filter of values of a single feed, holds the last reported value.
+ */
+typedef struct {
+    char reference[REFERENCE_SIZE];
+    feed_filter_settings_t settings;
+
+    bool has_reported;   /**< Nothing is filtered out until the first value is reported */
+    double last_value;   /**< Last reported numeric or boolean value */
+    uint32_t last_hash;  /**< Hash of the last reported string or multi-value value */
+    uint64_t last_time;  /**< Time the last value was reported at, in milliseconds */
+} feed_filter_t;
+
+void feed_filter_init(feed_filter_t* filter, const char* reference, const feed_filter_settings_t* settings);
+
+/**
+ * Returns true if numeric or boolean value taken at 'time' is to be reported, remembering it as the last reported.
+ * Value is reported when it changes beyond every set deadband, or when 'max_silence' elapsed, but never before
+ * 'min_interval' elapses.
+ */
+bool feed_filter_accept_numeric(feed_filter_t* filter, double value, uint64_t time);
+
+/**
+ * Returns true if string or multi-value value of 'size' bytes is to be reported. Any change of the value exceeds
+ * deadbands. @see feed_filter_accept_numeric()
+ */
+bool feed_filter_accept_data(feed_filter_t* filter, const void* data, size_t size, uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
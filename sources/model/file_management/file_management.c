@@ -19,6 +19,7 @@
 #include "file_management_parameter.h"
 #include "size_definitions.h"
 #include "utility/md5.h"
+#include "utility/sha256.h"
 #include "utility/wolk_utils.h"
 
 #include <stdbool.h>
@@ -31,6 +32,8 @@ typedef enum { STATE_IDLE = 0, STATE_PACKET_FILE_TRANSFER, STATE_URL_DOWNLOAD, S
 
 enum { MAX_RETRIES = 3 };
 
+enum { NO_REASSEMBLY_SLOT = -1 };
+
 static void handle_file_management(file_management_t* file_management, file_management_parameter_t* parameter);
 static void handle_url_download(file_management_t* file_management, char* url_download);
 static void handle_abort(file_management_t* file_management, uint8_t* packet);
@@ -56,6 +59,22 @@ static bool purge_files(file_management_t* file_management);
 
 static void reset_state(file_management_t* file_management);
 
+static size_t chunk_data_size(file_management_t* file_management);
+static size_t expected_number_of_chunks(file_management_t* file_management, size_t file_size);
+static void store_transfer_state(file_management_t* file_management);
+static bool restore_transfer_state(file_management_t* file_management);
+static size_t packet_size_max(file_management_t* file_management);
+static void request_chunk(file_management_t* file_management, size_t index);
+static void request_window(file_management_t* file_management);
+static void restart_window(file_management_t* file_management);
+static void retry_window(file_management_t* file_management);
+static bool write_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size);
+static bool is_written_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size);
+static bool store_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size);
+static int find_stored_successor(file_management_t* file_management);
+static void clear_stored_packets(file_management_t* file_management);
+
+static bool is_checksum_matching(file_management_t* file_management, MD5_CTX* md5_ctx);
 static bool is_file_valid(file_management_t* file_management);
 
 static void listener_on_status(file_management_t* file_management, file_management_status_t status);
@@ -99,16 +118,33 @@ bool file_management_init(void* wolk_ctx, file_management_t* file_management, co
     file_management->state = STATE_IDLE;
     memset(file_management->previous_packet_hash, 0, WOLK_ARRAY_LENGTH(file_management->previous_packet_hash));
     memset(file_management->current_packet_hash, 0, WOLK_ARRAY_LENGTH(file_management->current_packet_hash));
+    memset(file_management->written_packet_hashes, 0, sizeof(file_management->written_packet_hashes));
     file_management->next_chunk_index = 0;
     file_management->expected_number_of_chunks = 0;
     file_management->retry_count = 0;
 
+    md5_init(&file_management->file_md5_ctx);
+    file_management->read_back_verification = false;
+
+    file_management->transfer_state_store = NULL;
+    file_management->transfer_state_read = NULL;
+    file_management->transfer_resume = NULL;
+
+    file_management->window_size = 1;
+    file_management->next_request_index = 0;
+    file_management->reassembly_storage = NULL;
+    file_management->reassembly_slots = 0;
+    clear_stored_packets(file_management);
+
     memset(file_management->file_name, '\0', WOLK_ARRAY_LENGTH(file_management->file_name));
     memset(file_management->file_hash, 0, WOLK_ARRAY_LENGTH(file_management->file_hash));
     file_management->file_size = 0;
 
     file_management->wolk_ctx = wolk_ctx;
 
+    /* Packets are validated with the fastest SHA-256 the CPU supports */
+    sha256_select_implementation();
+
     file_management->has_valid_configuration = true;
     if (device_key == NULL || maximum_file_size == 0 || chunk_size == 0 || start == NULL || write_chunk == NULL
         || read_chunk == NULL || abort == NULL || finalize == NULL || wolk_ctx == NULL) {
@@ -119,6 +155,52 @@ bool file_management_init(void* wolk_ctx, file_management_t* file_management, co
     return true;
 }
 
+bool file_management_set_window(file_management_t* file_management, size_t window_size, uint8_t* storage,
+                                size_t storage_size)
+{
+    /* Sanity check */
+    WOLK_ASSERT(file_management);
+
+    if (window_size == 0 || window_size > FILE_MANAGEMENT_WINDOW_MAX
+        || file_management->state == STATE_PACKET_FILE_TRANSFER) {
+        return false;
+    }
+
+    const size_t reassembly_slots = window_size - 1;
+    const size_t storage_slots = storage ? storage_size / packet_size_max(file_management) : 0;
+    if (storage_slots < reassembly_slots) {
+        return false;
+    }
+
+    file_management->window_size = window_size;
+    file_management->reassembly_storage = storage;
+    file_management->reassembly_slots = reassembly_slots;
+    clear_stored_packets(file_management);
+
+    return true;
+}
+
+void file_management_set_read_back_verification(file_management_t* file_management, bool enabled)
+{
+    /* Sanity check */
+    WOLK_ASSERT(file_management);
+
+    file_management->read_back_verification = enabled;
+}
+
+void file_management_set_transfer_state_persistence(file_management_t* file_management,
+                                                    file_management_transfer_state_store_t store,
+                                                    file_management_transfer_state_read_t read,
+                                                    file_management_transfer_resume_t resume)
+{
+    /* Sanity check */
+    WOLK_ASSERT(file_management);
+
+    file_management->transfer_state_store = store;
+    file_management->transfer_state_read = read;
+    file_management->transfer_resume = resume;
+}
+
 void file_management_handle_parameter(file_management_t* file_management,
                                       file_management_parameter_t* file_management_parameter)
 {
@@ -149,21 +231,8 @@ void file_management_handle_packet(file_management_t* file_management, uint8_t*
     }
 
     if (!file_management_packet_is_valid(packet, packet_size)) {
-        file_management->retry_count += 1;
-        if (file_management->retry_count >= MAX_RETRIES) {
-            update_abort(file_management);
-            listener_on_status(file_management,
-                               file_management_status_error(FILE_MANAGEMENT_ERROR_RETRY_COUNT_EXCEEDED));
-
-            reset_state(file_management);
-            return;
-        }
-
-        file_management_packet_request_t packet_request;
-        file_management_packet_request_init(&packet_request, file_management->file_name,
-                                            file_management->next_chunk_index,
-                                            file_management->chunk_size + (2 * FILE_MANAGEMENT_HASH_SIZE));
-        listener_on_packet_request(file_management, packet_request);
+        /* It is not known which of the outstanding chunks is corrupted, so all of them are requested again */
+        retry_window(file_management);
         return;
     }
 
@@ -171,33 +240,39 @@ void file_management_handle_packet(file_management_t* file_management, uint8_t*
                file_management_packet_get_previous_packet_hash(packet, packet_size),
                WOLK_ARRAY_LENGTH(file_management->previous_packet_hash))
         != 0) {
-        file_management_packet_request_t packet_request;
-        file_management_packet_request_init(&packet_request, file_management->file_name,
-                                            file_management->next_chunk_index,
-                                            file_management->chunk_size + (2 * FILE_MANAGEMENT_HASH_SIZE));
-        listener_on_packet_request(file_management, packet_request);
+        /* Late duplicate of chunk requested again after restart would never be written, and is not kept */
+        if (is_written_packet(file_management, packet, packet_size)) {
+            return;
+        }
+
+        /* Chunk ahead of the awaited one waits until it can be written in order */
+        if (!store_packet(file_management, packet, packet_size)) {
+            retry_window(file_management);
+        }
         return;
     }
 
-    memcpy(file_management->previous_packet_hash, file_management_packet_get_hash(packet, packet_size),
-           WOLK_ARRAY_LENGTH(file_management->previous_packet_hash));
+    bool written = write_packet(file_management, packet, packet_size);
 
-    if (!write_chunk(file_management, file_management_packet_get_data(packet, packet_size),
-                     file_management_packet_get_data_size(packet, packet_size))) {
+    /* Stored chunks which continue the hash chain */
+    int slot;
+    while (written && (slot = find_stored_successor(file_management)) != NO_REASSEMBLY_SLOT) {
+        uint8_t* stored_packet = file_management->reassembly_storage + (size_t)slot * packet_size_max(file_management);
+        written = write_packet(file_management, stored_packet, file_management->reassembly_packet_sizes[slot]);
+        file_management->reassembly_packet_sizes[slot] = 0;
+    }
+
+    if (!written) {
         listener_on_status(file_management, file_management_status_error(FILE_MANAGEMENT_ERROR_FILE_SYSTEM));
 
         reset_state(file_management);
         return;
     }
 
-    file_management->next_chunk_index += 1;
     /* Chunks are zero indexed */
     if (file_management->next_chunk_index < file_management->expected_number_of_chunks) {
-        file_management_packet_request_t packet_request;
-        file_management_packet_request_init(&packet_request, file_management->file_name,
-                                            file_management->next_chunk_index,
-                                            file_management->chunk_size + (2 * FILE_MANAGEMENT_HASH_SIZE));
-        listener_on_packet_request(file_management, packet_request);
+        store_transfer_state(file_management);
+        request_window(file_management);
         return;
     }
 
@@ -278,6 +353,32 @@ void file_management_process(file_management_t* file_management)
     check_url_download(file_management);
 }
 
+void file_management_resume(file_management_t* file_management)
+{
+    /* Sanity check */
+    WOLK_ASSERT(file_management);
+
+    if (!file_management->has_valid_configuration) {
+        return;
+    }
+
+    if (file_management->state == STATE_IDLE) {
+        if (!restore_transfer_state(file_management)) {
+            return;
+        }
+
+        listener_on_status(file_management, file_management_status_ok(FILE_MANAGEMENT_STATE_FILE_TRANSFER));
+    }
+
+    if (file_management->state != STATE_PACKET_FILE_TRANSFER) {
+        return;
+    }
+
+    /* Requests and chunks in flight are lost with the connection */
+    file_management->retry_count = 0;
+    restart_window(file_management);
+}
+
 void file_management_set_on_status_listener(file_management_t* file_management,
                                             file_management_on_status_listener on_status)
 {
@@ -365,17 +466,14 @@ static void handle_file_management(file_management_t* file_management, file_mana
         file_management->next_chunk_index = 0;
 
         file_management->expected_number_of_chunks =
-            (size_t)WOLK_CEIL((double)file_management_parameter_get_file_size(parameter)
-                              / (file_management->chunk_size - 2 * FILE_MANAGEMENT_HASH_SIZE));
+            expected_number_of_chunks(file_management, file_management_parameter_get_file_size(parameter));
         file_management->retry_count = 0;
+        md5_init(&file_management->file_md5_ctx);
 
         listener_on_status(file_management, file_management_status_ok(FILE_MANAGEMENT_STATE_FILE_TRANSFER));
 
-        file_management_packet_request_t packet_request;
-        file_management_packet_request_init(&packet_request, file_management->file_name,
-                                            file_management->next_chunk_index,
-                                            file_management->chunk_size + (2 * FILE_MANAGEMENT_HASH_SIZE));
-        listener_on_packet_request(file_management, packet_request);
+        store_transfer_state(file_management);
+        restart_window(file_management);
 
         break;
 
@@ -622,25 +720,263 @@ static void reset_state(file_management_t* file_management)
     /* Sanity check */
     WOLK_ASSERT(file_management);
 
+    if (file_management->state != STATE_IDLE && file_management->transfer_state_store != NULL) {
+        file_management->transfer_state_store(NULL);
+    }
+
     file_management->state = STATE_IDLE;
     memset(file_management->previous_packet_hash, 0, WOLK_ARRAY_LENGTH(file_management->previous_packet_hash));
     memset(file_management->current_packet_hash, 0, WOLK_ARRAY_LENGTH(file_management->current_packet_hash));
     file_management->next_chunk_index = 0;
     file_management->expected_number_of_chunks = 0;
+    file_management->next_request_index = 0;
+    clear_stored_packets(file_management);
+    memset(file_management->written_packet_hashes, 0, sizeof(file_management->written_packet_hashes));
 
     memset(file_management->file_name, '\0', WOLK_ARRAY_LENGTH(file_management->file_name));
     memset(file_management->file_hash, 0, WOLK_ARRAY_LENGTH(file_management->file_hash));
     file_management->file_size = 0;
 }
 
+static size_t chunk_data_size(file_management_t* file_management)
+{
+    return file_management->chunk_size - 2 * FILE_MANAGEMENT_HASH_SIZE;
+}
+
+static size_t expected_number_of_chunks(file_management_t* file_management, size_t file_size)
+{
+    return (size_t)WOLK_CEIL((double)file_size / chunk_data_size(file_management));
+}
+
+static void store_transfer_state(file_management_t* file_management)
+{
+    if (file_management->transfer_state_store == NULL) {
+        return;
+    }
+
+    file_management_transfer_state_t state;
+    memset(&state, 0, sizeof(state));
+    strcpy(state.file_name, file_management->file_name);
+    state.file_size = file_management->file_size;
+    memcpy(state.file_hash, file_management->file_hash, sizeof(state.file_hash));
+    state.next_chunk_index = file_management->next_chunk_index;
+    memcpy(state.previous_packet_hash, file_management->previous_packet_hash, sizeof(state.previous_packet_hash));
+    state.file_md5_ctx = file_management->file_md5_ctx;
+
+    file_management->transfer_state_store(&state);
+}
+
+static bool restore_transfer_state(file_management_t* file_management)
+{
+    file_management_transfer_state_t state;
+    if (file_management->transfer_state_read == NULL || file_management->transfer_resume == NULL
+        || !file_management->transfer_state_read(&state)) {
+        return false;
+    }
+
+    const size_t number_of_chunks = expected_number_of_chunks(file_management, state.file_size);
+    if (state.file_size == 0 || state.file_size > file_management->maximum_file_size
+        || state.next_chunk_index >= number_of_chunks
+        || memchr(state.file_name, '\0', sizeof(state.file_name)) == NULL
+        /* Chunk written after progress was stored is discarded, as it is requested again */
+        || !file_management->transfer_resume(state.file_name,
+                                             state.next_chunk_index * chunk_data_size(file_management))) {
+        /* Stored progress does not belong to this configuration */
+        if (file_management->transfer_state_store != NULL) {
+            file_management->transfer_state_store(NULL);
+        }
+        return false;
+    }
+
+    strcpy(file_management->file_name, state.file_name);
+    file_management->file_size = state.file_size;
+    memcpy(file_management->file_hash, state.file_hash, sizeof(file_management->file_hash));
+    file_management->next_chunk_index = state.next_chunk_index;
+    memcpy(file_management->previous_packet_hash, state.previous_packet_hash,
+           sizeof(file_management->previous_packet_hash));
+    file_management->file_md5_ctx = state.file_md5_ctx;
+
+    file_management->expected_number_of_chunks = number_of_chunks;
+    file_management->state = STATE_PACKET_FILE_TRANSFER;
+    return true;
+}
+
+static size_t packet_size_max(file_management_t* file_management)
+{
+    /* Requested packet size, which reassembly slots have to hold as well */
+    return file_management->chunk_size + 2 * FILE_MANAGEMENT_HASH_SIZE;
+}
+
+static void request_chunk(file_management_t* file_management, size_t index)
+{
+    file_management_packet_request_t packet_request;
+    file_management_packet_request_init(&packet_request, file_management->file_name, index,
+                                        packet_size_max(file_management));
+    listener_on_packet_request(file_management, packet_request);
+}
+
+static void request_window(file_management_t* file_management)
+{
+    while (file_management->next_request_index < file_management->expected_number_of_chunks
+           && file_management->next_request_index - file_management->next_chunk_index < file_management->window_size) {
+        request_chunk(file_management, file_management->next_request_index);
+        file_management->next_request_index += 1;
+    }
+}
+
+static void restart_window(file_management_t* file_management)
+{
+    clear_stored_packets(file_management);
+
+    file_management->next_request_index = file_management->next_chunk_index;
+    request_window(file_management);
+}
+
+static void retry_window(file_management_t* file_management)
+{
+    file_management->retry_count += 1;
+    if (file_management->retry_count >= MAX_RETRIES) {
+        update_abort(file_management);
+        listener_on_status(file_management, file_management_status_error(FILE_MANAGEMENT_ERROR_RETRY_COUNT_EXCEEDED));
+
+        reset_state(file_management);
+        return;
+    }
+
+    restart_window(file_management);
+}
+
+static bool write_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size)
+{
+    memcpy(file_management->previous_packet_hash, file_management_packet_get_hash(packet, packet_size),
+           WOLK_ARRAY_LENGTH(file_management->previous_packet_hash));
+    memcpy(file_management->written_packet_hashes[file_management->next_chunk_index % FILE_MANAGEMENT_WINDOW_MAX],
+           file_management->previous_packet_hash, FILE_MANAGEMENT_HASH_SIZE);
+
+    uint8_t* data = file_management_packet_get_data(packet, packet_size);
+    const size_t data_size = file_management_packet_get_data_size(packet, packet_size);
+    if (!write_chunk(file_management, data, data_size)) {
+        return false;
+    }
+
+    md5_update(&file_management->file_md5_ctx, data, data_size);
+
+    file_management->next_chunk_index += 1;
+    return true;
+}
+
+static bool is_written_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size)
+{
+    /* Previous hash of the first chunk */
+    static const uint8_t no_packet_hash[FILE_MANAGEMENT_HASH_SIZE] = {0};
+
+    const uint8_t* previous_packet_hash = file_management_packet_get_previous_packet_hash(packet, packet_size);
+    const uint8_t* packet_hash = file_management_packet_get_hash(packet, packet_size);
+
+    /* Oldest remembered chunk is skipped, as hash of the chunk before it is overwritten */
+    const size_t next_chunk_index = file_management->next_chunk_index;
+    const size_t oldest =
+        next_chunk_index > FILE_MANAGEMENT_WINDOW_MAX ? next_chunk_index - FILE_MANAGEMENT_WINDOW_MAX + 1 : 0;
+    for (size_t i = oldest; i < next_chunk_index; ++i) {
+        const uint8_t* written_previous_hash =
+            i == 0 ? no_packet_hash : file_management->written_packet_hashes[(i - 1) % FILE_MANAGEMENT_WINDOW_MAX];
+        if (memcmp(written_previous_hash, previous_packet_hash, FILE_MANAGEMENT_HASH_SIZE) == 0
+            && memcmp(file_management->written_packet_hashes[i % FILE_MANAGEMENT_WINDOW_MAX], packet_hash,
+                      FILE_MANAGEMENT_HASH_SIZE)
+                   == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool store_packet(file_management_t* file_management, uint8_t* packet, size_t packet_size)
+{
+    const size_t slot_size = packet_size_max(file_management);
+    if (packet_size > slot_size) {
+        return false;
+    }
+
+    int free_slot = NO_REASSEMBLY_SLOT;
+    for (size_t i = 0; i < file_management->reassembly_slots; ++i) {
+        const uint8_t* stored_packet = file_management->reassembly_storage + i * slot_size;
+        const size_t stored_packet_size = file_management->reassembly_packet_sizes[i];
+
+        if (stored_packet_size == 0) {
+            free_slot = free_slot == NO_REASSEMBLY_SLOT ? (int)i : free_slot;
+        } else if (stored_packet_size == packet_size
+                   && memcmp(stored_packet + packet_size - FILE_MANAGEMENT_HASH_SIZE,
+                             file_management_packet_get_hash(packet, packet_size), FILE_MANAGEMENT_HASH_SIZE)
+                          == 0) {
+            /* Duplicate of requested again chunk */
+            return true;
+        }
+    }
+
+    if (free_slot == NO_REASSEMBLY_SLOT) {
+        return false;
+    }
+
+    memcpy(file_management->reassembly_storage + (size_t)free_slot * slot_size, packet, packet_size);
+    file_management->reassembly_packet_sizes[free_slot] = packet_size;
+    return true;
+}
+
+static int find_stored_successor(file_management_t* file_management)
+{
+    const size_t slot_size = packet_size_max(file_management);
+
+    for (size_t i = 0; i < file_management->reassembly_slots; ++i) {
+        const size_t stored_packet_size = file_management->reassembly_packet_sizes[i];
+        if (stored_packet_size == 0) {
+            continue;
+        }
+
+        uint8_t* stored_packet = file_management->reassembly_storage + i * slot_size;
+        if (memcmp(file_management_packet_get_previous_packet_hash(stored_packet, stored_packet_size),
+                   file_management->previous_packet_hash, FILE_MANAGEMENT_HASH_SIZE)
+            == 0) {
+            return (int)i;
+        }
+    }
+
+    return NO_REASSEMBLY_SLOT;
+}
+
+static void clear_stored_packets(file_management_t* file_management)
+{
+    memset(file_management->reassembly_packet_sizes, 0, sizeof(file_management->reassembly_packet_sizes));
+}
+
+static bool is_checksum_matching(file_management_t* file_management, MD5_CTX* md5_ctx)
+{
+    uint8_t calculated_file_hash[FILE_MANAGEMENT_HASH_SIZE] = {0};
+    char calculated_file_checksum[FILE_MANAGEMENT_HASH_SIZE + 1] = {0};
+    md5_final(md5_ctx, calculated_file_hash);
+
+    // hash to checksum, two hex characters per MD5 digest byte
+    for (int i = 0; i < FILE_MANAGEMENT_HASH_SIZE / 2; ++i) {
+        sprintf(&calculated_file_checksum[i * 2], "%02x", (unsigned int)calculated_file_hash[i]);
+    }
+
+    return memcmp(calculated_file_checksum, file_management->file_hash, FILE_MANAGEMENT_HASH_SIZE) == 0;
+}
+
 static bool is_file_valid(file_management_t* file_management)
 {
     /* Sanity check */
     WOLK_ASSERT(file_management);
 
+    if (!is_checksum_matching(file_management, &file_management->file_md5_ctx)) {
+        return false;
+    }
+
+    if (!file_management->read_back_verification) {
+        return true;
+    }
+
     uint8_t read_data[FILE_MANAGEMENT_VERIFICATION_CHUNK_SIZE] = {0};
-    uint8_t calculated_file_hash[FILE_MANAGEMENT_HASH_SIZE] = {0};
-    uint8_t calculated_file_checksum[FILE_MANAGEMENT_HASH_SIZE] = {0};
     MD5_CTX md5_ctx;
     md5_init(&md5_ctx);
 
@@ -648,15 +984,8 @@ static bool is_file_valid(file_management_t* file_management)
         const size_t read_data_size = read_chunk(file_management, i, read_data, WOLK_ARRAY_LENGTH(read_data));
         md5_update(&md5_ctx, read_data, read_data_size);
     }
-    md5_final(&md5_ctx, calculated_file_hash);
-
-    // hash to checksum
-    for (int i = 0; i < FILE_MANAGEMENT_HASH_SIZE; ++i) {
-        sprintf(&calculated_file_checksum[i * 2], "%02x", (unsigned int)calculated_file_hash[i]);
-    }
 
-    return memcmp(calculated_file_checksum, file_management->file_hash, WOLK_ARRAY_LENGTH(calculated_file_checksum))
-           == 0;
+    return is_checksum_matching(file_management, &md5_ctx);
 }
 
 static void listener_on_status(file_management_t* file_management, file_management_status_t status)
@@ -25,6 +25,7 @@ extern "C" {
 #include "model/file_management/file_management_packet_request.h"
 #include "model/file_management/file_management_status.h"
 #include "size_definitions.h"
+#include "utility/md5.h"
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -120,6 +121,45 @@ typedef bool (*file_management_remove_file_t)(const char* file_name);
  */
 typedef bool (*file_management_purge_files_t)(void);
 
+/**
+ * @brief Progress of packet file transfer, which is enough to resume it from the last written chunk.
+ * Contents are opaque to the application and should be stored as they are.
+ */
+typedef struct {
+    char file_name[FILE_MANAGEMENT_FILE_NAME_SIZE];
+    size_t file_size;
+    uint8_t file_hash[FILE_MANAGEMENT_HASH_SIZE];
+
+    size_t next_chunk_index;
+    uint8_t previous_packet_hash[FILE_MANAGEMENT_HASH_SIZE];
+    MD5_CTX file_md5_ctx;
+} file_management_transfer_state_t;
+
+/**
+ * @brief file_management_transfer_state_store signature.
+ * Stores transfer progress to non-volatile memory, replacing previously stored one.
+ * 'state' is NULL once transfer ends, when stored progress should be discarded.
+ */
+typedef void (*file_management_transfer_state_store_t)(const file_management_transfer_state_t* state);
+
+/**
+ * @brief file_management_transfer_state_read signature.
+ * Reads transfer progress stored via 'file_management_transfer_state_store'.
+ *
+ * @return true if progress of an unfinished transfer is read into 'state', false otherwise
+ */
+typedef bool (*file_management_transfer_state_read_t)(file_management_transfer_state_t* state);
+
+/**
+ * @brief file_management_transfer_resume signature.
+ * Truncates file named 'file_name' to 'offset' bytes, before transfer restored from stored progress continues
+ * appending to it. Chunk written just before restart, whose progress was not stored, is discarded this way instead
+ * of being appended twice.
+ *
+ * @return true if file is truncated to 'offset', false if transfer can not be resumed
+ */
+typedef bool (*file_management_transfer_resume_t)(const char* file_name, size_t offset);
+
 typedef struct file_management file_management_t;
 
 typedef void (*file_management_on_status_listener)(file_management_t* file_management, file_management_status_t status);
@@ -158,6 +198,23 @@ struct file_management {
     size_t expected_number_of_chunks;
     uint32_t retry_count;
 
+    /* Whole file hash, updated as chunks are written */
+    MD5_CTX file_md5_ctx;
+    bool read_back_verification;
+
+    file_management_transfer_state_store_t transfer_state_store;
+    file_management_transfer_state_read_t transfer_state_read;
+    file_management_transfer_resume_t transfer_resume;
+
+    /* Pipelined transfer, see file_management_set_window */
+    size_t window_size;
+    size_t next_request_index;
+    uint8_t* reassembly_storage;
+    size_t reassembly_slots;
+    size_t reassembly_packet_sizes[FILE_MANAGEMENT_WINDOW_MAX];
+    /* Hashes of the last written chunks, indexed by chunk index modulo FILE_MANAGEMENT_WINDOW_MAX */
+    uint8_t written_packet_hashes[FILE_MANAGEMENT_WINDOW_MAX][FILE_MANAGEMENT_HASH_SIZE];
+
     /* File Management request parameters */
     char file_name[FILE_MANAGEMENT_FILE_NAME_SIZE];
     uint8_t file_hash[FILE_MANAGEMENT_HASH_SIZE];
@@ -189,6 +246,37 @@ bool file_management_init(void* wolk_ctx, file_management_t* file_management, co
                           file_management_get_file_list_t get_file_list, file_management_remove_file_t remove_file,
                           file_management_purge_files_t purge_files);
 
+/**
+ * Keeps up to 'window_size' chunk requests outstanding, instead of requesting the next chunk once the previous one is
+ * written. Chunks which arrive ahead of the awaited one are kept in 'storage' until they can be written in order.
+ *
+ * Transfer packets carry no chunk index, so their order is recovered from the previous packet hash they carry.
+ * 'storage' has to hold 'window_size' - 1 packets of up to 'chunk_size' + 2 * FILE_MANAGEMENT_HASH_SIZE bytes, which is
+ * the packet size requested from the platform.
+ * Window of size 1, which needs no storage, is the default.
+ *
+ * @return false if window is out of range, storage is too small, or transfer is in progress
+ */
+bool file_management_set_window(file_management_t* file_management, size_t window_size, uint8_t* storage,
+                                size_t storage_size);
+
+/**
+ * Whole file hash is calculated from chunks as they are written. With read back verification enabled, file is
+ * additionally read back through 'read_chunk' and hashed again once transfer completes, which catches storage
+ * corruption at the cost of reading whole file. Disabled by default.
+ */
+void file_management_set_read_back_verification(file_management_t* file_management, bool enabled);
+
+/**
+ * Persists transfer progress after every written chunk, so that file_management_resume can continue transfer
+ * interrupted by device restart. All callbacks are optional, and NULL disables persistence. Transfer is restored
+ * only when 'resume' is set, as file has to be truncated to the stored progress first.
+ */
+void file_management_set_transfer_state_persistence(file_management_t* file_management,
+                                                    file_management_transfer_state_store_t store,
+                                                    file_management_transfer_state_read_t read,
+                                                    file_management_transfer_resume_t resume);
+
 void file_management_handle_parameter(file_management_t* file_management,
                                       file_management_parameter_t* file_management_parameter);
 
@@ -204,6 +292,16 @@ void file_management_handle_file_purge(file_management_t* file_management);
 
 void file_management_process(file_management_t* file_management);
 
+/**
+ * Resumes packet file transfer after (re)connect by requesting chunks again, starting from the last written one.
+ * Transfer which is not in progress is restored from persisted progress, if there is one. Chunks written before
+ * restart have to remain in place, as 'write_chunk' continues appending to them without another 'start' call.
+ * Progress is stored after chunk is written, so file may hold one more chunk than stored progress accounts for.
+ * 'resume' is therefore given the offset of the next chunk, 'next_chunk_index' times chunk data size
+ * ('chunk_size' - 2 * FILE_MANAGEMENT_HASH_SIZE), and file has to be truncated to it before transfer continues.
+ */
+void file_management_resume(file_management_t* file_management);
+
 void file_management_set_on_status_listener(file_management_t* file_management,
                                             file_management_on_status_listener on_status);
 void file_management_set_on_packet_request_listener(file_management_t* file_management,
@@ -38,3 +38,27 @@ char* outbound_message_get_payload(outbound_message_t* outbound_message)
 {
     return outbound_message->payload;
 }
+
+void outbound_message_get_view(outbound_message_t* outbound_message, outbound_message_view_t* view)
+{
+    view->topic = outbound_message->topic;
+    view->topic_length = (uint16_t)strlen(outbound_message->topic);
+
+    view->payload = outbound_message->payload;
+    view->payload_length = (uint32_t)strlen(outbound_message->payload);
+}
+
+int outbound_topics_find(const outbound_topics_t* topics, const char* topic, uint16_t topic_length)
+{
+    if (!topics) {
+        return OUTBOUND_TOPIC_ID_NONE;
+    }
+
+    for (uint16_t i = 0; i < topics->number_of_topics; ++i) {
+        if (topics->topic_lengths[i] == topic_length && memcmp(topics->topics[i], topic, topic_length) == 0) {
+            return i;
+        }
+    }
+
+    return OUTBOUND_TOPIC_ID_NONE;
+}
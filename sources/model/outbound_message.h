@@ -19,6 +19,8 @@
 
 #include "size_definitions.h"
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -28,12 +30,44 @@ typedef struct {
     char payload[PAYLOAD_SIZE];
 } outbound_message_t;
 
+/**
+ * Borrowed view of outbound message, pointing directly into persistence storage.
+ * Topic and payload are not required to be NULL terminated.
+ */
+typedef struct {
+    char* topic;
+    uint16_t topic_length;
+
+    char* payload;
+    uint32_t payload_length;
+} outbound_message_view_t;
+
+/**
+ * Full outbound topics of device, which persisted messages may refer to by ID instead of storing the topic.
+ * ID of topic is its index.
+ */
+typedef struct {
+    char topics[OUTBOUND_TOPICS_MAX][TOPIC_SIZE];
+    uint16_t topic_lengths[OUTBOUND_TOPICS_MAX];
+    uint16_t number_of_topics;
+} outbound_topics_t;
+
+enum { OUTBOUND_TOPIC_ID_NONE = -1 };
+
 void outbound_message_init(outbound_message_t* outbound_message, const char* topic, const char* payload);
 
 char* outbound_message_get_topic(outbound_message_t* outbound_message);
 
 char* outbound_message_get_payload(outbound_message_t* outbound_message);
 
+void outbound_message_get_view(outbound_message_t* outbound_message, outbound_message_view_t* view);
+
+/**
+ * Returns ID of 'topic' which is not NULL terminated, or OUTBOUND_TOPIC_ID_NONE if it is not one of 'topics'.
+ * 'topics' may be NULL.
+ */
+int outbound_topics_find(const outbound_topics_t* topics, const char* topic, uint16_t topic_length);
+
 #ifdef __cplusplus
 }
 #endif
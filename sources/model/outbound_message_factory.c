@@ -16,50 +16,134 @@
 
 #include "outbound_message_factory.h"
 
+/* Serializes as many of the leading items as fit into the message, returns their number */
+static size_t serialize_fitting(parser_t* parser, outbound_message_serialize_items_t serialize, void* items,
+                                size_t number_of_items, outbound_message_t* outbound_message)
+{
+    if (serialize(parser, items, number_of_items, outbound_message)) {
+        return number_of_items;
+    }
+
+    /* Binary search, 'low' items fit and 'high' items do not */
+    size_t low = 0;
+    size_t high = number_of_items;
+    bool holds_low = false;
+    while (high - low > 1) {
+        const size_t middle = low + (high - low) / 2;
+
+        holds_low = serialize(parser, items, middle, outbound_message);
+        if (holds_low) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low > 0 && !holds_low) {
+        serialize(parser, items, low, outbound_message);
+    }
+
+    return low;
+}
 
-size_t outbound_message_make_from_feeds(parser_t* parser, const char* device_key, feed_t* readings, data_type_t type,
-                                        size_t readings_number, size_t reading_element_size,
-                                        outbound_message_t* outbound_message)
+bool outbound_message_split(parser_t* parser, outbound_message_serialize_items_t serialize, void* items,
+                            size_t item_size, size_t number_of_items, outbound_message_consumer_t consume,
+                            void* context)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(serialize);
+    WOLK_ASSERT(consume);
+
+    uint8_t* item = (uint8_t*)items;
+    outbound_message_t outbound_message;
+
+    while (number_of_items > 0) {
+        const size_t number_of_serialized_items =
+            serialize_fitting(parser, serialize, item, number_of_items, &outbound_message);
+        if (number_of_serialized_items == 0 || !consume(context, &outbound_message)) {
+            return false;
+        }
+
+        item += number_of_serialized_items * item_size;
+        number_of_items -= number_of_serialized_items;
+    }
+
+    return true;
+}
+
+size_t outbound_message_make_from_feeds(parser_t* parser, feed_t* readings, data_type_t type, size_t readings_number,
+                                        size_t reading_element_size, outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(readings);
     WOLK_ASSERT(readings_number);
     WOLK_ASSERT(reading_element_size);
     WOLK_ASSERT(outbound_message);
 
-    char topic[TOPIC_SIZE] = "";
-    char payload[PAYLOAD_SIZE] = "";
-    size_t num_serialized = 0;
+    /* Serialized straight into the message */
+    parser_get_topic(parser, PARSER_TOPIC_FEED_VALUES, outbound_message->topic);
+
+    return parser_serialize_feeds(parser, readings, type, readings_number, reading_element_size,
+                                  outbound_message->payload, sizeof(outbound_message->payload));
+}
+
+bool outbound_message_make_from_typed_feeds(parser_t* parser, const typed_feed_t* feeds, size_t number_of_feeds,
+                                            outbound_message_t* outbound_message)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(feeds);
+    WOLK_ASSERT(number_of_feeds);
+    WOLK_ASSERT(outbound_message);
+
+    parser_get_topic(parser, PARSER_TOPIC_FEED_VALUES, outbound_message->topic);
+
+    return parser_serialize_typed_feeds(parser, feeds, number_of_feeds, outbound_message->payload,
+                                        sizeof(outbound_message->payload));
+}
+
+void outbound_message_begin_typed_feeds(parser_t* parser, outbound_message_t* outbound_message, size_t* length)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(outbound_message);
+    WOLK_ASSERT(length);
 
-    parser->create_topic(parser->D2P_TOPIC, device_key, parser->FEED_VALUES_MESSAGE_TOPIC, topic);
+    parser_get_topic(parser, PARSER_TOPIC_FEED_VALUES, outbound_message->topic);
+    outbound_message->payload[0] = '\0';
+    *length = 0;
+}
 
-    num_serialized =
-        parser_serialize_feeds(parser, readings, type, readings_number, reading_element_size, payload, sizeof(payload));
-    if (num_serialized != 0)
-        outbound_message_init(outbound_message, topic, payload);
+bool outbound_message_append_typed_feed(parser_t* parser, const typed_feed_t* feed,
+                                        outbound_message_t* outbound_message, size_t* length)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(feed);
+    WOLK_ASSERT(outbound_message);
 
-    return num_serialized;
+    return parser_append_typed_feed(parser, feed, outbound_message->payload, sizeof(outbound_message->payload),
+                                    length);
 }
 
-bool outbound_message_make_from_file_management_status(parser_t* parser, const char* device_key,
+bool outbound_message_make_from_file_management_status(parser_t* parser,
                                                        file_management_packet_request_t* file_management_packet_request,
                                                        file_management_status_t* file_management_status,
                                                        outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_management_status);
     WOLK_ASSERT(outbound_message);
 
-    return parser_serialize_file_management_status(parser, device_key, file_management_packet_request,
-                                                   file_management_status, outbound_message);
+    return parser_serialize_file_management_status(parser, file_management_packet_request, file_management_status,
+                                                   outbound_message);
 }
 
 bool outbound_message_make_from_file_management_packet_request(
-    parser_t* parser, const char* device_key, file_management_packet_request_t* file_management_packet_request,
+    parser_t* parser, file_management_packet_request_t* file_management_packet_request,
     outbound_message_t* outbound_message)
 {
     /* Sanity check */
@@ -67,120 +151,103 @@ bool outbound_message_make_from_file_management_packet_request(
     WOLK_ASSERT(file_management_packet_request);
     WOLK_ASSERT(outbound_message);
 
-    return parser_serialize_file_management_packet_request(parser, device_key, file_management_packet_request,
-                                                           outbound_message);
+    return parser_serialize_file_management_packet_request(parser, file_management_packet_request, outbound_message);
 }
 
 bool outbound_message_make_from_file_management_url_download_status(
-    parser_t* parser, const char* device_key, file_management_parameter_t* file_management_parameter,
-    file_management_status_t* status, outbound_message_t* outbound_message)
+    parser_t* parser, file_management_parameter_t* file_management_parameter, file_management_status_t* status,
+    outbound_message_t* outbound_message)
 {
     /* Sanity check*/
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_management_parameter);
     WOLK_ASSERT(status);
     WOLK_ASSERT(outbound_message);
 
-    return parser_serialize_file_management_url_download(parser, device_key, file_management_parameter, status,
-                                                         outbound_message);
+    return parser_serialize_file_management_url_download(parser, file_management_parameter, status, outbound_message);
 }
 
-bool outbound_message_make_from_file_management_file_list(parser_t* parser, const char* device_key,
-                                                          file_list_t* file_list, size_t file_list_items,
-                                                          outbound_message_t* outbound_message)
+bool outbound_message_make_from_file_management_file_list(parser_t* parser, file_list_t* file_list,
+                                                          size_t file_list_items, outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_list);
     WOLK_ASSERT(outbound_message);
 
-    return parser_serialize_file_management_file_list(parser, device_key, file_list, file_list_items, outbound_message);
+    return parser_serialize_file_management_file_list(parser, file_list, file_list_items, outbound_message);
 }
 
-bool outbound_message_make_from_firmware_update_status(parser_t* parser, const char* device_key,
-                                                       firmware_update_t* firmware_update,
+bool outbound_message_make_from_firmware_update_status(parser_t* parser, firmware_update_t* firmware_update,
                                                        outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(firmware_update);
     WOLK_ASSERT(outbound_message);
 
-    return parse_serialize_firmware_update_status(parser, device_key, firmware_update, outbound_message);
+    return parse_serialize_firmware_update_status(parser, firmware_update, outbound_message);
 }
 
-bool outbound_message_feed_registration(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                        size_t number_of_feeds, outbound_message_t* outbound_message)
+bool outbound_message_feed_registration(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                        outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(feed);
     WOLK_ASSERT(outbound_message);
-    return parser_serialize_feed_registration(parser, device_key, feed, number_of_feeds, outbound_message);
+    return parser_serialize_feed_registration(parser, feed, number_of_feeds, outbound_message);
 }
-bool outbound_message_feed_removal(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                   size_t number_of_feeds, outbound_message_t* outbound_message)
+bool outbound_message_feed_removal(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                   outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(feed);
     WOLK_ASSERT(outbound_message);
-    return parser_serialize_feed_removal(parser, device_key, feed, number_of_feeds, outbound_message);
+    return parser_serialize_feed_removal(parser, feed, number_of_feeds, outbound_message);
 }
 
-bool outbound_message_pull_feed_values(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool outbound_message_pull_feed_values(parser_t* parser, outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
 
-    return parser_serialize_pull_feed_values(parser, device_key, outbound_message);
+    return parser_serialize_pull_feed_values(parser, outbound_message);
 }
-bool outbound_message_attribute_registration(parser_t* parser, const char* device_key, attribute_t* attributes,
-                                             size_t number_of_attributes, outbound_message_t* outbound_message)
+bool outbound_message_attribute_registration(parser_t* parser, attribute_t* attributes, size_t number_of_attributes,
+                                             outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
 
-    return parser_serialize_attribute(parser, device_key, attributes, number_of_attributes, outbound_message);
+    return parser_serialize_attribute(parser, attributes, number_of_attributes, outbound_message);
 }
-bool outbound_message_update_parameters(parser_t* parser, const char* device_key, parameter_t* parameter,
-                                        size_t number_of_parameters, outbound_message_t* outbound_message)
+bool outbound_message_update_parameters(parser_t* parser, parameter_t* parameter, size_t number_of_parameters,
+                                        outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
 
-    return parser_serialize_parameter(parser, device_key, parameter, number_of_parameters, outbound_message);
+    return parser_serialize_parameter(parser, parameter, number_of_parameters, outbound_message);
 }
-bool outbound_message_pull_parameters(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool outbound_message_pull_parameters(parser_t* parser, outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
-    return parser_serialize_pull_parameters(parser, device_key, outbound_message);
+    return parser_serialize_pull_parameters(parser, outbound_message);
 }
-bool outbound_message_synchronize_parameters(parser_t* parser, const char* device_key, parameter_t* parameters,
-                                             size_t number_of_parameters, outbound_message_t* outbound_message)
+bool outbound_message_synchronize_parameters(parser_t* parser, parameter_t* parameters, size_t number_of_parameters,
+                                             outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
-    return parser_serialize_sync_parameters(parser, device_key, parameters, number_of_parameters, outbound_message);
+    return parser_serialize_sync_parameters(parser, parameters, number_of_parameters, outbound_message);
 }
-bool outbound_message_synchronize_time(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool outbound_message_synchronize_time(parser_t* parser, outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
-    return parser_serialize_sync_time(parser, device_key, outbound_message);
+    return parser_serialize_sync_time(parser, outbound_message);
 }
 
-bool outbound_message_details_synchronize(parser_t* parser, const char* device_key,
-                                          outbound_message_t* outbound_message)
+bool outbound_message_details_synchronize(parser_t* parser, outbound_message_t* outbound_message)
 {
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
 
-    return parser_serialize_details_synchronization(parser, device_key, outbound_message);
+    return parser_serialize_details_synchronization(parser, outbound_message);
 }
\ No newline at end of file
@@ -32,53 +32,85 @@
 extern "C" {
 #endif
 
-bool outbound_message_make_from_file_management_status(parser_t* parser, const char* device_key,
+bool outbound_message_make_from_file_management_status(parser_t* parser,
                                                        file_management_packet_request_t* file_management_packet_request,
                                                        file_management_status_t* file_management_status,
                                                        outbound_message_t* outbound_message);
 
 bool outbound_message_make_from_file_management_url_download_status(
-    parser_t* parser, const char* device_key, file_management_parameter_t* file_management_parameter,
-    file_management_status_t* status, outbound_message_t* outbound_message);
+    parser_t* parser, file_management_parameter_t* file_management_parameter, file_management_status_t* status,
+    outbound_message_t* outbound_message);
 
 bool outbound_message_make_from_file_management_packet_request(
-    parser_t* parser, const char* device_key, file_management_packet_request_t* file_management_packet_request,
+    parser_t* parser, file_management_packet_request_t* file_management_packet_request,
     outbound_message_t* outbound_message);
 
-bool outbound_message_make_from_file_management_file_list(parser_t* parser, const char* device_key,
-                                                          file_list_t* file_list, size_t file_list_items,
-                                                          outbound_message_t* outbound_message);
+bool outbound_message_make_from_file_management_file_list(parser_t* parser, file_list_t* file_list,
+                                                          size_t file_list_items, outbound_message_t* outbound_message);
 
-bool outbound_message_make_from_firmware_update_status(parser_t* parser, const char* device_key,
-                                                       firmware_update_t* firmware_update,
+bool outbound_message_make_from_firmware_update_status(parser_t* parser, firmware_update_t* firmware_update,
                                                        outbound_message_t* outbound_message);
 
-bool outbound_message_feed_registration(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                        size_t number_of_feeds, outbound_message_t* outbound_message);
+bool outbound_message_feed_registration(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                        outbound_message_t* outbound_message);
 
-bool outbound_message_feed_removal(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                   size_t number_of_feeds, outbound_message_t* outbound_message);
+bool outbound_message_feed_removal(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                   outbound_message_t* outbound_message);
 
-size_t outbound_message_make_from_feeds(parser_t* parser, const char* device_key, feed_t* readings, data_type_t type,
-                                        size_t readings_number, size_t reading_element_size,
-                                        outbound_message_t* outbound_message);
+/**
+ * Serializes 'number_of_items' items into message, returns false if they do not fit.
+ */
+typedef bool (*outbound_message_serialize_items_t)(parser_t* parser, void* items, size_t number_of_items,
+                                                   outbound_message_t* outbound_message);
+
+/**
+ * Takes message made by outbound_message_split(), returns false to stop splitting.
+ */
+typedef bool (*outbound_message_consumer_t)(void* context, outbound_message_t* outbound_message);
+
+/**
+ * Serializes array of 'number_of_items' items of 'item_size' bytes into as many messages as needed, each holding as
+ * many items as fit into the payload, and passes every message to 'consume'.
+ *
+ * Returns false if a single item does not fit into the payload or consumer fails; messages made before are consumed.
+ */
+bool outbound_message_split(parser_t* parser, outbound_message_serialize_items_t serialize, void* items,
+                            size_t item_size, size_t number_of_items, outbound_message_consumer_t consume,
+                            void* context);
+
+size_t outbound_message_make_from_feeds(parser_t* parser, feed_t* readings, data_type_t type, size_t readings_number,
+                                        size_t reading_element_size, outbound_message_t* outbound_message);
+
+bool outbound_message_make_from_typed_feeds(parser_t* parser, const typed_feed_t* feeds, size_t number_of_feeds,
+                                            outbound_message_t* outbound_message);
+
+/**
+ * Starts empty feed values message, feeds are added to it with outbound_message_append_typed_feed().
+ */
+void outbound_message_begin_typed_feeds(parser_t* parser, outbound_message_t* outbound_message, size_t* length);
+
+/**
+ * Appends feed to the message started by outbound_message_begin_typed_feeds(), 'length' is the length of payload
+ * serialized so far. Returns false and leaves message unchanged if feed does not fit.
+ */
+bool outbound_message_append_typed_feed(parser_t* parser, const typed_feed_t* feed,
+                                        outbound_message_t* outbound_message, size_t* length);
 
-bool outbound_message_pull_feed_values(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
+bool outbound_message_pull_feed_values(parser_t* parser, outbound_message_t* outbound_message);
 
-bool outbound_message_attribute_registration(parser_t* parser, const char* device_key, attribute_t* attributes,
-                                             size_t number_of_attributes, outbound_message_t* outbound_message);
+bool outbound_message_attribute_registration(parser_t* parser, attribute_t* attributes, size_t number_of_attributes,
+                                             outbound_message_t* outbound_message);
 
-bool outbound_message_update_parameters(parser_t* parser, const char* device_key, parameter_t* parameter,
-                                        size_t number_of_parameters, outbound_message_t* outbound_message);
+bool outbound_message_update_parameters(parser_t* parser, parameter_t* parameter, size_t number_of_parameters,
+                                        outbound_message_t* outbound_message);
 
-bool outbound_message_pull_parameters(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
+bool outbound_message_pull_parameters(parser_t* parser, outbound_message_t* outbound_message);
 
-bool outbound_message_synchronize_parameters(parser_t* parser, const char* device_key, parameter_t* parameters,
-                                             size_t number_of_parameters, outbound_message_t* outbound_message);
+bool outbound_message_synchronize_parameters(parser_t* parser, parameter_t* parameters, size_t number_of_parameters,
+                                             outbound_message_t* outbound_message);
 
-bool outbound_message_synchronize_time(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
-bool outbound_message_details_synchronize(parser_t* parser, const char* device_key,
-                                          outbound_message_t* outbound_message);
+bool outbound_message_synchronize_time(parser_t* parser, outbound_message_t* outbound_message);
+bool outbound_message_details_synchronize(parser_t* parser, outbound_message_t* outbound_message);
 
 #ifdef __cplusplus
 }
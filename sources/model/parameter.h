@@ -31,6 +31,11 @@ typedef struct {
     char value[PARAMETER_VALUE_SIZE];
 } parameter_t;
 
+/**
+ * Receives parameters one at a time while message is being deserialized. Parameter is valid only during the call.
+ */
+typedef void (*parameter_callback_t)(void* context, parameter_t* parameter);
+
 void parameter_init(parameter_t* parameter_message, char* name, char* value);
 
 void parameter_set_value(parameter_t* parameter_message, char* buffer);
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "in_memory_packed_persistence.h"
+#include "model/outbound_message.h"
+#include "persistence/packed_record.h"
+#include "utility/record_buffer.h"
+#include "utility/wolk_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void in_memory_packed_persistence_init(in_memory_packed_persistence_t* persistence, void* storage, uint32_t size,
+                                       bool wrap)
+{
+    WOLK_ASSERT(size > RECORD_BUFFER_HEADER_SIZE + PACKED_RECORD_TOPIC_LENGTH_SIZE);
+
+    record_buffer_init(&persistence->buffer, storage, size, wrap);
+    persistence->topics = NULL;
+}
+
+void in_memory_packed_persistence_set_topics(in_memory_packed_persistence_t* persistence, outbound_topics_t* topics)
+{
+    persistence->topics = topics;
+}
+
+bool in_memory_packed_persistence_push(void* persistence, outbound_message_t* outbound_message)
+{
+    in_memory_packed_persistence_t* packed_persistence = (in_memory_packed_persistence_t*)persistence;
+    outbound_message_view_t view;
+    outbound_message_get_view(outbound_message, &view);
+
+    const uint16_t header = packed_record_header(packed_persistence->topics, &view);
+    uint8_t* record = record_buffer_allocate(&packed_persistence->buffer, packed_record_size(header, &view));
+    if (!record) {
+        return false;
+    }
+
+    packed_record_write(record, header, &view);
+    return true;
+}
+
+bool in_memory_packed_persistence_peek(void* persistence, outbound_message_t* outbound_message)
+{
+    in_memory_packed_persistence_t* packed_persistence = (in_memory_packed_persistence_t*)persistence;
+    record_buffer_t* buffer = &packed_persistence->buffer;
+    uint32_t record_length;
+    uint8_t* record = record_buffer_peek(buffer, &record_length);
+    if (!record) {
+        return false;
+    }
+
+    return packed_record_to_outbound_message(record, record_length, packed_persistence->topics, outbound_message);
+}
+
+bool in_memory_packed_persistence_pop(void* persistence, outbound_message_t* outbound_message)
+{
+    in_memory_packed_persistence_t* packed_persistence = (in_memory_packed_persistence_t*)persistence;
+    record_buffer_t* buffer = &packed_persistence->buffer;
+    uint32_t record_length;
+    uint8_t* record = record_buffer_peek(buffer, &record_length);
+    if (!record) {
+        return false;
+    }
+
+    if (outbound_message) {
+        packed_record_to_outbound_message(record, record_length, packed_persistence->topics, outbound_message);
+    }
+
+    return record_buffer_pop(buffer);
+}
+
+bool in_memory_packed_persistence_is_empty(void* persistence)
+{
+    record_buffer_t* buffer = &((in_memory_packed_persistence_t*)persistence)->buffer;
+    return record_buffer_empty(buffer);
+}
+
+bool in_memory_packed_persistence_peek_view(void* persistence, outbound_message_view_t* view)
+{
+    in_memory_packed_persistence_t* packed_persistence = (in_memory_packed_persistence_t*)persistence;
+    record_buffer_t* buffer = &packed_persistence->buffer;
+    uint32_t record_length;
+    uint8_t* record = record_buffer_peek(buffer, &record_length);
+    if (!record) {
+        return false;
+    }
+
+    return packed_record_read(record, record_length, packed_persistence->topics, view);
+}
+
+bool in_memory_packed_persistence_drop(void* persistence)
+{
+    record_buffer_t* buffer = &((in_memory_packed_persistence_t*)persistence)->buffer;
+    return record_buffer_pop(buffer);
+}
+
+uint32_t in_memory_packed_persistence_head_id(void* persistence)
+{
+    record_buffer_t* buffer = &((in_memory_packed_persistence_t*)persistence)->buffer;
+    return buffer->popped;
+}
+
+size_t in_memory_packed_persistence_pop_n(void* persistence, outbound_message_t* outbound_messages, size_t count)
+{
+    in_memory_packed_persistence_t* packed_persistence = (in_memory_packed_persistence_t*)persistence;
+    record_buffer_t* buffer = &packed_persistence->buffer;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        uint32_t record_length;
+        uint8_t* record = record_buffer_peek(buffer, &record_length);
+        if (!record) {
+            break;
+        }
+
+        if (outbound_messages) {
+            packed_record_to_outbound_message(record, record_length, packed_persistence->topics,
+                                              &outbound_messages[i]);
+        }
+
+        record_buffer_pop(buffer);
+    }
+
+    return i;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IN_MEMORY_PACKED_PERSISTENCE_H
+#define IN_MEMORY_PACKED_PERSISTENCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "model/outbound_message.h"
+#include "utility/record_buffer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * In-memory persistence which stores outbound messages as length-prefixed topic/payload records packed back-to-back,
+ * so each message occupies only as much storage as its topic and payload need instead of sizeof(outbound_message_t).
+ * Topics of device's own messages can be replaced by their IDs, see in_memory_packed_persistence_set_topics.
+ */
+
+typedef struct {
+    record_buffer_t buffer;
+
+    /* Topics which records refer to by ID, NULL if records store full topics */
+    outbound_topics_t* topics;
+} in_memory_packed_persistence_t;
+
+void in_memory_packed_persistence_init(in_memory_packed_persistence_t* persistence, void* storage, uint32_t size,
+                                       bool wrap);
+
+/**
+ * Stores messages published to one of 'topics' with topic ID instead of the topic. 'topics' has to outlive persistence.
+ */
+void in_memory_packed_persistence_set_topics(in_memory_packed_persistence_t* persistence, outbound_topics_t* topics);
+
+bool in_memory_packed_persistence_push(void* persistence, outbound_message_t* outbound_message);
+
+bool in_memory_packed_persistence_peek(void* persistence, outbound_message_t* outbound_message);
+
+bool in_memory_packed_persistence_pop(void* persistence, outbound_message_t* outbound_message);
+
+bool in_memory_packed_persistence_is_empty(void* persistence);
+
+bool in_memory_packed_persistence_peek_view(void* persistence, outbound_message_view_t* view);
+
+bool in_memory_packed_persistence_drop(void* persistence);
+
+uint32_t in_memory_packed_persistence_head_id(void* persistence);
+
+size_t in_memory_packed_persistence_pop_n(void* persistence, outbound_message_t* outbound_messages, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
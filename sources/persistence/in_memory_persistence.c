@@ -22,32 +22,90 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-static circular_buffer_t buffer;
-
-void in_memory_persistence_init(void* storage, uint32_t size, bool wrap)
+void in_memory_persistence_init(in_memory_persistence_t* persistence, void* storage, uint32_t size, bool wrap)
 {
     uint32_t num_elements = size / sizeof(outbound_message_t);
     WOLK_ASSERT(num_elements > 0);
 
-    circular_buffer_init(&buffer, storage, num_elements, sizeof(outbound_message_t), wrap, true);
+    circular_buffer_init(&persistence->buffer, storage, num_elements, sizeof(outbound_message_t), wrap, true);
+    persistence->popped = 0;
+}
+
+bool in_memory_persistence_push(void* persistence, outbound_message_t* outbound_message)
+{
+    in_memory_persistence_t* in_memory_persistence = (in_memory_persistence_t*)persistence;
+    circular_buffer_t* buffer = &in_memory_persistence->buffer;
+
+    /* Oldest message is overwritten */
+    const bool is_full = circular_buffer_full(buffer);
+    if (!circular_buffer_add(buffer, outbound_message)) {
+        return false;
+    }
+
+    if (is_full) {
+        in_memory_persistence->popped++;
+    }
+
+    return true;
+}
+
+bool in_memory_persistence_peek(void* persistence, outbound_message_t* outbound_message)
+{
+    circular_buffer_t* buffer = &((in_memory_persistence_t*)persistence)->buffer;
+    return circular_buffer_peek(buffer, 0, outbound_message);
+}
+
+bool in_memory_persistence_pop(void* persistence, outbound_message_t* outbound_message)
+{
+    in_memory_persistence_t* in_memory_persistence = (in_memory_persistence_t*)persistence;
+    if (!circular_buffer_pop(&in_memory_persistence->buffer, outbound_message)) {
+        return false;
+    }
+
+    in_memory_persistence->popped++;
+    return true;
 }
 
-bool in_memory_persistence_push(outbound_message_t* outbound_message)
+bool in_memory_persistence_is_empty(void* persistence)
 {
-    return circular_buffer_add(&buffer, outbound_message);
+    circular_buffer_t* buffer = &((in_memory_persistence_t*)persistence)->buffer;
+    return circular_buffer_empty(buffer);
 }
 
-bool in_memory_persistence_peek(outbound_message_t* outbound_message)
+bool in_memory_persistence_peek_view(void* persistence, outbound_message_view_t* view)
 {
-    return circular_buffer_peek(&buffer, 0, outbound_message);
+    circular_buffer_t* buffer = &((in_memory_persistence_t*)persistence)->buffer;
+    outbound_message_t* outbound_message = (outbound_message_t*)circular_buffer_peek_pointer(buffer, 0);
+    if (!outbound_message) {
+        return false;
+    }
+
+    outbound_message_get_view(outbound_message, view);
+    return true;
 }
 
-bool in_memory_persistence_pop(outbound_message_t* outbound_message)
+bool in_memory_persistence_drop(void* persistence)
 {
-    return circular_buffer_pop(&buffer, outbound_message);
+    return in_memory_persistence_pop(persistence, NULL);
 }
 
-bool in_memory_persistence_is_empty()
+uint32_t in_memory_persistence_head_id(void* persistence)
 {
-    return circular_buffer_empty(&buffer);
+    return ((in_memory_persistence_t*)persistence)->popped;
+}
+
+size_t in_memory_persistence_peek_n(void* persistence, outbound_message_t* outbound_messages, size_t count)
+{
+    circular_buffer_t* buffer = &((in_memory_persistence_t*)persistence)->buffer;
+    return circular_buffer_peek_array(buffer, 0, (uint32_t)count, outbound_messages);
+}
+
+size_t in_memory_persistence_pop_n(void* persistence, outbound_message_t* outbound_messages, size_t count)
+{
+    in_memory_persistence_t* in_memory_persistence = (in_memory_persistence_t*)persistence;
+    const uint32_t popped =
+        circular_buffer_pop_array(&in_memory_persistence->buffer, (uint32_t)count, outbound_messages);
+
+    in_memory_persistence->popped += popped;
+    return popped;
 }
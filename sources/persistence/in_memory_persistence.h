@@ -22,19 +22,38 @@ extern "C" {
 #endif
 
 #include "model/outbound_message.h"
+#include "utility/circular_buffer.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-void in_memory_persistence_init(void* storage, uint32_t num_elements, bool wrap);
+typedef struct {
+    circular_buffer_t buffer;
 
-bool in_memory_persistence_push(outbound_message_t* outbound_message);
+    /* Number of messages ever removed from the head, including messages overwritten by wrap */
+    uint32_t popped;
+} in_memory_persistence_t;
 
-bool in_memory_persistence_peek(outbound_message_t* outbound_message);
+void in_memory_persistence_init(in_memory_persistence_t* persistence, void* storage, uint32_t size, bool wrap);
 
-bool in_memory_persistence_pop(outbound_message_t* outbound_message);
+bool in_memory_persistence_push(void* persistence, outbound_message_t* outbound_message);
 
-bool in_memory_persistence_is_empty(void);
+bool in_memory_persistence_peek(void* persistence, outbound_message_t* outbound_message);
+
+bool in_memory_persistence_pop(void* persistence, outbound_message_t* outbound_message);
+
+bool in_memory_persistence_is_empty(void* persistence);
+
+bool in_memory_persistence_peek_view(void* persistence, outbound_message_view_t* view);
+
+bool in_memory_persistence_drop(void* persistence);
+
+uint32_t in_memory_persistence_head_id(void* persistence);
+
+size_t in_memory_persistence_peek_n(void* persistence, outbound_message_t* outbound_messages, size_t count);
+
+size_t in_memory_persistence_pop_n(void* persistence, outbound_message_t* outbound_messages, size_t count);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,602 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "mmap_log_persistence.h"
+
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+
+#include "model/outbound_message.h"
+#include "persistence/packed_record.h"
+#include "size_definitions.h"
+#include "utility/crc32.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*  Segment:                                                    */
+/*  4 bytes   - Magic                                           */
+/*  4 bytes   - Segment index                                   */
+/*  Records, terminated by zero length                          */
+/*                                                              */
+/*  Record:                                                     */
+/*  4 bytes   - Length of packed record                         */
+/*  4 bytes   - CRC-32 of segment index, length, packed record  */
+/*  N bytes   - Packed record                                   */
+#define SEGMENT_MAGIC 0x474F4C57u
+
+enum {
+    SEGMENT_HEADER_SIZE = 2 * sizeof(uint32_t),
+    RECORD_HEADER_SIZE = 2 * sizeof(uint32_t),
+    TERMINATOR_SIZE = sizeof(uint32_t),
+
+    SEGMENT_FILE_NAME_DIGITS = 8,
+    FILE_PATH_SIZE = PERSISTENCE_PATH_SIZE + 16
+};
+
+static uint32_t read_u32(const uint8_t* position)
+{
+    uint32_t value;
+    memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+static void write_u32(uint8_t* position, uint32_t value)
+{
+    memcpy(position, &value, sizeof(value));
+}
+
+static void segment_path(mmap_log_persistence_t* segment_log, char* path, uint32_t index)
+{
+    snprintf(path, FILE_PATH_SIZE, "%s/%08lu.seg", segment_log->directory, (unsigned long)index);
+}
+
+static void spare_segment_path(mmap_log_persistence_t* segment_log, char* path)
+{
+    snprintf(path, FILE_PATH_SIZE, "%s/spare.seg", segment_log->directory);
+}
+
+static void* map_file(const char* path, size_t size, bool create)
+{
+    struct stat file_stat;
+
+    int fd = open(path, create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &file_stat) != 0 || ((size_t)file_stat.st_size < size && ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return data == MAP_FAILED ? NULL : data;
+}
+
+static uint32_t record_crc(uint32_t segment_index, uint32_t length, const uint8_t* record)
+{
+    uint32_t crc = crc32_update(0, &segment_index, sizeof(segment_index));
+    crc = crc32_update(crc, &length, sizeof(length));
+    return crc32_update(crc, record, length);
+}
+
+static void terminate(mmap_log_persistence_t* segment_log, uint8_t* data, uint32_t offset)
+{
+    if (segment_log->segment_size - offset >= TERMINATOR_SIZE) {
+        write_u32(data + offset, 0);
+    }
+}
+
+/* Returns length of valid record at 'offset', or 0 if segment ends there */
+static uint32_t valid_record_length(mmap_log_persistence_t* segment_log, const mmap_log_segment_t* segment,
+                                    uint32_t offset)
+{
+    if (segment_log->segment_size - offset < RECORD_HEADER_SIZE) {
+        return 0;
+    }
+
+    const uint32_t length = read_u32(segment->data + offset);
+    if (length == 0 || length > segment_log->segment_size - offset - RECORD_HEADER_SIZE) {
+        return 0;
+    }
+
+    const uint32_t crc = read_u32(segment->data + offset + sizeof(uint32_t));
+    if (crc != record_crc(segment->index, length, segment->data + offset + RECORD_HEADER_SIZE)) {
+        return 0;
+    }
+
+    return length;
+}
+
+static void store_checkpoint(mmap_log_persistence_t* segment_log)
+{
+    mmap_log_checkpoint_t* checkpoint =
+        &segment_log->checkpoints[++segment_log->checkpoint_sequence % MMAP_LOG_CHECKPOINT_SLOTS];
+
+    checkpoint->sequence = segment_log->checkpoint_sequence;
+    checkpoint->segment = segment_log->read.index;
+    checkpoint->offset = segment_log->read_offset;
+    checkpoint->crc = crc32_update(0, checkpoint, offsetof(mmap_log_checkpoint_t, crc));
+}
+
+static bool load_checkpoint(mmap_log_persistence_t* segment_log, mmap_log_checkpoint_t* checkpoint)
+{
+    bool found = false;
+    size_t i;
+
+    for (i = 0; i < MMAP_LOG_CHECKPOINT_SLOTS; ++i) {
+        const mmap_log_checkpoint_t* slot = &segment_log->checkpoints[i];
+        if (slot->crc != crc32_update(0, slot, offsetof(mmap_log_checkpoint_t, crc))) {
+            continue;
+        }
+
+        if (!found || (int32_t)(slot->sequence - checkpoint->sequence) > 0) {
+            *checkpoint = *slot;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/* Consumed segment file is kept as spare for the next segment, instead of allocating new file */
+static void release_segment_file(mmap_log_persistence_t* segment_log, uint32_t index)
+{
+    char path[FILE_PATH_SIZE];
+    char spare_path[FILE_PATH_SIZE];
+
+    segment_path(segment_log, path, index);
+    spare_segment_path(segment_log, spare_path);
+
+    if (rename(path, spare_path) != 0) {
+        unlink(path);
+    }
+}
+
+static bool open_write_segment(mmap_log_persistence_t* segment_log, uint32_t index)
+{
+    char path[FILE_PATH_SIZE];
+    char spare_path[FILE_PATH_SIZE];
+
+    segment_path(segment_log, path, index);
+    spare_segment_path(segment_log, spare_path);
+    rename(spare_path, path);
+
+    uint8_t* data = (uint8_t*)map_file(path, segment_log->segment_size, true);
+    if (!data) {
+        return false;
+    }
+
+    write_u32(data, SEGMENT_MAGIC);
+    write_u32(data + sizeof(uint32_t), index);
+    terminate(segment_log, data, SEGMENT_HEADER_SIZE);
+
+    segment_log->write.index = index;
+    segment_log->write.data = data;
+    segment_log->write_offset = SEGMENT_HEADER_SIZE;
+
+    return true;
+}
+
+/* Maps first existing segment starting from 'index', up to write segment */
+static void open_read_segment(mmap_log_persistence_t* segment_log, uint32_t index)
+{
+    char path[FILE_PATH_SIZE];
+
+    for (; index != segment_log->write.index; ++index) {
+        segment_path(segment_log, path, index);
+
+        uint8_t* data = (uint8_t*)map_file(path, segment_log->segment_size, false);
+        if (data && read_u32(data) == SEGMENT_MAGIC && read_u32(data + sizeof(uint32_t)) == index) {
+            segment_log->read.index = index;
+            segment_log->read.data = data;
+            return;
+        }
+
+        if (data) {
+            munmap(data, segment_log->segment_size);
+        }
+        unlink(path);
+    }
+
+    segment_log->read = segment_log->write;
+}
+
+static void close_read_segment(mmap_log_persistence_t* segment_log)
+{
+    if (segment_log->read.index != segment_log->write.index) {
+        munmap(segment_log->read.data, segment_log->segment_size);
+    }
+}
+
+static void advance_read_segment(mmap_log_persistence_t* segment_log)
+{
+    const uint32_t consumed = segment_log->read.index;
+
+    close_read_segment(segment_log);
+    release_segment_file(segment_log, consumed);
+
+    open_read_segment(segment_log, consumed + 1);
+    segment_log->read_offset = SEGMENT_HEADER_SIZE;
+
+    store_checkpoint(segment_log);
+    msync(segment_log->checkpoints, MMAP_LOG_CHECKPOINT_SLOTS * sizeof(mmap_log_checkpoint_t), MS_ASYNC);
+}
+
+static uint8_t* read_record(mmap_log_persistence_t* segment_log, uint32_t* length)
+{
+    if (!segment_log->is_open) {
+        return NULL;
+    }
+
+    while (true) {
+        const bool is_write_segment = segment_log->read.index == segment_log->write.index;
+        if (is_write_segment && segment_log->read_offset >= segment_log->write_offset) {
+            return NULL;
+        }
+
+        *length = valid_record_length(segment_log, &segment_log->read, segment_log->read_offset);
+        if (*length != 0) {
+            return segment_log->read.data + segment_log->read_offset + RECORD_HEADER_SIZE;
+        }
+
+        if (is_write_segment) {
+            /* Damaged record, rest of the segment can not be trusted */
+            segment_log->read_offset = segment_log->write_offset;
+            store_checkpoint(segment_log);
+            return NULL;
+        }
+
+        advance_read_segment(segment_log);
+    }
+}
+
+static void consume_record(mmap_log_persistence_t* segment_log, uint32_t length)
+{
+    segment_log->read_offset += RECORD_HEADER_SIZE + length;
+    segment_log->popped++;
+    store_checkpoint(segment_log);
+}
+
+/* Records that can not be read as a message are dropped, as they would otherwise stay at the head of the log */
+static uint8_t* read_message_record(mmap_log_persistence_t* segment_log, uint32_t* length)
+{
+    outbound_message_view_t view;
+
+    while (true) {
+        uint8_t* record = read_record(segment_log, length);
+        if (!record) {
+            return NULL;
+        }
+
+        if (packed_record_read(record, *length, NULL, &view) && view.topic_length < TOPIC_SIZE
+            && view.payload_length < PAYLOAD_SIZE) {
+            return record;
+        }
+
+        consume_record(segment_log, *length);
+        segment_log->dropped++;
+    }
+}
+
+static bool start_next_write_segment(mmap_log_persistence_t* segment_log)
+{
+    /* Read cursor is moved past segments whose records are all consumed, so that they do not count as used */
+    uint32_t length;
+    read_record(segment_log, &length);
+
+    if (segment_log->write.index - segment_log->read.index + 1 >= segment_log->max_segments) {
+        if (!segment_log->wrap) {
+            return false;
+        }
+
+        /* Discard the oldest segment */
+        advance_read_segment(segment_log);
+        segment_log->popped++;
+    }
+
+    msync(segment_log->write.data, segment_log->segment_size, MS_ASYNC);
+
+    const mmap_log_segment_t previous = segment_log->write;
+    if (!open_write_segment(segment_log, previous.index + 1)) {
+        return false;
+    }
+
+    /* Previous write segment stays mapped if it is being read */
+    if (segment_log->read.index != previous.index) {
+        munmap(previous.data, segment_log->segment_size);
+    }
+
+    return true;
+}
+
+static void recover_write_offset(mmap_log_persistence_t* segment_log)
+{
+    uint32_t offset = SEGMENT_HEADER_SIZE;
+    uint32_t length;
+
+    while ((length = valid_record_length(segment_log, &segment_log->write, offset)) != 0) {
+        offset += RECORD_HEADER_SIZE + length;
+    }
+
+    segment_log->write_offset = offset;
+    terminate(segment_log, segment_log->write.data, offset);
+}
+
+static bool find_segments(mmap_log_persistence_t* segment_log, uint32_t* first, uint32_t* last)
+{
+    bool found = false;
+
+    DIR* directory = opendir(segment_log->directory);
+    if (!directory) {
+        return false;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != NULL) {
+        const char* name = entry->d_name;
+        if (strlen(name) != SEGMENT_FILE_NAME_DIGITS + strlen(".seg")
+            || strcmp(name + SEGMENT_FILE_NAME_DIGITS, ".seg") != 0
+            || strspn(name, "0123456789") != SEGMENT_FILE_NAME_DIGITS) {
+            continue;
+        }
+
+        const uint32_t index = (uint32_t)strtoul(name, NULL, 10);
+        if (!found || index < *first) {
+            *first = index;
+        }
+        if (!found || index > *last) {
+            *last = index;
+        }
+        found = true;
+    }
+
+    closedir(directory);
+    return found;
+}
+
+static bool recover(mmap_log_persistence_t* segment_log)
+{
+    mmap_log_checkpoint_t checkpoint = {0};
+    const bool has_checkpoint = load_checkpoint(segment_log, &checkpoint);
+    segment_log->checkpoint_sequence = has_checkpoint ? checkpoint.sequence : 0;
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (!find_segments(segment_log, &first, &last)) {
+        /* Start after checkpointed segment, so that recycled spare can not be mistaken for valid segment */
+        if (!open_write_segment(segment_log, has_checkpoint ? checkpoint.segment + 1 : 0)) {
+            return false;
+        }
+
+        segment_log->read = segment_log->write;
+        segment_log->read_offset = SEGMENT_HEADER_SIZE;
+        store_checkpoint(segment_log);
+        return true;
+    }
+
+    char path[FILE_PATH_SIZE];
+    segment_path(segment_log, path, last);
+    segment_log->write.index = last;
+    segment_log->write.data = (uint8_t*)map_file(path, segment_log->segment_size, true);
+    if (!segment_log->write.data) {
+        return false;
+    }
+
+    if (read_u32(segment_log->write.data) == SEGMENT_MAGIC
+        && read_u32(segment_log->write.data + sizeof(uint32_t)) == last) {
+        recover_write_offset(segment_log);
+    } else {
+        munmap(segment_log->write.data, segment_log->segment_size);
+        if (!open_write_segment(segment_log, last)) {
+            return false;
+        }
+    }
+
+    uint32_t read_index = first;
+    uint32_t read_offset = SEGMENT_HEADER_SIZE;
+    if (has_checkpoint && checkpoint.segment >= first && checkpoint.segment <= last
+        && checkpoint.offset >= SEGMENT_HEADER_SIZE && checkpoint.offset <= segment_log->segment_size
+        && (checkpoint.segment != last || checkpoint.offset <= segment_log->write_offset)) {
+        read_index = checkpoint.segment;
+        read_offset = checkpoint.offset;
+    }
+
+    /* Segments consumed before the last checkpoint */
+    for (; first < read_index; ++first) {
+        release_segment_file(segment_log, first);
+    }
+
+    open_read_segment(segment_log, read_index);
+    segment_log->read_offset = segment_log->read.index == read_index ? read_offset : SEGMENT_HEADER_SIZE;
+    store_checkpoint(segment_log);
+
+    return true;
+}
+
+bool mmap_log_persistence_init(mmap_log_persistence_t* segment_log, const char* directory, uint32_t segment_size,
+                               uint32_t max_segments, bool wrap)
+{
+    char path[FILE_PATH_SIZE];
+
+    segment_log->is_open = false;
+    segment_log->popped = 0;
+    segment_log->dropped = 0;
+    if (strlen(directory) >= PERSISTENCE_PATH_SIZE || max_segments < 2
+        || segment_size <= SEGMENT_HEADER_SIZE + RECORD_HEADER_SIZE + PACKED_RECORD_TOPIC_LENGTH_SIZE) {
+        return false;
+    }
+
+    strcpy(segment_log->directory, directory);
+    segment_log->segment_size = segment_size;
+    segment_log->max_segments = max_segments;
+    segment_log->wrap = wrap;
+
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+
+    snprintf(path, FILE_PATH_SIZE, "%s/checkpoint", segment_log->directory);
+    segment_log->checkpoints =
+        (mmap_log_checkpoint_t*)map_file(path, MMAP_LOG_CHECKPOINT_SLOTS * sizeof(mmap_log_checkpoint_t), true);
+    if (!segment_log->checkpoints) {
+        return false;
+    }
+
+    if (!recover(segment_log)) {
+        munmap(segment_log->checkpoints, MMAP_LOG_CHECKPOINT_SLOTS * sizeof(mmap_log_checkpoint_t));
+        return false;
+    }
+
+    segment_log->is_open = true;
+    return true;
+}
+
+bool mmap_log_persistence_push(void* persistence, outbound_message_t* outbound_message)
+{
+    mmap_log_persistence_t* segment_log = (mmap_log_persistence_t*)persistence;
+    outbound_message_view_t view;
+
+    if (!segment_log->is_open) {
+        return false;
+    }
+
+    outbound_message_get_view(outbound_message, &view);
+    /* Records outlive the process, so they store full topics instead of IDs of this process' topics */
+    const uint16_t header = packed_record_header(NULL, &view);
+    const uint32_t length = packed_record_size(header, &view);
+    if (length > segment_log->segment_size - SEGMENT_HEADER_SIZE - RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    if (segment_log->segment_size - segment_log->write_offset < RECORD_HEADER_SIZE + length
+        && !start_next_write_segment(segment_log)) {
+        return false;
+    }
+
+    uint8_t* record = segment_log->write.data + segment_log->write_offset;
+    packed_record_write(record + RECORD_HEADER_SIZE, header, &view);
+    write_u32(record + sizeof(uint32_t), record_crc(segment_log->write.index, length, record + RECORD_HEADER_SIZE));
+
+    segment_log->write_offset += RECORD_HEADER_SIZE + length;
+    terminate(segment_log, segment_log->write.data, segment_log->write_offset);
+
+    /* Record becomes visible once its length is written */
+    write_u32(record, length);
+
+    return true;
+}
+
+bool mmap_log_persistence_peek(void* persistence, outbound_message_t* outbound_message)
+{
+    mmap_log_persistence_t* segment_log = (mmap_log_persistence_t*)persistence;
+    uint32_t length;
+    uint8_t* record = read_message_record(segment_log, &length);
+    if (!record) {
+        return false;
+    }
+
+    return packed_record_to_outbound_message(record, length, NULL, outbound_message);
+}
+
+bool mmap_log_persistence_pop(void* persistence, outbound_message_t* outbound_message)
+{
+    mmap_log_persistence_t* segment_log = (mmap_log_persistence_t*)persistence;
+    uint32_t length;
+    uint8_t* record = read_message_record(segment_log, &length);
+    if (!record) {
+        return false;
+    }
+
+    if (outbound_message) {
+        packed_record_to_outbound_message(record, length, NULL, outbound_message);
+    }
+
+    consume_record(segment_log, length);
+
+    return true;
+}
+
+bool mmap_log_persistence_is_empty(void* persistence)
+{
+    mmap_log_persistence_t* segment_log = (mmap_log_persistence_t*)persistence;
+    uint32_t length;
+    return read_message_record(segment_log, &length) == NULL;
+}
+
+bool mmap_log_persistence_peek_view(void* persistence, outbound_message_view_t* view)
+{
+    mmap_log_persistence_t* segment_log = (mmap_log_persistence_t*)persistence;
+    uint32_t length;
+    uint8_t* record = read_message_record(segment_log, &length);
+    if (!record) {
+        return false;
+    }
+
+    return packed_record_read(record, length, NULL, view);
+}
+
+bool mmap_log_persistence_drop(void* persistence)
+{
+    return mmap_log_persistence_pop(persistence, NULL);
+}
+
+uint32_t mmap_log_persistence_head_id(void* persistence)
+{
+    return ((mmap_log_persistence_t*)persistence)->popped;
+}
+
+void mmap_log_persistence_sync(mmap_log_persistence_t* segment_log)
+{
+    if (!segment_log->is_open) {
+        return;
+    }
+
+    msync(segment_log->write.data, segment_log->segment_size, MS_SYNC);
+    msync(segment_log->checkpoints, MMAP_LOG_CHECKPOINT_SLOTS * sizeof(mmap_log_checkpoint_t), MS_SYNC);
+}
+
+void mmap_log_persistence_close(mmap_log_persistence_t* segment_log)
+{
+    if (!segment_log->is_open) {
+        return;
+    }
+
+    mmap_log_persistence_sync(segment_log);
+
+    close_read_segment(segment_log);
+    munmap(segment_log->write.data, segment_log->segment_size);
+    munmap(segment_log->checkpoints, MMAP_LOG_CHECKPOINT_SLOTS * sizeof(mmap_log_checkpoint_t));
+
+    segment_log->is_open = false;
+}
+
+#endif
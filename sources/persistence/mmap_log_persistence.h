@@ -0,0 +1,127 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef MMAP_LOG_PERSISTENCE_H
+#define MMAP_LOG_PERSISTENCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "model/outbound_message.h"
+#include "size_definitions.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MMAP_LOG_PERSISTENCE_SUPPORTED
+#endif
+
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+
+enum { MMAP_LOG_CHECKPOINT_SLOTS = 2 };
+
+/* Read cursor, written alternately to two slots so that one of them is always valid */
+typedef struct {
+    uint32_t sequence;
+    uint32_t segment;
+    uint32_t offset;
+    uint32_t crc;
+} mmap_log_checkpoint_t;
+
+typedef struct {
+    uint32_t index;
+    uint8_t* data;
+} mmap_log_segment_t;
+
+typedef struct {
+    char directory[PERSISTENCE_PATH_SIZE];
+    uint32_t segment_size;
+    uint32_t max_segments;
+    bool wrap;
+
+    mmap_log_segment_t write;
+    uint32_t write_offset;
+
+    /* Shares mapping with write segment when indexes are equal */
+    mmap_log_segment_t read;
+    uint32_t read_offset;
+
+    mmap_log_checkpoint_t* checkpoints;
+    uint32_t checkpoint_sequence;
+
+    /* Number of records popped or dropped, or segments discarded by wrap, since the log was opened */
+    uint32_t popped;
+
+    /* Number of records dropped since the log was opened because they could not be read as a message */
+    uint32_t dropped;
+
+    bool is_open;
+} mmap_log_persistence_t;
+
+/**
+ * Opens file backed persistence which appends messages to memory mapped segment files in 'directory'.
+ *
+ * Records store full topics, so they are published to the same topic after restart regardless of device key or build.
+ * Every record carries CRC-32, so after restart the log is recovered up to the last valid record of the newest segment,
+ * while reading resumes from checkpointed read cursor without scanning older segments. Consumed segments are recycled.
+ * Appended and consumed records reach the files as soon as they are written to the mapping, and are flushed to the
+ * storage when segment is filled or mmap_log_persistence_sync is called.
+ * Segment counts toward 'max_segments' until all of its records are consumed, so up to 'max_segments' - 1 full
+ * segments are kept besides the one being written.
+ * Opened persistence has to be closed with mmap_log_persistence_close before it is initialized again.
+ *
+ * @param persistence Persistence instance, passed as context to persistence callbacks
+ * @param directory Directory where segment files are kept, it is created if it does not exist
+ * @param segment_size Size of single segment file in bytes, has to fit the largest message
+ * @param max_segments Maximum number of segment files, at least 2
+ * @param wrap If all segments are full discard the oldest segment when pushing new item
+ *
+ * @return true if log was successfully opened, false otherwise
+ */
+bool mmap_log_persistence_init(mmap_log_persistence_t* persistence, const char* directory, uint32_t segment_size,
+                               uint32_t max_segments, bool wrap);
+
+bool mmap_log_persistence_push(void* persistence, outbound_message_t* outbound_message);
+
+bool mmap_log_persistence_peek(void* persistence, outbound_message_t* outbound_message);
+
+bool mmap_log_persistence_pop(void* persistence, outbound_message_t* outbound_message);
+
+bool mmap_log_persistence_is_empty(void* persistence);
+
+bool mmap_log_persistence_peek_view(void* persistence, outbound_message_view_t* view);
+
+bool mmap_log_persistence_drop(void* persistence);
+
+uint32_t mmap_log_persistence_head_id(void* persistence);
+
+/**
+ * Synchronously flushes current segment and read cursor to the storage.
+ */
+void mmap_log_persistence_sync(mmap_log_persistence_t* persistence);
+
+void mmap_log_persistence_close(mmap_log_persistence_t* persistence);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "persistence/packed_record.h"
+#include "model/outbound_message.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+uint16_t packed_record_header(const outbound_topics_t* topics, const outbound_message_view_t* view)
+{
+    const int topic_id = outbound_topics_find(topics, view->topic, view->topic_length);
+    if (topic_id == OUTBOUND_TOPIC_ID_NONE) {
+        return view->topic_length;
+    }
+
+    return (uint16_t)(PACKED_RECORD_TOPIC_ID | topic_id);
+}
+
+uint32_t packed_record_size(uint16_t header, const outbound_message_view_t* view)
+{
+    const uint16_t stored_topic_length = (header & PACKED_RECORD_TOPIC_ID) ? 0 : view->topic_length;
+    return PACKED_RECORD_TOPIC_LENGTH_SIZE + stored_topic_length + view->payload_length;
+}
+
+void packed_record_write(uint8_t* record, uint16_t header, const outbound_message_view_t* view)
+{
+    memcpy(record, &header, PACKED_RECORD_TOPIC_LENGTH_SIZE);
+    record += PACKED_RECORD_TOPIC_LENGTH_SIZE;
+
+    if (!(header & PACKED_RECORD_TOPIC_ID)) {
+        memcpy(record, view->topic, view->topic_length);
+        record += view->topic_length;
+    }
+
+    memcpy(record, view->payload, view->payload_length);
+}
+
+bool packed_record_read(uint8_t* record, uint32_t record_length, outbound_topics_t* topics,
+                        outbound_message_view_t* view)
+{
+    uint16_t header;
+
+    if (record_length < PACKED_RECORD_TOPIC_LENGTH_SIZE) {
+        return false;
+    }
+
+    memcpy(&header, record, PACKED_RECORD_TOPIC_LENGTH_SIZE);
+    record += PACKED_RECORD_TOPIC_LENGTH_SIZE;
+    record_length -= PACKED_RECORD_TOPIC_LENGTH_SIZE;
+
+    if (header & PACKED_RECORD_TOPIC_ID) {
+        const uint16_t topic_id = header & (uint16_t)~PACKED_RECORD_TOPIC_ID;
+        if (!topics || topic_id >= topics->number_of_topics) {
+            return false;
+        }
+
+        view->topic = topics->topics[topic_id];
+        view->topic_length = topics->topic_lengths[topic_id];
+
+        view->payload = (char*)record;
+        view->payload_length = record_length;
+        return true;
+    }
+
+    if (header > record_length) {
+        return false;
+    }
+
+    view->topic = (char*)record;
+    view->topic_length = header;
+
+    view->payload = view->topic + header;
+    view->payload_length = record_length - header;
+
+    return true;
+}
+
+bool packed_record_to_outbound_message(uint8_t* record, uint32_t record_length, outbound_topics_t* topics,
+                                       outbound_message_t* outbound_message)
+{
+    outbound_message_view_t view;
+
+    if (!packed_record_read(record, record_length, topics, &view) || view.topic_length >= TOPIC_SIZE
+        || view.payload_length >= PAYLOAD_SIZE) {
+        return false;
+    }
+
+    memcpy(outbound_message->topic, view.topic, view.topic_length);
+    outbound_message->topic[view.topic_length] = '\0';
+
+    memcpy(outbound_message->payload, view.payload, view.payload_length);
+    outbound_message->payload[view.payload_length] = '\0';
+
+    return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PACKED_RECORD_H
+#define PACKED_RECORD_H
+
+#include "model/outbound_message.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*  Record:                                                            */
+/*  2 bytes   - Topic length, or topic ID flagged by PACKED_RECORD_TOPIC_ID */
+/*  N bytes   - Topic, omitted when record refers to topic by ID            */
+/*  M bytes   - Payload                                                     */
+enum { PACKED_RECORD_TOPIC_LENGTH_SIZE = sizeof(uint16_t), PACKED_RECORD_TOPIC_ID = 0x8000 };
+
+/*
+ * Records refer to 'topics' by ID, so they have to be read with the same topics they were written with.
+ * Passing NULL 'topics' stores full topics of all messages, which records that outlive the process have to do, as
+ * topic IDs depend on the device key and the set of topics of the build.
+ */
+
+/**
+ * Returns header of record holding 'view', which refers to topic by ID if it is one of 'topics'.
+ */
+uint16_t packed_record_header(const outbound_topics_t* topics, const outbound_message_view_t* view);
+
+uint32_t packed_record_size(uint16_t header, const outbound_message_view_t* view);
+
+void packed_record_write(uint8_t* record, uint16_t header, const outbound_message_view_t* view);
+
+/**
+ * Points 'view' to topic and payload stored in record, returns false if record is malformed.
+ */
+bool packed_record_read(uint8_t* record, uint32_t record_length, outbound_topics_t* topics,
+                        outbound_message_view_t* view);
+
+/**
+ * Copies topic and payload stored in record to NULL terminated 'outbound_message' fields, returns false if record is
+ * malformed or they do not fit.
+ */
+bool packed_record_to_outbound_message(uint8_t* record, uint32_t record_length, outbound_topics_t* topics,
+                                       outbound_message_t* outbound_message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -20,7 +20,7 @@
 
 #include <stdbool.h>
 
-void persistence_init(persistence_t* persistence, persistence_push_t push, persistence_peek_t peek,
+void persistence_init(persistence_t* persistence, void* context, persistence_push_t push, persistence_peek_t peek,
                       persistence_pop_t pop, persistence_is_empty_t is_empty)
 {
     /* Sanity check */
@@ -30,34 +30,140 @@ void persistence_init(persistence_t* persistence, persistence_push_t push, persi
     WOLK_ASSERT(pop);
     WOLK_ASSERT(is_empty);
 
+    persistence->context = context;
+
     persistence->push = push;
     persistence->peek = peek;
     persistence->pop = pop;
     persistence->is_empty = is_empty;
 
+    persistence->peek_view = NULL;
+    persistence->drop = NULL;
+
+    persistence->peek_n = NULL;
+    persistence->pop_n = NULL;
+
+    persistence->head_id = NULL;
+
     persistence->is_initialized = true;
 }
 
+void persistence_set_view(persistence_t* persistence, persistence_peek_view_t peek_view, persistence_drop_t drop)
+{
+    /* Sanity check */
+    WOLK_ASSERT(persistence);
+    WOLK_ASSERT((peek_view == NULL) == (drop == NULL));
+
+    persistence->peek_view = peek_view;
+    persistence->drop = drop;
+}
+
+void persistence_set_batch(persistence_t* persistence, persistence_peek_n_t peek_n, persistence_pop_n_t pop_n)
+{
+    /* Sanity check */
+    WOLK_ASSERT(persistence);
+
+    persistence->peek_n = peek_n;
+    persistence->pop_n = pop_n;
+}
+
+void persistence_set_head_id(persistence_t* persistence, persistence_head_id_t head_id)
+{
+    /* Sanity check */
+    WOLK_ASSERT(persistence);
+
+    persistence->head_id = head_id;
+}
+
 bool persistence_is_initialized(const persistence_t* persistence)
 {
     return persistence->is_initialized;
 }
+
+bool persistence_has_view(const persistence_t* persistence)
+{
+    return persistence->peek_view != NULL && persistence->drop != NULL;
+}
+
+bool persistence_has_head_id(const persistence_t* persistence)
+{
+    return persistence->head_id != NULL;
+}
 bool persistence_push(persistence_t* persistence, outbound_message_t* item)
 {
-    return persistence->push(item);
+    return persistence->push(persistence->context, item);
 }
 
 bool persistence_peek(persistence_t* persistence, outbound_message_t* item)
 {
-    return persistence->peek(item);
+    return persistence->peek(persistence->context, item);
 }
 
 bool persistence_pop(persistence_t* persistence, outbound_message_t* item)
 {
-    return persistence->pop(item);
+    return persistence->pop(persistence->context, item);
+}
+
+bool persistence_peek_view(persistence_t* persistence, outbound_message_view_t* view)
+{
+    return persistence->peek_view(persistence->context, view);
+}
+
+bool persistence_drop(persistence_t* persistence)
+{
+    return persistence->drop(persistence->context);
+}
+
+size_t persistence_peek_n(persistence_t* persistence, outbound_message_t* items, size_t count)
+{
+    if (persistence->peek_n) {
+        return persistence->peek_n(persistence->context, items, count);
+    }
+
+    /* Single item peek always returns the oldest item */
+    if (count == 0 || persistence->is_empty(persistence->context)) {
+        return 0;
+    }
+
+    return persistence->peek(persistence->context, items) ? 1 : 0;
+}
+
+size_t persistence_pop_n(persistence_t* persistence, outbound_message_t* items, size_t count)
+{
+    size_t i;
+    outbound_message_t discarded;
+
+    if (persistence->pop_n) {
+        return persistence->pop_n(persistence->context, items, count);
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (persistence->is_empty(persistence->context)) {
+            break;
+        }
+
+        if (items) {
+            if (!persistence->pop(persistence->context, &items[i])) {
+                break;
+            }
+        } else if (persistence->drop) {
+            if (!persistence->drop(persistence->context)) {
+                break;
+            }
+        } else if (!persistence->pop(persistence->context, &discarded)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+uint32_t persistence_head_id(persistence_t* persistence)
+{
+    return persistence->head_id(persistence->context);
 }
 
 bool persistence_is_empty(persistence_t* persistence)
 {
-    return persistence->is_empty();
+    return persistence->is_empty(persistence->context);
 }
@@ -21,18 +21,24 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Every callback receives 'context' given to persistence_init, so that
+ * multiple persistence instances can coexist.
+ */
+
 /**
  * @brief persistence_push signature.
  * Pushes item to persistence.
  *
  * @return true if item was successfully pushed to persistence, false otherwise
  */
-typedef bool (*persistence_push_t)(outbound_message_t*);
+typedef bool (*persistence_push_t)(void* context, outbound_message_t*);
 
 /**
  * @brief persistence_peek signature.
@@ -41,7 +47,7 @@ typedef bool (*persistence_push_t)(outbound_message_t*);
  * @return true if item was successfully peeked from persistence, false
  * otherwise
  */
-typedef bool (*persistence_peek_t)(outbound_message_t*);
+typedef bool (*persistence_peek_t)(void* context, outbound_message_t*);
 
 /**
  * @brief persistence_pop signature.
@@ -50,7 +56,7 @@ typedef bool (*persistence_peek_t)(outbound_message_t*);
  * @return true if item was successfully popped from persistence, false
  * otherwise
  */
-typedef bool (*persistence_pop_t)(outbound_message_t*);
+typedef bool (*persistence_pop_t)(void* context, outbound_message_t*);
 
 /**
  * @brief persistence_is_empty signature.
@@ -58,28 +64,108 @@ typedef bool (*persistence_pop_t)(outbound_message_t*);
  *
  * @return true if persistence contains item(s), false otherwise
  */
-typedef bool (*persistence_is_empty_t)(void);
+typedef bool (*persistence_is_empty_t)(void* context);
+
+/**
+ * @brief persistence_peek_view signature.
+ * Peeks item from persistence without copying it. View remains valid until
+ * item is dropped or next item is pushed.
+ *
+ * @return true if item was successfully peeked from persistence, false
+ * otherwise
+ */
+typedef bool (*persistence_peek_view_t)(void* context, outbound_message_view_t*);
+
+/**
+ * @brief persistence_drop signature.
+ * Removes oldest item from persistence without copying it
+ *
+ * @return true if item was successfully removed from persistence, false
+ * otherwise
+ */
+typedef bool (*persistence_drop_t)(void* context);
+
+/**
+ * @brief persistence_peek_n signature.
+ * Peeks up to 'count' oldest items from persistence into 'items'
+ *
+ * @return number of peeked items
+ */
+typedef size_t (*persistence_peek_n_t)(void* context, outbound_message_t* items, size_t count);
+
+/**
+ * @brief persistence_pop_n signature.
+ * Pops up to 'count' oldest items from persistence into 'items'. If 'items' is
+ * NULL, items are discarded without being copied
+ *
+ * @return number of popped items
+ */
+typedef size_t (*persistence_pop_n_t)(void* context, outbound_message_t* items, size_t count);
+
+/**
+ * @brief persistence_head_id signature.
+ * Returns identity of the oldest item. Identity changes whenever the oldest
+ * item is removed, either by pop/drop or by being discarded to make room for
+ * pushed item when persistence wraps
+ *
+ * @return identity of the oldest item
+ */
+typedef uint32_t (*persistence_head_id_t)(void* context);
 
 typedef struct {
+    /* Passed to every callback, holds state of persistence instance */
+    void* context;
+
     persistence_push_t push;
     persistence_peek_t peek;
     persistence_pop_t pop;
     persistence_is_empty_t is_empty;
 
+    /* Optional, used to publish directly from persistence storage */
+    persistence_peek_view_t peek_view;
+    persistence_drop_t drop;
+
+    /* Optional, emulated with single item calls when not provided */
+    persistence_peek_n_t peek_n;
+    persistence_pop_n_t pop_n;
+
+    /* Optional, required for wrapping persistence so that item being sent is not mistaken for the next one */
+    persistence_head_id_t head_id;
+
     bool is_initialized;
 } persistence_t;
 
-void persistence_init(persistence_t* persistence, persistence_push_t push, persistence_peek_t peek,
+void persistence_init(persistence_t* persistence, void* context, persistence_push_t push, persistence_peek_t peek,
                       persistence_pop_t pop, persistence_is_empty_t is_empty);
 
+void persistence_set_view(persistence_t* persistence, persistence_peek_view_t peek_view, persistence_drop_t drop);
+
+void persistence_set_batch(persistence_t* persistence, persistence_peek_n_t peek_n, persistence_pop_n_t pop_n);
+
+void persistence_set_head_id(persistence_t* persistence, persistence_head_id_t head_id);
+
 bool persistence_is_initialized(const persistence_t* persistence);
 
+bool persistence_has_view(const persistence_t* persistence);
+
+bool persistence_has_head_id(const persistence_t* persistence);
+
 bool persistence_push(persistence_t* persistence, outbound_message_t* item);
 
 bool persistence_peek(persistence_t* persistence, outbound_message_t* item);
 
 bool persistence_pop(persistence_t* persistence, outbound_message_t* item);
 
+bool persistence_peek_view(persistence_t* persistence, outbound_message_view_t* view);
+
+bool persistence_drop(persistence_t* persistence);
+
+size_t persistence_peek_n(persistence_t* persistence, outbound_message_t* items, size_t count);
+
+size_t persistence_pop_n(persistence_t* persistence, outbound_message_t* items, size_t count);
+
+uint32_t persistence_head_id(persistence_t* persistence);
+
 bool persistence_is_empty(persistence_t* persistence);
 
 size_t persistence_size(persistence_t* persistence);
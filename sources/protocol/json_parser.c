@@ -21,7 +21,9 @@
 #include "model/firmware_update.h"
 #include "size_definitions.h"
 #include "utility/base64.h"
+#include "utility/dtoa.h"
 #include "utility/jsmn.h"
+#include "utility/json_writer.h"
 #include "utility/wolk_utils.h"
 
 #include <stdbool.h>
@@ -120,34 +122,26 @@ static const char* file_management_status_get_error_as_str(file_management_statu
     }
 }
 
-bool json_serialize_file_management_status(const char* device_key,
-                                           file_management_packet_request_t* file_management_packet_request,
+bool json_serialize_file_management_status(file_management_packet_request_t* file_management_packet_request,
                                            file_management_status_t* status, outbound_message_t* outbound_message)
 {
-    /* Serialize topic */
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FILE_MANAGEMENT_FILE_UPLOAD_STATUS_TOPIC,
-                      outbound_message->topic);
+    json_writer_t writer;
 
-    /* Check for errors*/
-    char file_management_error[ITEM_NAME_SIZE] = {0};
-    if (file_management_status_get_state(status) == FILE_MANAGEMENT_STATE_ERROR) {
-        if (snprintf(file_management_error, WOLK_ARRAY_LENGTH(file_management_error), "\"error\": \"%s\",",
-                     file_management_status_get_error_as_str(status))
-            >= (int)WOLK_ARRAY_LENGTH(file_management_error)) {
-            return false;
-        }
-    }
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-    /* Serialize payload */
-    if (snprintf(outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload),
-                 "{\"name\": \"%s\",%s\"status\": \"%s\"}",
-                 file_management_packet_request_get_file_name(file_management_packet_request), file_management_error,
-                 file_management_status_as_str(status))
-        >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-        return false;
+    json_writer_raw(&writer, "{\"name\": ");
+    json_writer_string(&writer, file_management_packet_request_get_file_name(file_management_packet_request));
+    json_writer_raw(&writer, ",");
+    if (file_management_status_get_state(status) == FILE_MANAGEMENT_STATE_ERROR) {
+        json_writer_raw(&writer, "\"error\": ");
+        json_writer_string(&writer, file_management_status_get_error_as_str(status));
+        json_writer_raw(&writer, ",");
     }
+    json_writer_raw(&writer, "\"status\": ");
+    json_writer_string(&writer, file_management_status_as_str(status));
+    json_writer_raw(&writer, "}");
 
-    return true;
+    return json_writer_ok(&writer);
 }
 
 bool json_deserialize_file_management_parameter(char* buffer, size_t buffer_size,
@@ -238,7 +232,8 @@ size_t json_deserialize_file_delete(char* buffer, size_t buffer_size, file_list_
         // eliminate '[', ']' and ' '
         if (strstr(files, JSON_ARRAY_LEFT_BRACKET) == NULL && strstr(files, JSON_ARRAY_RIGHT_BRACKET) == NULL
             && strcmp(files, " ") != 0) {
-            strncpy(file_list->file_name, files, strlen(files));
+            strncpy(file_list->file_name, files, WOLK_ARRAY_LENGTH(file_list->file_name) - 1);
+            file_list->file_name[WOLK_ARRAY_LENGTH(file_list->file_name) - 1] = '\0';
             file_list++;
             number_of_files_to_be_deleted++;
         }
@@ -250,91 +245,71 @@ size_t json_deserialize_file_delete(char* buffer, size_t buffer_size, file_list_
     return number_of_files_to_be_deleted;
 }
 
-bool json_serialize_file_management_packet_request(const char* device_key,
-                                                   file_management_packet_request_t* file_management_packet_request,
+bool json_serialize_file_management_packet_request(file_management_packet_request_t* file_management_packet_request,
                                                    outbound_message_t* outbound_message)
 {
-    /* Serialize topic */
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FILE_MANAGEMENT_FILE_BINARY_REQUEST_TOPIC,
-                      outbound_message->topic);
+    json_writer_t writer;
 
-    /* Serialize payload */
-    if (snprintf(outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload),
-                 "{\"name\": \"%s\", \"chunkIndex\":%llu}",
-                 file_management_packet_request_get_file_name(file_management_packet_request),
-                 (unsigned long long int)file_management_packet_request_get_chunk_index(file_management_packet_request))
-        >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-        return false;
-    }
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-    return true;
+    json_writer_raw(&writer, "{\"name\": ");
+    json_writer_string(&writer, file_management_packet_request_get_file_name(file_management_packet_request));
+    json_writer_raw(&writer, ", \"chunkIndex\":");
+    json_writer_uint64(&writer, file_management_packet_request_get_chunk_index(file_management_packet_request));
+    json_writer_raw(&writer, "}");
+
+    return json_writer_ok(&writer);
 }
 
-bool json_serialize_file_management_url_download_status(const char* device_key,
-                                                        file_management_parameter_t* file_management_parameter,
+bool json_serialize_file_management_url_download_status(file_management_parameter_t* file_management_parameter,
                                                         file_management_status_t* status,
                                                         outbound_message_t* outbound_message)
 {
-    /* Serialize topic */
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FILE_MANAGEMENT_URL_DOWNLOAD_STATUS_TOPIC,
-                      outbound_message->topic);
+    json_writer_t writer;
 
-    /* Serialize payload */
-    if (snprintf(outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload),
-                 "{\"fileUrl\":\"%s\",\"fileName\":\"%s\"",
-                 file_management_parameter_get_file_url(file_management_parameter),
-                 file_management_packet_request_get_file_name(file_management_parameter))
-        >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-        return false;
-    }
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
+
+    json_writer_raw(&writer, "{\"fileUrl\":");
+    json_writer_string(&writer, file_management_parameter_get_file_url(file_management_parameter));
+    json_writer_raw(&writer, ",\"fileName\":");
+    json_writer_string(&writer, file_management_packet_request_get_file_name(file_management_parameter));
 
     if (file_management_status_get_state(status) == FILE_MANAGEMENT_STATE_ERROR) {
         if (file_management_status_get_error(status) >= 0) {
-            if (snprintf(outbound_message->payload + strlen(outbound_message->payload),
-                         WOLK_ARRAY_LENGTH(outbound_message->payload), ",\"error\":\"%s\",\"status\":\"%s\"}",
-                         file_management_status_get_error_as_str(status), file_management_status_as_str(status))
-                >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-                return false;
-            }
+            json_writer_raw(&writer, ",\"error\":");
+            json_writer_string(&writer, file_management_status_get_error_as_str(status));
         }
+        json_writer_raw(&writer, ",\"status\":");
     } else {
-        if (snprintf(outbound_message->payload + strlen(outbound_message->payload),
-                     WOLK_ARRAY_LENGTH(outbound_message->payload), ",\"status\": \"%s\"}",
-                     file_management_status_as_str(status))
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-            return false;
-        }
+        json_writer_raw(&writer, ",\"status\": ");
     }
+    json_writer_string(&writer, file_management_status_as_str(status));
+    json_writer_raw(&writer, "}");
 
-    return true;
+    return json_writer_ok(&writer);
 }
 
-bool json_serialize_file_management_file_list_update(const char* device_key, file_list_t* file_list,
-                                                     size_t file_list_items, outbound_message_t* outbound_message)
+bool json_serialize_file_management_file_list_update(file_list_t* file_list, size_t file_list_items,
+                                                     outbound_message_t* outbound_message)
 {
-    /* Serialize topic */
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FILE_MANAGEMENT_FILE_LIST_TOPIC, outbound_message->topic);
+    json_writer_t writer;
 
-    /* Serialize payload */
-    strncpy(outbound_message->payload, JSON_ARRAY_LEFT_BRACKET, strlen(JSON_ARRAY_LEFT_BRACKET));
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
+
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
     for (size_t i = 0; i < file_list_items; i++) {
-        char file_hash[3] = {0}; // TODO: implement it, it's optional at the protocol
+        json_writer_separator(&writer, i);
+        json_writer_raw(&writer, "{\"name\":");
+        json_writer_string(&writer, file_list->file_name);
+        json_writer_raw(&writer, ",\"size\":");
+        json_writer_uint64(&writer, file_list->file_size);
+        json_writer_raw(&writer, ",\"hash\":\"\"}"); // TODO: implement it, it's optional at the protocol
 
-        if (snprintf(outbound_message->payload + strlen(outbound_message->payload),
-                     WOLK_ARRAY_LENGTH(outbound_message->payload), "{\"name\":\"%s\",\"size\":%d,\"hash\":\"%s\"},",
-                     (const char*)file_list->file_name, file_list->file_size, file_hash)
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-            return false;
-        }
         file_list++;
     }
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
 
-    file_list_items == 0 ? strncpy(outbound_message->payload + strlen(outbound_message->payload),
-                                   JSON_ARRAY_RIGHT_BRACKET, strlen(JSON_ARRAY_RIGHT_BRACKET))
-                         : strncpy(outbound_message->payload + strlen(outbound_message->payload) - 1,
-                                   JSON_ARRAY_RIGHT_BRACKET, strlen(JSON_ARRAY_RIGHT_BRACKET));
-
-    return true;
+    return json_writer_ok(&writer);
 }
 
 bool json_deserialize_firmware_update_parameter(char* buffer, size_t buffer_size, firmware_update_t* parameter)
@@ -356,29 +331,21 @@ bool json_deserialize_firmware_update_parameter(char* buffer, size_t buffer_size
     return false;
 }
 
-bool json_serialize_firmware_update_status(const char* device_key, firmware_update_t* firmware_update,
-                                           outbound_message_t* outbound_message)
+bool json_serialize_firmware_update_status(firmware_update_t* firmware_update, outbound_message_t* outbound_message)
 {
-    /* Serialize topic */
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FIRMWARE_UPDATE_STATUS_TOPIC, outbound_message->topic);
+    json_writer_t writer;
 
-    /* Serialize payload */
-    if (snprintf(outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload), "{\"status\": \"%s\"}",
-                 firmware_update_status_as_str(firmware_update))
-        >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-        return false;
-    }
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
+    json_writer_raw(&writer, "{\"status\": ");
+    json_writer_string(&writer, firmware_update_status_as_str(firmware_update));
     if (firmware_update->error >= 0) {
-        if (snprintf(outbound_message->payload + strlen(outbound_message->payload) - 1,
-                     WOLK_ARRAY_LENGTH(outbound_message->payload), ",\"error\":\"%s\"}",
-                     firmware_update_error_as_str(firmware_update))
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload)) {
-            return false;
-        }
+        json_writer_raw(&writer, ",\"error\":");
+        json_writer_string(&writer, firmware_update_error_as_str(firmware_update));
     }
+    json_writer_raw(&writer, "}");
 
-    return true;
+    return json_writer_ok(&writer);
 }
 
 bool json_deserialize_time(char* buffer, size_t buffer_size, utc_command_t* utc_command)
@@ -456,6 +423,53 @@ bool json_create_topic(const char direction[TOPIC_DIRECTION_SIZE], const char de
     return true;
 }
 
+/* Deserializes feed object starting at tokens[*index], and moves index past it */
+static bool deserialize_feed_value(char* buffer, jsmntok_t* tokens, int number_of_tokens, int* index, feed_t* feed)
+{
+    feed->size = 1;
+    feed->utc = 0;
+    feed->reference[0] = '\0';
+    feed->data[0][0] = '\0';
+
+    int j;
+    for (j = *index + 1; j < number_of_tokens && tokens[j].type != JSMN_OBJECT; ++j) { // at 2nd position expects string
+        if (tokens[j].type == JSMN_STRING) {
+            if (j + 1 >= number_of_tokens) {
+                return false;
+            }
+            // get timestamp
+            if (json_token_str_equal(buffer, &tokens[j], "timestamp")) {
+                char timestamp[UTC_MILLISECONDS_LENGTH] = "";
+
+                if (snprintf(timestamp, WOLK_ARRAY_LENGTH(timestamp), "%.*s", tokens[j + 1].end - tokens[j + 1].start,
+                             buffer + tokens[j + 1].start)
+                    >= (int)WOLK_ARRAY_LENGTH(timestamp)) {
+                    return false;
+                }
+                char* string_part;
+                feed_set_utc(feed, strtoul(timestamp, &string_part, 10));
+            } else {
+                // get reference
+                if (snprintf(feed->reference, WOLK_ARRAY_LENGTH(feed->reference), "%.*s",
+                             tokens[j].end - tokens[j].start, buffer + tokens[j].start)
+                    >= (int)WOLK_ARRAY_LENGTH(feed->reference)) {
+                    return false;
+                }
+                // get value
+                j++; // move one position to select value, regardless it's json type: PRIMITIVE or STRING
+                if (snprintf(feed->data[0], WOLK_ARRAY_LENGTH(feed->data[0]), "%.*s", tokens[j].end - tokens[j].start,
+                             buffer + tokens[j].start)
+                    >= (int)WOLK_ARRAY_LENGTH(feed->data[0])) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    *index = j - 1;
+    return true;
+}
+
 size_t json_deserialize_feeds_value_message(char* buffer, size_t buffer_size, feed_t* feeds_received)
 {
     uint8_t number_of_deserialized_feeds = 0;
@@ -473,35 +487,8 @@ size_t json_deserialize_feeds_value_message(char* buffer, size_t buffer_size, fe
     for (int i = 1; i < parser_result; ++i) { // at 1st position expects json object; 0 position is json array
         if (tokens[i].type == JSMN_OBJECT) {
             // object equals feed
-            for (int j = i + 1; tokens[j].type != JSMN_OBJECT; ++j) { // at 2nd position expects string
-                if (tokens[j].type == JSMN_STRING) {
-                    // get timestamp
-                    if (json_token_str_equal(buffer, &tokens[j], "timestamp")) {
-                        char timestamp[UTC_MILLISECONDS_LENGTH] = "";
-
-                        if (snprintf(timestamp, WOLK_ARRAY_LENGTH(timestamp), "%.*s",
-                                     tokens[j + 1].end - tokens[j + 1].start, buffer + tokens[j + 1].start)
-                            >= (int)WOLK_ARRAY_LENGTH(timestamp)) {
-                            return false;
-                        }
-                        char* string_part;
-                        feed_set_utc(feeds_received, strtoul(timestamp, &string_part, 10));
-                    } else {
-                        // get reference
-                        if (snprintf(feeds_received->reference, WOLK_ARRAY_LENGTH(feeds_received->reference), "%.*s",
-                                     tokens[j].end - tokens[j].start, buffer + tokens[j].start)
-                            >= (int)WOLK_ARRAY_LENGTH(feeds_received->reference)) {
-                            return false;
-                        }
-                        // get value
-                        j++; // move one position to select value, regardless it's json type: PRIMITIVE or STRING
-                        if (snprintf(feeds_received->data, WOLK_ARRAY_LENGTH(feeds_received->data[0]), "%.*s",
-                                     tokens[j].end - tokens[j].start, buffer + tokens[j].start)
-                            >= (int)WOLK_ARRAY_LENGTH(feeds_received->data[0])) {
-                            return false;
-                        }
-                    }
-                }
+            if (!deserialize_feed_value(buffer, tokens, parser_result, &i, feeds_received)) {
+                return false;
             }
             // move to next feed
             feeds_received++;
@@ -511,6 +498,151 @@ size_t json_deserialize_feeds_value_message(char* buffer, size_t buffer_size, fe
     return number_of_deserialized_feeds;
 }
 
+size_t json_deserialize_feeds_value_message_each(char* buffer, size_t buffer_size, feed_t* feed,
+                                                 feed_callback_t callback, void* context)
+{
+    size_t number_of_deserialized_feeds = 0;
+    jsmn_parser parser;
+    jsmntok_t tokens[JSON_TOKEN_SIZE];
+
+    jsmn_init(&parser);
+    int parser_result = jsmn_parse(&parser, buffer, buffer_size, tokens, WOLK_ARRAY_LENGTH(tokens));
+
+    /* Received JSON must be valid, and top level element must be array */
+    if (parser_result < 1 || tokens[0].type != JSMN_ARRAY || parser_result >= (int)WOLK_ARRAY_LENGTH(tokens)) {
+        return 0;
+    }
+
+    for (int i = 1; i < parser_result; ++i) {
+        if (tokens[i].type == JSMN_OBJECT) {
+            // every feed reuses the same storage
+            if (!deserialize_feed_value(buffer, tokens, parser_result, &i, feed)) {
+                break;
+            }
+
+            callback(context, feed);
+            number_of_deserialized_feeds++;
+        }
+    }
+    return number_of_deserialized_feeds;
+}
+
+static uint64_t token_to_uint64(const char* buffer, const jsmntok_t* token)
+{
+    uint64_t value = 0;
+    for (int i = token->start; i < token->end && buffer[i] >= '0' && buffer[i] <= '9'; ++i) {
+        value = value * 10 + (uint64_t)(buffer[i] - '0');
+    }
+
+    return value;
+}
+
+/* Takes value of typed feed from token, strings are referenced in place */
+static bool deserialize_typed_feed_value(char* buffer, jsmntok_t* token, typed_feed_t* feed)
+{
+    const char* value = buffer + token->start;
+    const int length = token->end - token->start;
+
+    if (token->type == JSMN_PRIMITIVE && (value[0] == 't' || value[0] == 'f')) {
+        typed_feed_init_boolean(feed, feed->reference, value[0] == 't', feed->utc);
+    } else if (token->type == JSMN_PRIMITIVE && value[0] != 'n') {
+        char number[FEED_ELEMENT_SIZE];
+        if (snprintf(number, WOLK_ARRAY_LENGTH(number), "%.*s", length, value) >= (int)WOLK_ARRAY_LENGTH(number)) {
+            return false;
+        }
+        typed_feed_init_numeric(feed, feed->reference, strtod(number, NULL), feed->utc);
+    } else {
+        typed_feed_init_string(feed, feed->reference, value, (size_t)length, feed->utc);
+    }
+
+    return true;
+}
+
+/* Deserializes feed object starting at tokens[*index] in native type, and moves index past it */
+static bool deserialize_typed_feed(char* buffer, jsmntok_t* tokens, int number_of_tokens, int* index,
+                                   char reference[REFERENCE_SIZE], typed_feed_t* feed)
+{
+    reference[0] = '\0';
+    typed_feed_init_string(feed, reference, "", 0, 0);
+
+    int j;
+    for (j = *index + 1; j < number_of_tokens && tokens[j].type != JSMN_OBJECT; ++j) {
+        if (tokens[j].type != JSMN_STRING) {
+            continue;
+        }
+        if (j + 1 >= number_of_tokens) {
+            return false;
+        }
+
+        if (json_token_str_equal(buffer, &tokens[j], "timestamp")) {
+            feed->utc = token_to_uint64(buffer, &tokens[j + 1]);
+            continue;
+        }
+
+        if (snprintf(reference, REFERENCE_SIZE, "%.*s", tokens[j].end - tokens[j].start, buffer + tokens[j].start)
+            >= REFERENCE_SIZE) {
+            return false;
+        }
+
+        j++; // value, regardless it's json type: PRIMITIVE or STRING
+        if (!deserialize_typed_feed_value(buffer, &tokens[j], feed)) {
+            return false;
+        }
+    }
+
+    *index = j - 1;
+    return true;
+}
+
+size_t json_deserialize_typed_feeds_each(char* buffer, size_t buffer_size, typed_feed_callback_t callback,
+                                         void* context)
+{
+    size_t number_of_deserialized_feeds = 0;
+    jsmn_parser parser;
+    jsmntok_t tokens[JSON_TOKEN_SIZE];
+
+    jsmn_init(&parser);
+    int parser_result = jsmn_parse(&parser, buffer, buffer_size, tokens, WOLK_ARRAY_LENGTH(tokens));
+
+    /* Received JSON must be valid, and top level element must be array */
+    if (parser_result < 1 || tokens[0].type != JSMN_ARRAY || parser_result >= (int)WOLK_ARRAY_LENGTH(tokens)) {
+        return 0;
+    }
+
+    char reference[REFERENCE_SIZE];
+    typed_feed_t feed;
+    for (int i = 1; i < parser_result; ++i) {
+        if (tokens[i].type == JSMN_OBJECT) {
+            if (!deserialize_typed_feed(buffer, tokens, parser_result, &i, reference, &feed)) {
+                break;
+            }
+
+            callback(context, &feed);
+            number_of_deserialized_feeds++;
+        }
+    }
+    return number_of_deserialized_feeds;
+}
+
+/* Deserializes name:value pair starting at tokens[index] */
+static bool deserialize_parameter(char* buffer, jsmntok_t* tokens, int index, parameter_t* parameter)
+{
+    // get name
+    if (snprintf(parameter->name, WOLK_ARRAY_LENGTH(parameter->name), "%.*s", tokens[index].end - tokens[index].start,
+                 buffer + tokens[index].start)
+        >= (int)WOLK_ARRAY_LENGTH(parameter->name)) {
+        return false;
+    }
+    // get value
+    if (snprintf(parameter->value, WOLK_ARRAY_LENGTH(parameter->value), "%.*s",
+                 tokens[index + 1].end - tokens[index + 1].start, buffer + tokens[index + 1].start)
+        >= (int)WOLK_ARRAY_LENGTH(parameter->value)) {
+        return false;
+    }
+
+    return true;
+}
+
 size_t json_deserialize_parameter_message(char* buffer, size_t buffer_size, parameter_t* parameter_message)
 {
     uint8_t number_of_deserialized_parameters = 0;
@@ -525,18 +657,9 @@ size_t json_deserialize_parameter_message(char* buffer, size_t buffer_size, para
         return false;
     }
     // at 2nd position expects first json string; 1st position is json object
-    for (int i = 1; i < parser_result; i += 2) {
+    for (int i = 1; i + 1 < parser_result; i += 2) {
         if (tokens[i].type == JSMN_STRING) {
-            // get name
-            if (snprintf(parameter_message->name, WOLK_ARRAY_LENGTH(parameter_message->name), "%.*s",
-                         tokens[i].end - tokens[i].start, buffer + tokens[i].start)
-                >= (int)WOLK_ARRAY_LENGTH(parameter_message->name)) {
-                return false;
-            }
-            // get value
-            if (snprintf(parameter_message->value, WOLK_ARRAY_LENGTH(parameter_message->value), "%.*s",
-                         tokens[i + 1].end - tokens[i + 1].start, buffer + tokens[i + 1].start)
-                >= (int)WOLK_ARRAY_LENGTH(parameter_message->value)) {
+            if (!deserialize_parameter(buffer, tokens, i, parameter_message)) {
                 return false;
             }
             // move to next parameter
@@ -548,56 +671,101 @@ size_t json_deserialize_parameter_message(char* buffer, size_t buffer_size, para
     return number_of_deserialized_parameters;
 }
 
+size_t json_deserialize_parameter_message_each(char* buffer, size_t buffer_size, parameter_t* parameter,
+                                               parameter_callback_t callback, void* context)
+{
+    size_t number_of_deserialized_parameters = 0;
+    jsmn_parser parser;
+    jsmntok_t tokens[JSON_TOKEN_SIZE];
+
+    jsmn_init(&parser);
+    int parser_result = jsmn_parse(&parser, buffer, buffer_size, tokens, WOLK_ARRAY_LENGTH(tokens));
+
+    /* Received JSON must be valid, and top level element must be object */
+    if (parser_result < 1 || tokens[0].type != JSMN_OBJECT || parser_result >= (int)WOLK_ARRAY_LENGTH(tokens)) {
+        return 0;
+    }
+
+    for (int i = 1; i + 1 < parser_result; i += 2) {
+        if (tokens[i].type == JSMN_STRING) {
+            // every parameter reuses the same storage
+            if (!deserialize_parameter(buffer, tokens, i, parameter)) {
+                break;
+            }
+
+            callback(context, parameter);
+            number_of_deserialized_parameters++;
+        }
+    }
+
+    return number_of_deserialized_parameters;
+}
+
+/* Appends feed value, quoted unless it is numeric */
+static void serialize_feed_value(json_writer_t* writer, data_type_t type, const char* value)
+{
+    if (type == NUMERIC) {
+        json_writer_raw(writer, value);
+    } else {
+        json_writer_escaped(writer, value);
+    }
+}
+
 static bool serialize_feed(feed_t* feed, data_type_t type, size_t feed_element_size, char* buffer, size_t buffer_size)
 {
-    char data_buffer[PAYLOAD_SIZE] = "";
+    json_writer_t writer;
+    json_writer_init(&writer, buffer, buffer_size);
 
+    json_writer_raw(&writer, "[{");
+    json_writer_key(&writer, feed->reference);
+    if (type != NUMERIC) {
+        json_writer_raw(&writer, "\"");
+    }
     for (size_t i = 0; i < feed_element_size; ++i) {
-        strcat(data_buffer, feed->data[i]);
-
-        if (i < feed_element_size - 1)
-            strcat(data_buffer, ",");
+        json_writer_separator(&writer, i);
+        serialize_feed_value(&writer, type, feed->data[i]);
+    }
+    if (type != NUMERIC) {
+        json_writer_raw(&writer, "\"");
     }
 
-    if (feed_get_utc(feed) > 0
-        && snprintf(buffer, buffer_size, "[{\"%s\":%s%s%s,\"timestamp\":%ld}]", feed->reference,
-                    type == NUMERIC ? "" : "\"", data_buffer, type == NUMERIC ? "" : "\"", feed_get_utc(feed))
-               >= (int)buffer_size) {
-        return false;
-    } else if (feed_get_utc(feed) == 0
-               && snprintf(buffer, buffer_size, "[{\"%s\":%s%s%s}]", feed->reference, type == NUMERIC ? "" : "\"",
-                           data_buffer, type == NUMERIC ? "" : "\"")
-                      >= (int)buffer_size) {
-        return false;
+    if (feed_get_utc(feed) > 0) {
+        json_writer_raw(&writer, ",\"timestamp\":");
+        json_writer_uint64(&writer, feed_get_utc(feed));
     }
+    json_writer_raw(&writer, "}]");
 
-    return true;
+    return json_writer_ok(&writer);
 }
 
 static size_t serialize_feeds(feed_t* feeds, data_type_t type, size_t number_of_feeds, char* buffer, size_t buffer_size)
 {
-    WOLK_UNUSED(number_of_feeds);
-
-    char data_buffer[PAYLOAD_SIZE] = "";
-    strcat(buffer, JSON_ARRAY_LEFT_BRACKET);
+    json_writer_t writer;
+    json_writer_init(&writer, buffer, buffer_size);
 
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
     for (size_t i = 0; i < number_of_feeds; ++i) {
         // when it consists of more feeds with the same reference it has to have utc
         if (feed_get_utc(feeds) == 0)
             return false;
 
-        if (snprintf(data_buffer, buffer_size, "{\"%s\":%s%s%s,\"timestamp\":%ld}%s", feeds->reference,
-                     type == NUMERIC ? "" : "\"", feeds->data[0], type == NUMERIC ? "" : "\"", feed_get_utc(feeds),
-                     (number_of_feeds > 1 && i < (number_of_feeds - 1)) ? "," : "")
-            >= (int)buffer_size)
-            return false;
+        json_writer_separator(&writer, i);
+        json_writer_raw(&writer, "{");
+        json_writer_key(&writer, feeds->reference);
+        if (type == NUMERIC) {
+            json_writer_raw(&writer, feeds->data[0]);
+        } else {
+            json_writer_string(&writer, feeds->data[0]);
+        }
+        json_writer_raw(&writer, ",\"timestamp\":");
+        json_writer_uint64(&writer, feed_get_utc(feeds));
+        json_writer_raw(&writer, "}");
 
-        strcat(buffer, data_buffer);
         feeds++;
     }
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
 
-    strcat(buffer, JSON_ARRAY_RIGHT_BRACKET);
-    return true;
+    return json_writer_ok(&writer);
 }
 
 size_t json_serialize_feeds(feed_t* feeds, data_type_t type, size_t number_of_feeds, size_t feed_element_size,
@@ -613,151 +781,252 @@ size_t json_serialize_feeds(feed_t* feeds, data_type_t type, size_t number_of_fe
         return serialize_feed(feeds, type, feed_element_size, buffer, buffer_size) ? 1 : 0;
     }
 }
-bool json_serialize_attribute(const char* device_key, attribute_t* attributes, size_t number_of_attributes,
-                              outbound_message_t* outbound_message)
+
+static void serialize_typed_number(json_writer_t* writer, double value, int8_t decimals)
 {
-    char payload[PAYLOAD_SIZE] = "";
+    char number[DTOA_BUFFER_SIZE];
 
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_ATTRIBUTE_REGISTRATION_TOPIC, outbound_message->topic);
+    if (decimals < 0) {
+        dtoa_shortest(value, number);
+    } else {
+        dtoa_fixed(value, (uint8_t)decimals, number);
+    }
+    json_writer_raw(writer, number);
+}
 
-    strncpy(outbound_message->payload, JSON_ARRAY_LEFT_BRACKET, 1);
-    for (int i = 0; i < number_of_attributes; ++i) {
-        if (sprintf(payload, "{\"name\": \"%s\", \"dataType\": \"%s\", \"value\": \"%s\"}%s", attributes->name,
-                    attributes->data_type, attributes->value,
-                    number_of_attributes > 1 && i < (number_of_attributes - 1) ? "," : "")
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload))
-            return false;
+/* Appends feed value, quoted unless it is numeric */
+static void serialize_typed_feed_value(json_writer_t* writer, const typed_feed_t* feed)
+{
+    switch (feed->type) {
+    case NUMERIC:
+        serialize_typed_number(writer, feed->value.numeric, feed->decimals);
+        break;
+    case BOOLEAN:
+        json_writer_raw(writer, feed->value.boolean ? "\"true\"" : "\"false\"");
+        break;
+    case VECTOR:
+        /* All values are sent as a single comma separated string */
+        json_writer_raw(writer, "\"");
+        for (size_t i = 0; i < feed->size; ++i) {
+            json_writer_separator(writer, i);
+            serialize_typed_number(writer, feed->vector[i], feed->decimals);
+        }
+        json_writer_raw(writer, "\"");
+        break;
+    default:
+        json_writer_raw(writer, "\"");
+        json_writer_escaped_length(writer, feed->value.string.data, feed->value.string.length);
+        json_writer_raw(writer, "\"");
+        break;
+    }
+}
+
+/* Appends '{"reference":value,"timestamp":utc}', timestamp is omitted when it is not set */
+static void serialize_typed_feed(json_writer_t* writer, const typed_feed_t* feed)
+{
+    if (feed->key) {
+        json_writer_raw_length(writer, feed->key, feed->key_length);
+    } else {
+        json_writer_raw(writer, "{");
+        json_writer_key(writer, feed->reference);
+    }
+    serialize_typed_feed_value(writer, feed);
+    if (feed->utc > 0) {
+        json_writer_raw(writer, ",\"timestamp\":");
+        json_writer_uint64(writer, feed->utc);
+    }
+    json_writer_raw(writer, "}");
+}
+
+bool json_serialize_typed_feeds(const typed_feed_t* feeds, size_t number_of_feeds, char* buffer, size_t buffer_size)
+{
+    /* Sanity check */
+    WOLK_ASSERT(number_of_feeds > 0);
+
+    json_writer_t writer;
+    json_writer_init(&writer, buffer, buffer_size);
 
-        if (strlen(payload) > (PAYLOAD_SIZE - strlen(outbound_message->payload)))
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        // when it consists of more feeds with the same reference it has to have utc
+        if (number_of_feeds > 1 && feeds[i].utc == 0) {
             return false;
+        }
 
-        strcat(outbound_message->payload, payload);
-        attributes++;
+        json_writer_separator(&writer, i);
+        serialize_typed_feed(&writer, &feeds[i]);
     }
-    strcat(outbound_message->payload, JSON_ARRAY_RIGHT_BRACKET);
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
+
+    return json_writer_ok(&writer);
+}
 
+/* Serializes '{"reference":', the part of feed which precedes its value */
+bool json_serialize_typed_feed_key(const char* reference, char* buffer, size_t buffer_size, size_t* length)
+{
+    json_writer_t writer;
+    json_writer_init(&writer, buffer, buffer_size);
+
+    json_writer_raw(&writer, "{");
+    json_writer_key(&writer, reference);
+
+    *length = json_writer_length(&writer);
+    return json_writer_ok(&writer);
+}
+
+bool json_append_typed_feed(const typed_feed_t* feed, char* buffer, size_t buffer_size, size_t* length)
+{
+    /* Closing bracket of the array is overwritten and appended again after the feed */
+    const size_t start = *length > 0 ? *length - 1 : 0;
+    if (start >= buffer_size) {
+        return false;
+    }
+
+    json_writer_t writer;
+    json_writer_init(&writer, buffer + start, buffer_size - start);
+
+    json_writer_raw(&writer, *length > 0 ? "," : JSON_ARRAY_LEFT_BRACKET);
+    serialize_typed_feed(&writer, feed);
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
+
+    if (!json_writer_ok(&writer)) {
+        /* Leave feeds appended so far intact */
+        strcpy(buffer + start, *length > 0 ? JSON_ARRAY_RIGHT_BRACKET : "");
+        return false;
+    }
+
+    *length = start + json_writer_length(&writer);
     return true;
 }
-bool json_serialize_parameter(const char* device_key, parameter_t* parameter, size_t number_of_parameters,
+
+bool json_serialize_attribute(attribute_t* attributes, size_t number_of_attributes,
                               outbound_message_t* outbound_message)
 {
-    char payload[PAYLOAD_SIZE] = "";
+    json_writer_t writer;
 
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_PARAMETERS_TOPIC, outbound_message->topic);
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-    strcat(outbound_message->payload, "{");
-    for (int i = 0; i < number_of_parameters; ++i) {
-        if (sprintf(payload, "\"%s\": \"%s\"%s", parameter->name, parameter->value,
-                    (number_of_parameters > 1 && i < (number_of_parameters - 1)) ? "," : "")
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload))
-            return false;
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
+    for (size_t i = 0; i < number_of_attributes; ++i) {
+        json_writer_separator(&writer, i);
+        json_writer_raw(&writer, "{\"name\": ");
+        json_writer_string(&writer, attributes->name);
+        json_writer_raw(&writer, ", \"dataType\": ");
+        json_writer_string(&writer, attributes->data_type);
+        json_writer_raw(&writer, ", \"value\": ");
+        json_writer_string(&writer, attributes->value);
+        json_writer_raw(&writer, "}");
 
-        if (strlen(payload) > (PAYLOAD_SIZE - strlen(outbound_message->payload)))
-            return false;
+        attributes++;
+    }
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
+
+    return json_writer_ok(&writer);
+}
+bool json_serialize_parameter(parameter_t* parameter, size_t number_of_parameters, outbound_message_t* outbound_message)
+{
+    json_writer_t writer;
+
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
+
+    json_writer_raw(&writer, "{");
+    for (size_t i = 0; i < number_of_parameters; ++i) {
+        json_writer_separator(&writer, i);
+        json_writer_key(&writer, parameter->name);
+        json_writer_raw(&writer, " ");
+        json_writer_string(&writer, parameter->value);
 
-        strcat(outbound_message->payload, payload);
         parameter++;
     }
-    strcat(outbound_message->payload, "}");
+    json_writer_raw(&writer, "}");
 
-    return true;
+    return json_writer_ok(&writer);
 }
 
-bool json_serialize_feed_registration(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+bool json_serialize_feed_registration(feed_registration_t* feed, size_t number_of_feeds,
                                       outbound_message_t* outbound_message)
 {
-    char payload[PAYLOAD_SIZE] = "";
+    json_writer_t writer;
 
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FEED_REGISTRATION_TOPIC, outbound_message->topic);
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-    strcat(outbound_message->payload, JSON_ARRAY_LEFT_BRACKET);
-    for (int i = 0; i < number_of_feeds; ++i) {
-        if (sprintf(payload, "{\"name\": \"%s\", \"type\": \"%s\", \"unitGuid\": \"%s\", \"reference\": \"%s\"}%s",
-                    feed->name, feed_type_to_string(feed->feedType), feed->unit, feed->reference,
-                    (number_of_feeds > 1 && i < (number_of_feeds - 1) ? "," : ""))
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload))
-            return false;
-
-        if (strlen(payload) > (PAYLOAD_SIZE - strlen(outbound_message->payload)))
-            return false;
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        json_writer_separator(&writer, i);
+        json_writer_raw(&writer, "{\"name\": ");
+        json_writer_string(&writer, feed->name);
+        json_writer_raw(&writer, ", \"type\": ");
+        json_writer_string(&writer, feed_type_to_string(feed->feedType));
+        json_writer_raw(&writer, ", \"unitGuid\": ");
+        json_writer_string(&writer, feed->unit);
+        json_writer_raw(&writer, ", \"reference\": ");
+        json_writer_string(&writer, feed->reference);
+        json_writer_raw(&writer, "}");
 
-        strcat(outbound_message->payload, payload);
         feed++;
     }
-    strcat(outbound_message->payload, JSON_ARRAY_RIGHT_BRACKET);
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
 
-    return true;
+    return json_writer_ok(&writer);
 }
-bool json_serialize_feed_removal(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+bool json_serialize_feed_removal(feed_registration_t* feed, size_t number_of_feeds,
                                  outbound_message_t* outbound_message)
 {
-    char payload[PAYLOAD_SIZE] = "";
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_FEED_REMOVAL_TOPIC, outbound_message->topic);
+    json_writer_t writer;
 
-    strcat(outbound_message->payload, JSON_ARRAY_LEFT_BRACKET);
-    for (int i = 0; i < number_of_feeds; ++i) {
-        if (sprintf(payload, "\"%s\"%s", feed->name, (number_of_feeds > 1 && i < (number_of_feeds - 1) ? "," : ""))
-            >= (int)WOLK_ARRAY_LENGTH(outbound_message->payload))
-            return false;
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-        if (strlen(payload) > (PAYLOAD_SIZE - strlen(outbound_message->payload)))
-            return false;
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        json_writer_separator(&writer, i);
+        json_writer_string(&writer, feed->name);
 
-        strcat(outbound_message->payload, payload);
         feed++;
     }
-    strcat(outbound_message->payload, JSON_ARRAY_RIGHT_BRACKET);
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
 
-    return true;
+    return json_writer_ok(&writer);
 }
-bool json_serialize_pull_feed_values(const char* device_key, outbound_message_t* outbound_message)
+bool json_serialize_pull_feed_values(outbound_message_t* outbound_message)
 {
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_PULL_FEEDS_TOPIC, outbound_message->topic);
-    strncpy(outbound_message->payload, "", PAYLOAD_SIZE);
+    outbound_message->payload[0] = '\0';
 
     return true;
 }
-bool json_serialize_pull_parameters(const char* device_key, outbound_message_t* outbound_message)
+bool json_serialize_pull_parameters(outbound_message_t* outbound_message)
 {
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_PULL_PARAMETERS_TOPIC, outbound_message->topic);
-    strncpy(outbound_message->payload, "", PAYLOAD_SIZE);
+    outbound_message->payload[0] = '\0';
 
     return true;
 }
-bool json_serialize_sync_parameters(const char* device_key, parameter_t* parameters, size_t number_of_parameters,
+bool json_serialize_sync_parameters(parameter_t* parameters, size_t number_of_parameters,
                                     outbound_message_t* outbound_message)
 {
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_SYNC_PARAMETERS_TOPIC, outbound_message->topic);
+    json_writer_t writer;
 
-    strcat(outbound_message->payload, JSON_ARRAY_LEFT_BRACKET);
-    for (int i = 0; i < number_of_parameters; ++i) {
-        strcat(outbound_message->payload, "\"");
-        if (strlen(parameters->name) > (PAYLOAD_SIZE - strlen(outbound_message->payload)))
-            return false;
-        strcat(outbound_message->payload, parameters->name);
-        strcat(outbound_message->payload, "\"");
+    json_writer_init(&writer, outbound_message->payload, WOLK_ARRAY_LENGTH(outbound_message->payload));
 
-        if (number_of_parameters > 1 && i < (number_of_parameters - 1))
-            strcat(outbound_message->payload, ",");
+    json_writer_raw(&writer, JSON_ARRAY_LEFT_BRACKET);
+    for (size_t i = 0; i < number_of_parameters; ++i) {
+        json_writer_separator(&writer, i);
+        json_writer_string(&writer, parameters->name);
 
         parameters++;
     }
-    strcat(outbound_message->payload, JSON_ARRAY_RIGHT_BRACKET);
+    json_writer_raw(&writer, JSON_ARRAY_RIGHT_BRACKET);
 
-    return true;
+    return json_writer_ok(&writer);
 }
-bool json_serialize_sync_time(const char* device_key, outbound_message_t* outbound_message)
+bool json_serialize_sync_time(outbound_message_t* outbound_message)
 {
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_SYNC_TIME_TOPIC, outbound_message->topic);
-    strncpy(outbound_message->payload, "", PAYLOAD_SIZE);
+    outbound_message->payload[0] = '\0';
 
     return true;
 }
 
-bool json_serialize_sync_details_synchronization(const char* device_key, outbound_message_t* outbound_message)
+bool json_serialize_sync_details_synchronization(outbound_message_t* outbound_message)
 {
-    json_create_topic(JSON_D2P_TOPIC, device_key, JSON_SYNC_DETAILS_SYNCHRONIZATION_TOPIC, outbound_message->topic);
-    strncpy(outbound_message->payload, "", PAYLOAD_SIZE);
+    outbound_message->payload[0] = '\0';
 
     return true;
 }
@@ -69,35 +69,45 @@ extern const char JSON_FIRMWARE_UPDATE_ABORT_TOPIC[TOPIC_MESSAGE_TYPE_SIZE];
 
 size_t json_serialize_feeds(feed_t* feeds, data_type_t type, size_t number_of_feeds, size_t feed_element_size,
                             char* buffer, size_t buffer_size);
+bool json_serialize_typed_feeds(const typed_feed_t* feeds, size_t number_of_feeds, char* buffer, size_t buffer_size);
+bool json_append_typed_feed(const typed_feed_t* feed, char* buffer, size_t buffer_size, size_t* length);
+bool json_serialize_typed_feed_key(const char* reference, char* buffer, size_t buffer_size, size_t* length);
 
 size_t json_deserialize_feeds_value_message(char* buffer, size_t buffer_size, feed_t* feeds_received);
+size_t json_deserialize_feeds_value_message_each(char* buffer, size_t buffer_size, feed_t* feed,
+                                                 feed_callback_t callback, void* context);
+size_t json_deserialize_typed_feeds_each(char* buffer, size_t buffer_size, typed_feed_callback_t callback,
+                                         void* context);
 
 bool json_create_topic(const char direction[TOPIC_DIRECTION_SIZE], const char device_key[DEVICE_KEY_SIZE],
                        char message_type[TOPIC_MESSAGE_TYPE_SIZE], char topic[TOPIC_SIZE]);
 
-bool json_serialize_feed_registration(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+/* Serializers below fill in the payload only, topic of outbound message is set by parser */
+
+bool json_serialize_feed_registration(feed_registration_t* feed, size_t number_of_feeds,
                                       outbound_message_t* outbound_message);
-bool json_serialize_feed_removal(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+bool json_serialize_feed_removal(feed_registration_t* feed, size_t number_of_feeds,
                                  outbound_message_t* outbound_message);
-bool json_serialize_pull_feed_values(const char* device_key, outbound_message_t* outbound_message);
-bool json_serialize_parameter(const char* device_key, parameter_t* parameter, size_t number_of_parameters,
+bool json_serialize_pull_feed_values(outbound_message_t* outbound_message);
+bool json_serialize_parameter(parameter_t* parameter, size_t number_of_parameters,
                               outbound_message_t* outbound_message);
-bool json_serialize_pull_parameters(const char* device_key, outbound_message_t* outbound_message);
-bool json_serialize_sync_parameters(const char* device_key, parameter_t* parameters, size_t number_of_parameters,
+bool json_serialize_pull_parameters(outbound_message_t* outbound_message);
+bool json_serialize_sync_parameters(parameter_t* parameters, size_t number_of_parameters,
                                     outbound_message_t* outbound_message);
 size_t json_deserialize_parameter_message(char* buffer, size_t buffer_size, parameter_t* parameter_message);
+size_t json_deserialize_parameter_message_each(char* buffer, size_t buffer_size, parameter_t* parameter,
+                                               parameter_callback_t callback, void* context);
 
-bool json_serialize_attribute(const char* device_key, attribute_t* attributes, size_t number_of_attributes,
+bool json_serialize_attribute(attribute_t* attributes, size_t number_of_attributes,
                               outbound_message_t* outbound_message);
-bool json_serialize_sync_time(const char* device_key, outbound_message_t* outbound_message);
-bool json_serialize_sync_details_synchronization(const char* device_key, outbound_message_t* outbound_message);
+bool json_serialize_sync_time(outbound_message_t* outbound_message);
+bool json_serialize_sync_details_synchronization(outbound_message_t* outbound_message);
 bool json_deserialize_time(char* buffer, size_t buffer_size, utc_command_t* utc_command);
 bool json_deserialize_details_synchronization(char* buffer, size_t buffer_size, feed_registration_t* feeds,
                                               size_t* number_of_feeds, attribute_t* attributes,
                                               size_t* number_of_attributes);
 
-bool json_serialize_file_management_status(const char* device_key,
-                                           file_management_packet_request_t* file_management_packet_request,
+bool json_serialize_file_management_status(file_management_packet_request_t* file_management_packet_request,
                                            file_management_status_t* status, outbound_message_t* outbound_message);
 
 bool json_deserialize_file_management_parameter(char* buffer, size_t buffer_size,
@@ -107,20 +117,17 @@ bool json_deserialize_url_download(char* buffer, size_t buffer_size, char* url_d
 
 size_t json_deserialize_file_delete(char* buffer, size_t buffer_size, file_list_t* file_list);
 
-bool json_serialize_file_management_packet_request(const char* device_key,
-                                                   file_management_packet_request_t* file_management_packet_request,
+bool json_serialize_file_management_packet_request(file_management_packet_request_t* file_management_packet_request,
                                                    outbound_message_t* outbound_message);
 
-bool json_serialize_file_management_url_download_status(const char* device_key,
-                                                        file_management_parameter_t* file_management_parameter,
+bool json_serialize_file_management_url_download_status(file_management_parameter_t* file_management_parameter,
                                                         file_management_status_t* status,
                                                         outbound_message_t* outbound_message);
-bool json_serialize_file_management_file_list_update(const char* device_key, file_list_t* file_list,
-                                                     size_t file_list_items, outbound_message_t* outbound_message);
+bool json_serialize_file_management_file_list_update(file_list_t* file_list, size_t file_list_items,
+                                                     outbound_message_t* outbound_message);
 
 bool json_deserialize_firmware_update_parameter(char* buffer, size_t buffer_size, firmware_update_t* parameter);
-bool json_serialize_firmware_update_status(const char* device_key, firmware_update_t* firmware_update,
-                                           outbound_message_t* outbound_message);
+bool json_serialize_firmware_update_status(firmware_update_t* firmware_update, outbound_message_t* outbound_message);
 
 #ifdef __cplusplus
 }
@@ -25,6 +25,24 @@
 #include <stddef.h>
 #include <string.h>
 
+/* Message types of outbound topics, in order of parser_topic_t */
+static const char* const outbound_message_types[PARSER_TOPICS_NUMBER] = {
+    JSON_FEED_VALUES_MESSAGE_TOPIC,
+    JSON_FEED_REGISTRATION_TOPIC,
+    JSON_FEED_REMOVAL_TOPIC,
+    JSON_PULL_FEEDS_TOPIC,
+    JSON_ATTRIBUTE_REGISTRATION_TOPIC,
+    JSON_PARAMETERS_TOPIC,
+    JSON_PULL_PARAMETERS_TOPIC,
+    JSON_SYNC_PARAMETERS_TOPIC,
+    JSON_SYNC_TIME_TOPIC,
+    JSON_DETAILS_SYNCHRONIZATION_TOPIC,
+    JSON_FILE_MANAGEMENT_FILE_UPLOAD_STATUS_TOPIC,
+    JSON_FILE_MANAGEMENT_FILE_BINARY_REQUEST_TOPIC,
+    JSON_FILE_MANAGEMENT_URL_DOWNLOAD_STATUS_TOPIC,
+    JSON_FILE_MANAGEMENT_FILE_LIST_TOPIC,
+    JSON_FIRMWARE_UPDATE_STATUS_TOPIC,
+};
 
 void parser_init(parser_t* parser)
 {
@@ -32,8 +50,12 @@ void parser_init(parser_t* parser)
     WOLK_ASSERT(parser);
 
     parser->is_initialized = true;
+    parser->outbound_topics.number_of_topics = 0;
 
     parser->serialize_feeds = json_serialize_feeds;
+    parser->serialize_typed_feeds = json_serialize_typed_feeds;
+    parser->append_typed_feed = json_append_typed_feed;
+    parser->serialize_typed_feed_key = json_serialize_typed_feed_key;
 
     parser->serialize_file_management_status = json_serialize_file_management_status;
     parser->deserialize_file_management_parameter = json_deserialize_file_management_parameter;
@@ -50,6 +72,9 @@ void parser_init(parser_t* parser)
     parser->deserialize_details_synchronization = json_deserialize_details_synchronization;
     parser->deserialize_readings_value_message = json_deserialize_feeds_value_message;
     parser->deserialize_parameter_message = json_deserialize_parameter_message;
+    parser->deserialize_readings_value_message_each = json_deserialize_feeds_value_message_each;
+    parser->deserialize_parameter_message_each = json_deserialize_parameter_message_each;
+    parser->deserialize_typed_feeds_each = json_deserialize_typed_feeds_each;
 
     parser->create_topic = json_create_topic;
 
@@ -95,6 +120,38 @@ void parser_init(parser_t* parser)
     strncpy(parser->DETAILS_SYNCHRONIZATION_TOPIC, JSON_DETAILS_SYNCHRONIZATION_TOPIC, TOPIC_MESSAGE_TYPE_SIZE);
 }
 
+void parser_init_topics(parser_t* parser, const char* device_key)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(device_key);
+    WOLK_ASSERT(PARSER_TOPICS_NUMBER <= OUTBOUND_TOPICS_MAX);
+
+    outbound_topics_t* outbound_topics = &parser->outbound_topics;
+    for (uint16_t i = 0; i < PARSER_TOPICS_NUMBER; ++i) {
+        char message_type[TOPIC_MESSAGE_TYPE_SIZE];
+        strcpy(message_type, outbound_message_types[i]);
+
+        parser->create_topic(parser->D2P_TOPIC, device_key, message_type, outbound_topics->topics[i]);
+        outbound_topics->topic_lengths[i] = (uint16_t)strlen(outbound_topics->topics[i]);
+    }
+
+    outbound_topics->number_of_topics = PARSER_TOPICS_NUMBER;
+}
+
+size_t parser_get_topic(parser_t* parser, parser_topic_t type, char topic[TOPIC_SIZE])
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(type < PARSER_TOPICS_NUMBER);
+    WOLK_ASSERT(parser->outbound_topics.number_of_topics == PARSER_TOPICS_NUMBER);
+
+    const size_t length = parser->outbound_topics.topic_lengths[type];
+    memcpy(topic, parser->outbound_topics.topics[type], length + 1);
+
+    return length;
+}
+
 size_t parser_serialize_feeds(parser_t* parser, feed_t* readings, data_type_t type, size_t num_readings,
                               size_t reading_element_size, char* buffer, size_t buffer_size)
 {
@@ -106,18 +163,17 @@ size_t parser_serialize_feeds(parser_t* parser, feed_t* readings, data_type_t ty
     return parser->serialize_feeds(readings, type, num_readings, reading_element_size, buffer, buffer_size);
 }
 
-bool parser_serialize_file_management_status(parser_t* parser, const char* device_key,
+bool parser_serialize_file_management_status(parser_t* parser,
                                              file_management_packet_request_t* file_management_packet_request,
                                              file_management_status_t* status, outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(status);
     WOLK_ASSERT(outbound_message);
 
-    return parser->serialize_file_management_status(device_key, file_management_packet_request, status,
-                                                    outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FILE_UPLOAD_STATUS, outbound_message->topic);
+    return parser->serialize_file_management_status(file_management_packet_request, status, outbound_message);
 }
 
 bool parser_deserialize_file_management_parameter(parser_t* parser, char* buffer, size_t buffer_size,
@@ -151,47 +207,45 @@ size_t parser_deserialize_file_delete(parser_t* parser, char* buffer, size_t buf
     return parser->deserialize_file_delete(buffer, buffer_size, file_list);
 }
 
-bool parser_serialize_file_management_packet_request(parser_t* parser, const char* device_key,
+bool parser_serialize_file_management_packet_request(parser_t* parser,
                                                      file_management_packet_request_t* file_management_packet_request,
                                                      outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_management_packet_request);
     WOLK_ASSERT(outbound_message);
 
-    return parser->serialize_file_management_packet_request(device_key, file_management_packet_request,
-                                                            outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FILE_BINARY_REQUEST, outbound_message->topic);
+    return parser->serialize_file_management_packet_request(file_management_packet_request, outbound_message);
 }
 
-bool parser_serialize_file_management_url_download(parser_t* parser, const char* device_key,
+bool parser_serialize_file_management_url_download(parser_t* parser,
                                                    file_management_parameter_t* file_management_parameter,
                                                    file_management_status_t* status,
                                                    outbound_message_t* outbound_message)
 {
     /* Sanity check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_management_parameter);
     WOLK_ASSERT(status);
     WOLK_ASSERT(outbound_message);
 
-    return parser->serialize_file_management_url_download_status(device_key, file_management_parameter, status,
-                                                                 outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FILE_URL_DOWNLOAD_STATUS, outbound_message->topic);
+    return parser->serialize_file_management_url_download_status(file_management_parameter, status, outbound_message);
 }
 
-bool parser_serialize_file_management_file_list(parser_t* parser, const char* device_key, file_list_t* file_list,
-                                                size_t file_list_items, outbound_message_t* outbound_message)
+bool parser_serialize_file_management_file_list(parser_t* parser, file_list_t* file_list, size_t file_list_items,
+                                                outbound_message_t* outbound_message)
 {
     /* Sanity Check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(file_list);
     WOLK_ASSERT(file_list_items);
     WOLK_ASSERT(outbound_message);
 
-    return parser->serialize_file_management_file_list(device_key, file_list, file_list_items, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FILE_LIST, outbound_message->topic);
+    return parser->serialize_file_management_file_list(file_list, file_list_items, outbound_message);
 }
 
 bool parse_deserialize_firmware_update_parameter(parser_t* parser, char* buffer, size_t buffer_size,
@@ -205,16 +259,16 @@ bool parse_deserialize_firmware_update_parameter(parser_t* parser, char* buffer,
     return parser->deserialize_firmware_update_parameter(buffer, buffer_size, firmware_update_parameter);
 }
 
-bool parse_serialize_firmware_update_status(parser_t* parser, const char* device_key,
-                                            firmware_update_t* firmware_update, outbound_message_t* outbound_message)
+bool parse_serialize_firmware_update_status(parser_t* parser, firmware_update_t* firmware_update,
+                                            outbound_message_t* outbound_message)
 {
     /* Sanity Check */
     WOLK_ASSERT(parser);
-    WOLK_ASSERT(device_key);
     WOLK_ASSERT(firmware_update);
     WOLK_ASSERT(outbound_message);
 
-    return parser->serialize_firmware_update_status(device_key, firmware_update, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FIRMWARE_UPDATE_STATUS, outbound_message->topic);
+    return parser->serialize_firmware_update_status(firmware_update, outbound_message);
 }
 
 bool parser_deserialize_time(parser_t* parser, char* buffer, size_t buffer_size, utc_command_t* utc_command)
@@ -230,6 +284,38 @@ bool parser_deserialize_details_synchronization(parser_t* parser, char* buffer,
                                                        number_of_attributes);
 }
 
+bool parser_serialize_typed_feeds(parser_t* parser, const typed_feed_t* feeds, size_t number_of_feeds, char* buffer,
+                                  size_t buffer_size)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(number_of_feeds > 0);
+
+    return parser->serialize_typed_feeds(feeds, number_of_feeds, buffer, buffer_size);
+}
+
+bool parser_append_typed_feed(parser_t* parser, const typed_feed_t* feed, char* buffer, size_t buffer_size,
+                              size_t* length)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(feed);
+    WOLK_ASSERT(length);
+
+    return parser->append_typed_feed(feed, buffer, buffer_size, length);
+}
+
+bool parser_serialize_typed_feed_key(parser_t* parser, const char* reference, char* buffer, size_t buffer_size,
+                                     size_t* length)
+{
+    /* Sanity check */
+    WOLK_ASSERT(parser);
+    WOLK_ASSERT(reference);
+    WOLK_ASSERT(length);
+
+    return parser->serialize_typed_feed_key(reference, buffer, buffer_size, length);
+}
+
 bool parser_create_topic(parser_t* parser, char* direction, char* device_key, char* message_type, char* topic)
 {
     return parser->create_topic(direction, device_key, message_type, topic);
@@ -243,45 +329,69 @@ size_t parser_deserialize_parameter_message(parser_t* parser, char* buffer, size
 {
     return parser->deserialize_parameter_message(buffer, buffer_size, parameter_message);
 }
-bool parser_serialize_feed_registration(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                        size_t number_of_feeds, outbound_message_t* outbound_message)
+size_t parser_deserialize_feeds_message_each(parser_t* parser, char* buffer, size_t buffer_size, feed_t* feed,
+                                             feed_callback_t callback, void* context)
+{
+    return parser->deserialize_readings_value_message_each(buffer, buffer_size, feed, callback, context);
+}
+size_t parser_deserialize_parameter_message_each(parser_t* parser, char* buffer, size_t buffer_size,
+                                                 parameter_t* parameter, parameter_callback_t callback,
+                                                 void* context)
+{
+    return parser->deserialize_parameter_message_each(buffer, buffer_size, parameter, callback, context);
+}
+size_t parser_deserialize_typed_feeds_each(parser_t* parser, char* buffer, size_t buffer_size,
+                                           typed_feed_callback_t callback, void* context)
+{
+    return parser->deserialize_typed_feeds_each(buffer, buffer_size, callback, context);
+}
+bool parser_serialize_feed_registration(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                        outbound_message_t* outbound_message)
 {
-    return parser->serialize_feed_registration(device_key, feed, number_of_feeds, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FEED_REGISTRATION, outbound_message->topic);
+    return parser->serialize_feed_registration(feed, number_of_feeds, outbound_message);
 }
-bool parser_serialize_feed_removal(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                   size_t number_of_feeds, outbound_message_t* outbound_message)
+bool parser_serialize_feed_removal(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                   outbound_message_t* outbound_message)
 {
-    return parser->serialize_feed_removal(device_key, feed, number_of_feeds, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_FEED_REMOVAL, outbound_message->topic);
+    return parser->serialize_feed_removal(feed, number_of_feeds, outbound_message);
 }
-bool parser_serialize_pull_feed_values(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool parser_serialize_pull_feed_values(parser_t* parser, outbound_message_t* outbound_message)
 {
-    return parser->serialize_pull_feed_values(device_key, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_PULL_FEED_VALUES, outbound_message->topic);
+    return parser->serialize_pull_feed_values(outbound_message);
 }
-bool parser_serialize_pull_parameters(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool parser_serialize_pull_parameters(parser_t* parser, outbound_message_t* outbound_message)
 {
-    return parser->serialize_pull_parameters(device_key, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_PULL_PARAMETERS, outbound_message->topic);
+    return parser->serialize_pull_parameters(outbound_message);
 }
-bool parser_serialize_sync_parameters(parser_t* parser, const char* device_key, parameter_t* parameters,
-                                      size_t number_of_parameters, outbound_message_t* outbound_message)
+bool parser_serialize_sync_parameters(parser_t* parser, parameter_t* parameters, size_t number_of_parameters,
+                                      outbound_message_t* outbound_message)
 {
-    return parser->serialize_sync_parameters(device_key, parameters, number_of_parameters, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_SYNC_PARAMETERS, outbound_message->topic);
+    return parser->serialize_sync_parameters(parameters, number_of_parameters, outbound_message);
 }
-bool parser_serialize_sync_time(parser_t* parser, const char* device_key, outbound_message_t* outbound_message)
+bool parser_serialize_sync_time(parser_t* parser, outbound_message_t* outbound_message)
 {
-    return parser->serialize_sync_time(device_key, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_SYNC_TIME, outbound_message->topic);
+    return parser->serialize_sync_time(outbound_message);
 }
-bool parser_serialize_details_synchronization(parser_t* parser, const char* device_key,
-                                              outbound_message_t* outbound_message)
+bool parser_serialize_details_synchronization(parser_t* parser, outbound_message_t* outbound_message)
 {
-    return parser->serialize_sync_details_synchronization(device_key, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_DETAILS_SYNCHRONIZATION, outbound_message->topic);
+    return parser->serialize_sync_details_synchronization(outbound_message);
 }
-bool parser_serialize_attribute(parser_t* parser, const char* device_key, attribute_t* attributes,
-                                size_t number_of_attributes, outbound_message_t* outbound_message)
+bool parser_serialize_attribute(parser_t* parser, attribute_t* attributes, size_t number_of_attributes,
+                                outbound_message_t* outbound_message)
 {
-    return parser->serialize_attribute(device_key, attributes, number_of_attributes, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_ATTRIBUTE_REGISTRATION, outbound_message->topic);
+    return parser->serialize_attribute(attributes, number_of_attributes, outbound_message);
 }
-bool parser_serialize_parameter(parser_t* parser, const char* device_key, parameter_t* parameter,
-                                size_t number_of_parameters, outbound_message_t* outbound_message)
+bool parser_serialize_parameter(parser_t* parser, parameter_t* parameter, size_t number_of_parameters,
+                                outbound_message_t* outbound_message)
 {
-    return parser->serialize_parameter(device_key, parameter, number_of_parameters, outbound_message);
+    parser_get_topic(parser, PARSER_TOPIC_PARAMETERS, outbound_message->topic);
+    return parser->serialize_parameter(parameter, number_of_parameters, outbound_message);
 }
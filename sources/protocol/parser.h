@@ -36,9 +36,34 @@
 extern "C" {
 #endif
 
+/* Outbound message types, full topics of which are built once per device.
+ * Values are persisted as topic IDs, so new types are only appended. */
+typedef enum {
+    PARSER_TOPIC_FEED_VALUES = 0,
+    PARSER_TOPIC_FEED_REGISTRATION,
+    PARSER_TOPIC_FEED_REMOVAL,
+    PARSER_TOPIC_PULL_FEED_VALUES,
+    PARSER_TOPIC_ATTRIBUTE_REGISTRATION,
+    PARSER_TOPIC_PARAMETERS,
+    PARSER_TOPIC_PULL_PARAMETERS,
+    PARSER_TOPIC_SYNC_PARAMETERS,
+    PARSER_TOPIC_SYNC_TIME,
+    PARSER_TOPIC_DETAILS_SYNCHRONIZATION,
+    PARSER_TOPIC_FILE_UPLOAD_STATUS,
+    PARSER_TOPIC_FILE_BINARY_REQUEST,
+    PARSER_TOPIC_FILE_URL_DOWNLOAD_STATUS,
+    PARSER_TOPIC_FILE_LIST,
+    PARSER_TOPIC_FIRMWARE_UPDATE_STATUS,
+
+    PARSER_TOPICS_NUMBER
+} parser_topic_t;
+
 typedef struct {
     bool is_initialized;
 
+    /* 'd2p/<device_key>/<message type>' built by parser_init_topics, indexed by parser_topic_t */
+    outbound_topics_t outbound_topics;
+
     char FILE_MANAGEMENT_UPLOAD_INITIATE_TOPIC[TOPIC_SIZE];
     char FILE_MANAGEMENT_BINARY_REQUEST_TOPIC[TOPIC_SIZE];
     char FILE_MANAGEMENT_BINARY_RESPONSE_TOPIC[TOPIC_SIZE];
@@ -70,27 +95,26 @@ typedef struct {
 
     size_t (*serialize_feeds)(feed_t* readings, data_type_t type, size_t num_readings, size_t reading_element_size,
                               char* buffer, size_t buffer_size);
+    bool (*serialize_typed_feeds)(const typed_feed_t* feeds, size_t number_of_feeds, char* buffer, size_t buffer_size);
+    bool (*append_typed_feed)(const typed_feed_t* feed, char* buffer, size_t buffer_size, size_t* length);
+    bool (*serialize_typed_feed_key)(const char* reference, char* buffer, size_t buffer_size, size_t* length);
 
-    bool (*serialize_file_management_status)(const char* device_key,
-                                             file_management_packet_request_t* file_management_packet_request,
+    bool (*serialize_file_management_status)(file_management_packet_request_t* file_management_packet_request,
                                              file_management_status_t* status, outbound_message_t* outbound_message);
     bool (*deserialize_file_management_parameter)(char* buffer, size_t buffer_size,
                                                   file_management_parameter_t* parameter);
     bool (*deserialize_url_download)(char* buffer, size_t buffer_size, char* url_download);
     size_t (*deserialize_file_delete)(char* buffer, size_t buffer_size, file_list_t* file_list);
-    bool (*serialize_file_management_packet_request)(const char* device_key,
-                                                     file_management_packet_request_t* file_management_packet_request,
+    bool (*serialize_file_management_packet_request)(file_management_packet_request_t* file_management_packet_request,
                                                      outbound_message_t* outbound_message);
-    bool (*serialize_file_management_url_download_status)(const char* device_key,
-                                                          file_management_parameter_t* file_management_parameter,
+    bool (*serialize_file_management_url_download_status)(file_management_parameter_t* file_management_parameter,
                                                           file_management_status_t* status,
                                                           outbound_message_t* outbound_message);
-    bool (*serialize_file_management_file_list)(const char* device_key, file_list_t* file_list, size_t file_list_items,
+    bool (*serialize_file_management_file_list)(file_list_t* file_list, size_t file_list_items,
                                                 outbound_message_t* outbound_message);
 
     bool (*deserialize_firmware_update_parameter)(char* buffer, size_t buffer_size, firmware_update_t* parameter);
-    bool (*serialize_firmware_update_status)(const char* device_key, firmware_update_t* firmware_update,
-                                             outbound_message_t* outbound_message);
+    bool (*serialize_firmware_update_status)(firmware_update_t* firmware_update, outbound_message_t* outbound_message);
 
     bool (*deserialize_time)(char* buffer, size_t buffer_size, utc_command_t* utc_command);
     bool (*deserialize_details_synchronization)(char* buffer, size_t buffer_size, feed_registration_t* feeds,
@@ -101,32 +125,69 @@ typedef struct {
                          char message_type[TOPIC_MESSAGE_TYPE_SIZE], char topic[TOPIC_SIZE]);
     size_t (*deserialize_readings_value_message)(char* buffer, size_t buffer_size, feed_t* readings_received);
     size_t (*deserialize_parameter_message)(char* buffer, size_t buffer_size, parameter_t* parameter_message);
-    bool (*serialize_feed_registration)(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+    size_t (*deserialize_readings_value_message_each)(char* buffer, size_t buffer_size, feed_t* feed,
+                                                      feed_callback_t callback, void* context);
+    size_t (*deserialize_parameter_message_each)(char* buffer, size_t buffer_size, parameter_t* parameter,
+                                                 parameter_callback_t callback, void* context);
+    size_t (*deserialize_typed_feeds_each)(char* buffer, size_t buffer_size, typed_feed_callback_t callback,
+                                           void* context);
+    bool (*serialize_feed_registration)(feed_registration_t* feed, size_t number_of_feeds,
                                         outbound_message_t* outbound_message);
-    bool (*serialize_feed_removal)(const char* device_key, feed_registration_t* feed, size_t number_of_feeds,
+    bool (*serialize_feed_removal)(feed_registration_t* feed, size_t number_of_feeds,
                                    outbound_message_t* outbound_message);
-    bool (*serialize_pull_feed_values)(const char* device_key, outbound_message_t* outbound_message);
-    bool (*serialize_pull_parameters)(const char* device_key, outbound_message_t* outbound_message);
-    bool (*serialize_sync_parameters)(const char* device_key, parameter_t* parameters, size_t number_of_parameters,
+    bool (*serialize_pull_feed_values)(outbound_message_t* outbound_message);
+    bool (*serialize_pull_parameters)(outbound_message_t* outbound_message);
+    bool (*serialize_sync_parameters)(parameter_t* parameters, size_t number_of_parameters,
                                       outbound_message_t* outbound_message);
-    bool (*serialize_sync_time)(const char* device_key, outbound_message_t* outbound_message);
-    bool (*serialize_sync_details_synchronization)(const char* device_key, outbound_message_t* outbound_message);
-    bool (*serialize_attribute)(const char* device_key, attribute_t* attributes, size_t number_of_attributes,
+    bool (*serialize_sync_time)(outbound_message_t* outbound_message);
+    bool (*serialize_sync_details_synchronization)(outbound_message_t* outbound_message);
+    bool (*serialize_attribute)(attribute_t* attributes, size_t number_of_attributes,
                                 outbound_message_t* outbound_message);
-    bool (*serialize_parameter)(const char* device_key, parameter_t* parameter, size_t number_of_parameters,
+    bool (*serialize_parameter)(parameter_t* parameter, size_t number_of_parameters,
                                 outbound_message_t* outbound_message);
 
 } parser_t;
 
 void parser_init(parser_t* parser);
 
+/**
+ * Builds full outbound topics of the device once, so that serializing a message only copies its topic.
+ */
+void parser_init_topics(parser_t* parser, const char* device_key);
+
+/**
+ * Copies full outbound topic of given type to 'topic', and returns its length.
+ * Topics have to be built by parser_init_topics first.
+ */
+size_t parser_get_topic(parser_t* parser, parser_topic_t type, char topic[TOPIC_SIZE]);
+
 /**** Feed ****/
 size_t parser_serialize_feeds(parser_t* parser, feed_t* readings, data_type_t type, size_t num_readings,
                               size_t reading_element_size, char* buffer, size_t buffer_size);
+
+/**
+ * Serializes feeds straight from their native values. Returns false if serialized feeds do not fit the buffer.
+ */
+bool parser_serialize_typed_feeds(parser_t* parser, const typed_feed_t* feeds, size_t number_of_feeds, char* buffer,
+                                  size_t buffer_size);
+
+/**
+ * Appends feed to feeds serialized so far in the first 'length' characters of buffer, starting a new message when
+ * 'length' is zero, and updates 'length'. Returns false and leaves buffer unchanged if feed does not fit.
+ */
+bool parser_append_typed_feed(parser_t* parser, const typed_feed_t* feed, char* buffer, size_t buffer_size,
+                              size_t* length);
+
+/**
+ * Serializes the part of feed which precedes its value, to be reused as typed_feed_t key of feeds with the reference.
+ * Returns false if it does not fit the buffer.
+ */
+bool parser_serialize_typed_feed_key(parser_t* parser, const char* reference, char* buffer, size_t buffer_size,
+                                     size_t* length);
 /**** Feed ****/
 
 /**** File Management ****/
-bool parser_serialize_file_management_status(parser_t* parser, const char* device_key,
+bool parser_serialize_file_management_status(parser_t* parser,
                                              file_management_packet_request_t* file_management_packet_request,
                                              file_management_status_t* status, outbound_message_t* outbound_message);
 
@@ -137,25 +198,24 @@ bool parser_deserialize_url_download(parser_t* parser, char* buffer, size_t buff
 
 size_t parser_deserialize_file_delete(parser_t* parser, char* buffer, size_t buffer_size, file_list_t* file_list);
 
-bool parser_serialize_file_management_packet_request(parser_t* parser, const char* device_key,
+bool parser_serialize_file_management_packet_request(parser_t* parser,
                                                      file_management_packet_request_t* file_management_packet_request,
                                                      outbound_message_t* outbound_message);
 
-bool parser_serialize_file_management_url_download(parser_t* parser, const char* device_key,
-                                                   file_management_parameter_t* parameter,
+bool parser_serialize_file_management_url_download(parser_t* parser, file_management_parameter_t* parameter,
                                                    file_management_status_t* status,
                                                    outbound_message_t* outbound_message);
 
-bool parser_serialize_file_management_file_list(parser_t* parser, const char* device_key, file_list_t* file_list,
-                                                size_t file_list_items, outbound_message_t* outbound_message);
+bool parser_serialize_file_management_file_list(parser_t* parser, file_list_t* file_list, size_t file_list_items,
+                                                outbound_message_t* outbound_message);
 /**** File Management ****/
 
 /**** Firmware Update ****/
 bool parse_deserialize_firmware_update_parameter(parser_t* parser, char* buffer, size_t buffer_size,
                                                  firmware_update_t* firmware_update_parameter);
 
-bool parse_serialize_firmware_update_status(parser_t* parser, const char* device_key,
-                                            firmware_update_t* firmware_update, outbound_message_t* outbound_message);
+bool parse_serialize_firmware_update_status(parser_t* parser, firmware_update_t* firmware_update,
+                                            outbound_message_t* outbound_message);
 
 /**** Firmware Update ****/
 
@@ -173,27 +233,48 @@ size_t parser_deserialize_feeds_message(parser_t* parser, char* buffer, size_t b
 size_t parser_deserialize_parameter_message(parser_t* parser, char* buffer, size_t buffer_size,
                                             parameter_t* parameter_message);
 
-bool parser_serialize_feed_registration(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                        size_t number_of_feeds, outbound_message_t* outbound_message);
+/**
+ * Deserializes feeds one by one into 'feed' and passes each to 'callback', instead of filling an array.
+ * Returns number of feeds passed to callback; deserialization stops at the first malformed feed.
+ */
+size_t parser_deserialize_feeds_message_each(parser_t* parser, char* buffer, size_t buffer_size, feed_t* feed,
+                                             feed_callback_t callback, void* context);
 
-bool parser_serialize_feed_removal(parser_t* parser, const char* device_key, feed_registration_t* feed,
-                                   size_t number_of_feeds, outbound_message_t* outbound_message);
-bool parser_serialize_pull_feed_values(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
+/**
+ * Deserializes parameters one by one into 'parameter' and passes each to 'callback', instead of filling an array.
+ * Returns number of parameters passed to callback; deserialization stops at the first malformed parameter.
+ */
+size_t parser_deserialize_parameter_message_each(parser_t* parser, char* buffer, size_t buffer_size,
+                                                 parameter_t* parameter, parameter_callback_t callback,
+                                                 void* context);
 
-bool parser_serialize_pull_parameters(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
+/**
+ * Deserializes feeds one by one in their native type and passes each to 'callback'. String values reference the
+ * buffer. Returns number of feeds passed to callback; deserialization stops at the first malformed feed.
+ */
+size_t parser_deserialize_typed_feeds_each(parser_t* parser, char* buffer, size_t buffer_size,
+                                           typed_feed_callback_t callback, void* context);
 
-bool parser_serialize_sync_parameters(parser_t* parser, const char* device_key, parameter_t* parameters,
-                                      size_t number_of_parameters, outbound_message_t* outbound_message);
+bool parser_serialize_feed_registration(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                        outbound_message_t* outbound_message);
 
-bool parser_serialize_sync_time(parser_t* parser, const char* device_key, outbound_message_t* outbound_message);
-bool parser_serialize_details_synchronization(parser_t* parser, const char* device_key,
-                                              outbound_message_t* outbound_message);
+bool parser_serialize_feed_removal(parser_t* parser, feed_registration_t* feed, size_t number_of_feeds,
+                                   outbound_message_t* outbound_message);
+bool parser_serialize_pull_feed_values(parser_t* parser, outbound_message_t* outbound_message);
 
-bool parser_serialize_attribute(parser_t* parser, const char* device_key, attribute_t* attributes,
-                                size_t number_of_attributes, outbound_message_t* outbound_message);
+bool parser_serialize_pull_parameters(parser_t* parser, outbound_message_t* outbound_message);
 
-bool parser_serialize_parameter(parser_t* parser, const char* device_key, parameter_t* parameter,
-                                size_t number_of_parameters, outbound_message_t* outbound_message);
+bool parser_serialize_sync_parameters(parser_t* parser, parameter_t* parameters, size_t number_of_parameters,
+                                      outbound_message_t* outbound_message);
+
+bool parser_serialize_sync_time(parser_t* parser, outbound_message_t* outbound_message);
+bool parser_serialize_details_synchronization(parser_t* parser, outbound_message_t* outbound_message);
+
+bool parser_serialize_attribute(parser_t* parser, attribute_t* attributes, size_t number_of_attributes,
+                                outbound_message_t* outbound_message);
+
+bool parser_serialize_parameter(parser_t* parser, parameter_t* parameter, size_t number_of_parameters,
+                                outbound_message_t* outbound_message);
 /**** Utility ****/
 
 #ifdef __cplusplus
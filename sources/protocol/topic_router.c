@@ -0,0 +1,121 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/topic_router.h"
+#include "utility/wolk_utils.h"
+
+#include <string.h>
+
+static int compare_message_type(const topic_route_t* route, const char* message_type, size_t message_type_length)
+{
+    const size_t length =
+        route->message_type_length < message_type_length ? route->message_type_length : message_type_length;
+
+    const int result = memcmp(route->message_type, message_type, length);
+    if (result != 0) {
+        return result;
+    }
+
+    if (route->message_type_length == message_type_length) {
+        return 0;
+    }
+
+    return route->message_type_length < message_type_length ? -1 : 1;
+}
+
+/* Returns index of the route with given message type, or index at which it should be inserted */
+static size_t lower_bound(const topic_router_t* router, const char* message_type, size_t message_type_length)
+{
+    size_t low = 0;
+    size_t high = router->number_of_routes;
+
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+
+        if (compare_message_type(&router->routes[middle], message_type, message_type_length) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+void topic_router_init(topic_router_t* router, const char* prefix)
+{
+    /* Sanity check */
+    WOLK_ASSERT(router);
+    WOLK_ASSERT(strlen(prefix) < TOPIC_SIZE);
+
+    strcpy(router->prefix, prefix);
+    router->prefix_length = strlen(prefix);
+    router->number_of_routes = 0;
+}
+
+bool topic_router_add(topic_router_t* router, const char* message_type, topic_handler_t handler, void* context)
+{
+    /* Sanity check */
+    WOLK_ASSERT(router);
+    WOLK_ASSERT(handler);
+
+    const size_t message_type_length = strlen(message_type);
+    if (message_type_length >= TOPIC_MESSAGE_TYPE_SIZE) {
+        return false;
+    }
+
+    const size_t index = lower_bound(router, message_type, message_type_length);
+    topic_route_t* route = &router->routes[index];
+
+    if (index == router->number_of_routes
+        || compare_message_type(route, message_type, message_type_length) != 0) {
+        if (router->number_of_routes == TOPIC_ROUTES_MAX) {
+            return false;
+        }
+
+        memmove(route + 1, route, (router->number_of_routes - index) * sizeof(*route));
+        router->number_of_routes++;
+
+        strcpy(route->message_type, message_type);
+        route->message_type_length = message_type_length;
+    }
+
+    route->handler = handler;
+    route->context = context;
+
+    return true;
+}
+
+const topic_route_t* topic_router_find(const topic_router_t* router, const char* topic, size_t topic_length)
+{
+    /* Sanity check */
+    WOLK_ASSERT(router);
+
+    if (topic_length <= router->prefix_length || memcmp(topic, router->prefix, router->prefix_length) != 0) {
+        return NULL;
+    }
+
+    const char* message_type = topic + router->prefix_length;
+    const size_t message_type_length = topic_length - router->prefix_length;
+
+    const size_t index = lower_bound(router, message_type, message_type_length);
+    if (index == router->number_of_routes
+        || compare_message_type(&router->routes[index], message_type, message_type_length) != 0) {
+        return NULL;
+    }
+
+    return &router->routes[index];
+}
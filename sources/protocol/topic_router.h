@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+
+#include "size_definitions.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Handles payload of inbound message. 'context' is the one given when handler was added.
+ */
+typedef void (*topic_handler_t)(void* context, char* payload, size_t payload_length);
+
+typedef struct {
+    char message_type[TOPIC_MESSAGE_TYPE_SIZE];
+    size_t message_type_length;
+
+    topic_handler_t handler;
+    void* context;
+} topic_route_t;
+
+/**
+ * Maps inbound topics of form '<prefix><message type>' to their handlers.
+ *
+ * Prefix is compared once, and the message type is looked up by binary search in routes kept sorted by message type.
+ */
+typedef struct {
+    char prefix[TOPIC_SIZE];
+    size_t prefix_length;
+
+    topic_route_t routes[TOPIC_ROUTES_MAX];
+    size_t number_of_routes;
+} topic_router_t;
+
+void topic_router_init(topic_router_t* router, const char* prefix);
+
+/**
+ * Adds handler for 'message_type', replacing the existing one. Returns false if there is no room for another route.
+ */
+bool topic_router_add(topic_router_t* router, const char* message_type, topic_handler_t handler, void* context);
+
+/**
+ * Returns route of topic which is not NULL terminated, or NULL if topic has no handler.
+ */
+const topic_route_t* topic_router_find(const topic_router_t* router, const char* topic, size_t topic_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -49,6 +49,8 @@ enum {
 
     /* Maximum number of characters in reference string */
     REFERENCE_SIZE = 64,
+    /* Maximum number of characters in serialized key of interned feed reference */
+    FEED_KEY_SIZE = 2 * REFERENCE_SIZE,
     /* Maximum number of characters in name string */
     ITEM_NAME_SIZE = 64,
     /* Maximum number of characters in unit string */
@@ -76,10 +78,30 @@ enum {
     FILE_MANAGEMENT_HASH_SIZE = 32,
     /* Size of the chunks read from file during verification phase. Don't change it */
     FILE_MANAGEMENT_VERIFICATION_CHUNK_SIZE = 1024,
+    /* Maximum number of chunks requested ahead of the one being written */
+    FILE_MANAGEMENT_WINDOW_MAX = 16,
 
     /* Maximum number of characters in firmware update version */
     FIRMWARE_UPDATE_VERSION_SIZE = 16,
 
+    /* Maximum number of characters in persistence directory path */
+    PERSISTENCE_PATH_SIZE = 256,
+
+    /* Maximum number of inbound message types with a handler */
+    TOPIC_ROUTES_MAX = 24,
+    /* Maximum number of topics subscribed to by a single SUBSCRIBE packet */
+    SUBSCRIPTION_TOPICS_MAX = 15,
+    /* Maximum number of outbound topics which persisted messages refer to by ID */
+    OUTBOUND_TOPICS_MAX = 24,
+    /* Size of queue of connector's own messages waiting for packet in progress, fits at least one full payload */
+    CONTROL_QUEUE_SIZE = 2 * PAYLOAD_SIZE,
+
+    /* Maximum number of numeric feeds with fixed number of decimals */
+    NUMERIC_FEED_PRECISIONS_MAX = 8,
+
+    /* Maximum number of feeds aggregated over windows */
+    FEED_AGGREGATIONS_MAX = 16,
+
     /* Number of batches in which data will be published */
     PUBLISH_BATCH_SIZE = 50,
 };
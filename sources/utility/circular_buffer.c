@@ -162,19 +162,33 @@ uint32_t circular_buffer_pop_array(circular_buffer_t* buffer, uint32_t length, v
 {
     uint32_t read;
 
-    if (!buffer) {
+    if (!buffer || buffer->empty) {
         return 0;
     }
 
-    read = 0;
-    unsigned char* elements_array_position = elements_array ? (unsigned char*)elements_array : NULL;
-    while ((read < length) && circular_buffer_pop(buffer, elements_array_position)) {
-        read++;
-        if (elements_array_position) {
-            elements_array_position += buffer->element_size;
+    if (elements_array) {
+        read = circular_buffer_peek_array(buffer, 0, length, elements_array);
+    } else {
+        read = circular_buffer_size(buffer);
+        if (length < read) {
+            read = length;
         }
     }
 
+    if (read == 0) {
+        return 0;
+    }
+
+    buffer->head += read;
+    if (buffer->head >= buffer->storage_size) {
+        buffer->head -= buffer->storage_size;
+    }
+
+    /* it is for sure not full any more since we removed something */
+    buffer->full = false;
+    /* might be empty */
+    buffer->empty = (buffer->tail == buffer->head);
+
     return read;
 }
 
@@ -201,41 +215,61 @@ uint32_t circular_buffer_drop_from_end(circular_buffer_t* buffer, uint32_t numbe
 
 bool circular_buffer_peek(circular_buffer_t* buffer, uint32_t element_position, void* element)
 {
-    if (!buffer || !element) {
+    if (!element) {
         return false;
     }
 
-    if (buffer->empty || (element_position >= circular_buffer_size(buffer))) {
+    const void* source = circular_buffer_peek_pointer(buffer, element_position);
+    if (!source) {
         return false;
     }
 
-    if (buffer->head + element_position < buffer->storage_size) {
-        copy_bytes(element, 0, buffer->storage, buffer->head + element_position, buffer->element_size);
-    } else {
-        copy_bytes(element, 0, buffer->storage, buffer->head + element_position - buffer->storage_size,
-                   buffer->element_size);
+    memcpy(element, source, buffer->element_size);
+    return true;
+}
+
+void* circular_buffer_peek_pointer(circular_buffer_t* buffer, uint32_t element_position)
+{
+    if (!buffer || buffer->empty || (element_position >= circular_buffer_size(buffer))) {
+        return NULL;
     }
 
-    return true;
+    uint32_t position = buffer->head + element_position;
+    if (position >= buffer->storage_size) {
+        position -= buffer->storage_size;
+    }
+
+    return (unsigned char*)buffer->storage + (size_t)position * buffer->element_size;
 }
 
 uint32_t circular_buffer_peek_array(circular_buffer_t* buffer, uint32_t element_position, uint32_t length,
                                     void* elements_array)
 {
-    uint32_t read;
-
     if (!buffer || !elements_array) {
-        return false;
+        return 0;
+    }
+
+    const uint32_t size = circular_buffer_size(buffer);
+    if (element_position >= size) {
+        return 0;
     }
 
-    read = 0;
-    unsigned char* elements_array_position = (unsigned char*)elements_array;
-    while ((read < length)
-           && circular_buffer_peek(buffer, element_position + read,
-                                   elements_array_position + read * buffer->element_size)) {
-        read++;
+    const uint32_t read = (length < (size - element_position)) ? length : (size - element_position);
+
+    uint32_t start = buffer->head + element_position;
+    if (start >= buffer->storage_size) {
+        start -= buffer->storage_size;
     }
 
+    /* Requested elements wrap around the end of storage in at most two segments */
+    const uint32_t first_segment = (read < (buffer->storage_size - start)) ? read : (buffer->storage_size - start);
+
+    unsigned char* destination = (unsigned char*)elements_array;
+    const unsigned char* storage = (const unsigned char*)buffer->storage;
+    memcpy(destination, storage + (size_t)start * buffer->element_size, (size_t)first_segment * buffer->element_size);
+    memcpy(destination + (size_t)first_segment * buffer->element_size, storage,
+           (size_t)(read - first_segment) * buffer->element_size);
+
     return read;
 }
 
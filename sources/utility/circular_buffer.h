@@ -58,6 +58,11 @@ uint32_t circular_buffer_drop_from_end(circular_buffer_t* buffer, uint32_t numbe
 
 bool circular_buffer_peek(circular_buffer_t* buffer, uint32_t element_position, void* element);
 
+/**
+ * Returns pointer to element in storage, or NULL if there is no element at 'element_position'.
+ */
+void* circular_buffer_peek_pointer(circular_buffer_t* buffer, uint32_t element_position);
+
 uint32_t circular_buffer_peek_array(circular_buffer_t* buffer, uint32_t element_position, uint32_t length,
                                     void* elements_array);
 
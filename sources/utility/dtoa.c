@@ -0,0 +1,475 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utility/dtoa.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Grisu2 as described in "Printing Floating-Point Numbers Quickly and Accurately with Integers" by Florian Loitsch.
+ * Output always reads back to the same double and is the shortest one for all but a small fraction of values, for
+ * which it is one digit longer.
+ */
+
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define DP_HIDDEN_BIT 0x0010000000000000ULL
+#define DP_EXPONENT_MASK 0x7FF0000000000000ULL
+#define DP_SIGN_MASK 0x8000000000000000ULL
+#define DP_EXPONENT_BIAS (0x3FF + 52)
+#define DP_SIGNIFICAND_SIZE 52
+
+/* Value f * 2^e */
+typedef struct {
+    uint64_t f;
+    int e;
+} diy_fp_t;
+
+/* Normalized 10^k, k = -348 + 8 * index */
+static const diy_fp_t cached_powers[] = {
+    {0xFA8FD5A0081C0288ULL, -1220}, /* 1e-348 */
+    {0xBAAEE17FA23EBF76ULL, -1193}, /* 1e-340 */
+    {0x8B16FB203055AC76ULL, -1166}, /* 1e-332 */
+    {0xCF42894A5DCE35EAULL, -1140}, /* 1e-324 */
+    {0x9A6BB0AA55653B2DULL, -1113}, /* 1e-316 */
+    {0xE61ACF033D1A45DFULL, -1087}, /* 1e-308 */
+    {0xAB70FE17C79AC6CAULL, -1060}, /* 1e-300 */
+    {0xFF77B1FCBEBCDC4FULL, -1034}, /* 1e-292 */
+    {0xBE5691EF416BD60CULL, -1007}, /* 1e-284 */
+    {0x8DD01FAD907FFC3CULL, -980}, /* 1e-276 */
+    {0xD3515C2831559A83ULL, -954}, /* 1e-268 */
+    {0x9D71AC8FADA6C9B5ULL, -927}, /* 1e-260 */
+    {0xEA9C227723EE8BCBULL, -901}, /* 1e-252 */
+    {0xAECC49914078536DULL, -874}, /* 1e-244 */
+    {0x823C12795DB6CE57ULL, -847}, /* 1e-236 */
+    {0xC21094364DFB5637ULL, -821}, /* 1e-228 */
+    {0x9096EA6F3848984FULL, -794}, /* 1e-220 */
+    {0xD77485CB25823AC7ULL, -768}, /* 1e-212 */
+    {0xA086CFCD97BF97F4ULL, -741}, /* 1e-204 */
+    {0xEF340A98172AACE5ULL, -715}, /* 1e-196 */
+    {0xB23867FB2A35B28EULL, -688}, /* 1e-188 */
+    {0x84C8D4DFD2C63F3BULL, -661}, /* 1e-180 */
+    {0xC5DD44271AD3CDBAULL, -635}, /* 1e-172 */
+    {0x936B9FCEBB25C996ULL, -608}, /* 1e-164 */
+    {0xDBAC6C247D62A584ULL, -582}, /* 1e-156 */
+    {0xA3AB66580D5FDAF6ULL, -555}, /* 1e-148 */
+    {0xF3E2F893DEC3F126ULL, -529}, /* 1e-140 */
+    {0xB5B5ADA8AAFF80B8ULL, -502}, /* 1e-132 */
+    {0x87625F056C7C4A8BULL, -475}, /* 1e-124 */
+    {0xC9BCFF6034C13053ULL, -449}, /* 1e-116 */
+    {0x964E858C91BA2655ULL, -422}, /* 1e-108 */
+    {0xDFF9772470297EBDULL, -396}, /* 1e-100 */
+    {0xA6DFBD9FB8E5B88FULL, -369}, /* 1e-92 */
+    {0xF8A95FCF88747D94ULL, -343}, /* 1e-84 */
+    {0xB94470938FA89BCFULL, -316}, /* 1e-76 */
+    {0x8A08F0F8BF0F156BULL, -289}, /* 1e-68 */
+    {0xCDB02555653131B6ULL, -263}, /* 1e-60 */
+    {0x993FE2C6D07B7FACULL, -236}, /* 1e-52 */
+    {0xE45C10C42A2B3B06ULL, -210}, /* 1e-44 */
+    {0xAA242499697392D3ULL, -183}, /* 1e-36 */
+    {0xFD87B5F28300CA0EULL, -157}, /* 1e-28 */
+    {0xBCE5086492111AEBULL, -130}, /* 1e-20 */
+    {0x8CBCCC096F5088CCULL, -103}, /* 1e-12 */
+    {0xD1B71758E219652CULL, -77}, /* 1e-4 */
+    {0x9C40000000000000ULL, -50}, /* 1e4 */
+    {0xE8D4A51000000000ULL, -24}, /* 1e12 */
+    {0xAD78EBC5AC620000ULL, 3}, /* 1e20 */
+    {0x813F3978F8940984ULL, 30}, /* 1e28 */
+    {0xC097CE7BC90715B3ULL, 56}, /* 1e36 */
+    {0x8F7E32CE7BEA5C70ULL, 83}, /* 1e44 */
+    {0xD5D238A4ABE98068ULL, 109}, /* 1e52 */
+    {0x9F4F2726179A2245ULL, 136}, /* 1e60 */
+    {0xED63A231D4C4FB27ULL, 162}, /* 1e68 */
+    {0xB0DE65388CC8ADA8ULL, 189}, /* 1e76 */
+    {0x83C7088E1AAB65DBULL, 216}, /* 1e84 */
+    {0xC45D1DF942711D9AULL, 242}, /* 1e92 */
+    {0x924D692CA61BE758ULL, 269}, /* 1e100 */
+    {0xDA01EE641A708DEAULL, 295}, /* 1e108 */
+    {0xA26DA3999AEF774AULL, 322}, /* 1e116 */
+    {0xF209787BB47D6B85ULL, 348}, /* 1e124 */
+    {0xB454E4A179DD1877ULL, 375}, /* 1e132 */
+    {0x865B86925B9BC5C2ULL, 402}, /* 1e140 */
+    {0xC83553C5C8965D3DULL, 428}, /* 1e148 */
+    {0x952AB45CFA97A0B3ULL, 455}, /* 1e156 */
+    {0xDE469FBD99A05FE3ULL, 481}, /* 1e164 */
+    {0xA59BC234DB398C25ULL, 508}, /* 1e172 */
+    {0xF6C69A72A3989F5CULL, 534}, /* 1e180 */
+    {0xB7DCBF5354E9BECEULL, 561}, /* 1e188 */
+    {0x88FCF317F22241E2ULL, 588}, /* 1e196 */
+    {0xCC20CE9BD35C78A5ULL, 614}, /* 1e204 */
+    {0x98165AF37B2153DFULL, 641}, /* 1e212 */
+    {0xE2A0B5DC971F303AULL, 667}, /* 1e220 */
+    {0xA8D9D1535CE3B396ULL, 694}, /* 1e228 */
+    {0xFB9B7CD9A4A7443CULL, 720}, /* 1e236 */
+    {0xBB764C4CA7A44410ULL, 747}, /* 1e244 */
+    {0x8BAB8EEFB6409C1AULL, 774}, /* 1e252 */
+    {0xD01FEF10A657842CULL, 800}, /* 1e260 */
+    {0x9B10A4E5E9913129ULL, 827}, /* 1e268 */
+    {0xE7109BFBA19C0C9DULL, 853}, /* 1e276 */
+    {0xAC2820D9623BF429ULL, 880}, /* 1e284 */
+    {0x80444B5E7AA7CF85ULL, 907}, /* 1e292 */
+    {0xBF21E44003ACDD2DULL, 933}, /* 1e300 */
+    {0x8E679C2F5E44FF8FULL, 960}, /* 1e308 */
+    {0xD433179D9C8CB841ULL, 986}, /* 1e316 */
+    {0x9E19DB92B4E31BA9ULL, 1013}, /* 1e324 */
+    {0xEB96BF6EBADF77D9ULL, 1039}, /* 1e332 */
+    {0xAF87023B9BF0EE6BULL, 1066}, /* 1e340 */
+};
+
+static const uint32_t pow10_32[] = {1,      10,      100,      1000,      10000,
+                                    100000, 1000000, 10000000, 100000000, 1000000000};
+
+static diy_fp_t diy_fp_from_bits(uint64_t bits)
+{
+    const uint64_t significand = bits & DP_SIGNIFICAND_MASK;
+    const int biased_exponent = (int)((bits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+
+    diy_fp_t fp;
+    if (biased_exponent != 0) {
+        fp.f = significand + DP_HIDDEN_BIT;
+        fp.e = biased_exponent - DP_EXPONENT_BIAS;
+    } else {
+        /* Subnormal */
+        fp.f = significand;
+        fp.e = 1 - DP_EXPONENT_BIAS;
+    }
+
+    return fp;
+}
+
+static diy_fp_t diy_fp_multiply(diy_fp_t x, diy_fp_t y)
+{
+    const uint64_t mask = 0xFFFFFFFFULL;
+
+    const uint64_t a = x.f >> 32;
+    const uint64_t b = x.f & mask;
+    const uint64_t c = y.f >> 32;
+    const uint64_t d = y.f & mask;
+
+    const uint64_t ac = a * c;
+    const uint64_t bc = b * c;
+    const uint64_t ad = a * d;
+    const uint64_t bd = b * d;
+
+    /* Round the lower half */
+    const uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+
+    diy_fp_t result;
+    result.f = ac + (ad >> 32) + (bc >> 32) + (middle >> 32);
+    result.e = x.e + y.e + 64;
+    return result;
+}
+
+static diy_fp_t diy_fp_normalize(diy_fp_t fp)
+{
+    while (!(fp.f & DP_SIGN_MASK)) {
+        fp.f <<= 1;
+        fp.e--;
+    }
+
+    return fp;
+}
+
+/* Boundaries of the interval of values which round to 'fp', normalized to the same exponent */
+static void normalized_boundaries(diy_fp_t fp, diy_fp_t* minus, diy_fp_t* plus)
+{
+    diy_fp_t upper = {(fp.f << 1) + 1, fp.e - 1};
+    upper = diy_fp_normalize(upper);
+
+    diy_fp_t lower;
+    if (fp.f == DP_HIDDEN_BIT) {
+        /* Lower neighbour is closer when significand is a power of two */
+        lower.f = (fp.f << 2) - 1;
+        lower.e = fp.e - 2;
+    } else {
+        lower.f = (fp.f << 1) - 1;
+        lower.e = fp.e - 1;
+    }
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+
+    *minus = lower;
+    *plus = upper;
+}
+
+/* Cached power which brings binary exponent 'e' in range [-60, -32], stores its decimal exponent negated to 'k' */
+static diy_fp_t cached_power(int e, int* k)
+{
+    /* ceil((-61 - e) * log10(2)) + 347, always positive in the range of double */
+    const double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (dk - ik > 0.0) {
+        ik++;
+    }
+
+    const unsigned int index = (unsigned int)((ik >> 3) + 1);
+    *k = -(-348 + (int)(index << 3));
+    return cached_powers[index];
+}
+
+static int count_decimal_digits(uint32_t n)
+{
+    int digits = 1;
+    while (digits < 10 && n >= pow10_32[digits]) {
+        digits++;
+    }
+
+    return digits;
+}
+
+/* Moves last digit towards the exact value while it stays within the safe interval */
+static void grisu_round(char* buffer, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa
+           && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int digit_gen(diy_fp_t w, diy_fp_t mp, uint64_t delta, char* buffer, int* k)
+{
+    const int shift = -mp.e;
+    const uint64_t one = 1ULL << shift;
+    const uint64_t wp_w = mp.f - w.f;
+
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+
+    int kappa = count_decimal_digits(p1);
+    int length = 0;
+
+    /* Integral part */
+    while (kappa > 0) {
+        const uint32_t divisor = pow10_32[kappa - 1];
+        const uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+
+        if (digit || length) {
+            buffer[length++] = (char)('0' + digit);
+        }
+        kappa--;
+
+        const uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, length, delta, rest, (uint64_t)pow10_32[kappa] << shift, wp_w);
+            return length;
+        }
+    }
+
+    /* Fractional part */
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+
+        const uint32_t digit = (uint32_t)(p2 >> shift);
+        if (digit || length) {
+            buffer[length++] = (char)('0' + digit);
+        }
+        p2 &= one - 1;
+        kappa--;
+
+        if (p2 < delta) {
+            *k += kappa;
+            const int index = -kappa;
+            grisu_round(buffer, length, delta, p2, one, index < 10 ? wp_w * pow10_32[index] : 0);
+            return length;
+        }
+    }
+}
+
+/* Writes significant digits of positive finite 'bits' to 'buffer', value is digits * 10^k */
+static int grisu2(uint64_t bits, char* buffer, int* k)
+{
+    const diy_fp_t v = diy_fp_from_bits(bits);
+
+    diy_fp_t w_minus;
+    diy_fp_t w_plus;
+    normalized_boundaries(v, &w_minus, &w_plus);
+
+    const diy_fp_t c_mk = cached_power(w_plus.e, k);
+    const diy_fp_t w = diy_fp_multiply(diy_fp_normalize(v), c_mk);
+    diy_fp_t wp = diy_fp_multiply(w_plus, c_mk);
+    diy_fp_t wm = diy_fp_multiply(w_minus, c_mk);
+
+    /* Account for imprecision of the multiplication */
+    wm.f++;
+    wp.f--;
+
+    return digit_gen(w, wp, wp.f - wm.f, buffer, k);
+}
+
+static int write_exponent(int exponent, char* buffer)
+{
+    int length = 0;
+
+    if (exponent < 0) {
+        buffer[length++] = '-';
+        exponent = -exponent;
+    }
+
+    if (exponent >= 100) {
+        buffer[length++] = (char)('0' + exponent / 100);
+        exponent %= 100;
+        buffer[length++] = (char)('0' + exponent / 10);
+    } else if (exponent >= 10) {
+        buffer[length++] = (char)('0' + exponent / 10);
+    }
+    buffer[length++] = (char)('0' + exponent % 10);
+
+    return length;
+}
+
+/* Lays out 'length' digits with decimal exponent 'k' as a plain or exponent form number */
+static int prettify(char* buffer, int length, int k)
+{
+    /* 10^(point - 1) <= value < 10^point */
+    const int point = length + k;
+
+    if (k >= 0 && point <= 21) {
+        /* 1234e7 -> 12340000000 */
+        memset(buffer + length, '0', (size_t)k);
+        return point;
+    }
+
+    if (point > 0 && point <= 21) {
+        /* 1234e-2 -> 12.34 */
+        memmove(buffer + point + 1, buffer + point, (size_t)(length - point));
+        buffer[point] = '.';
+        return length + 1;
+    }
+
+    if (point > -6 && point <= 0) {
+        /* 1234e-6 -> 0.001234 */
+        const int offset = 2 - point;
+        memmove(buffer + offset, buffer, (size_t)length);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        memset(buffer + 2, '0', (size_t)(offset - 2));
+        return length + offset;
+    }
+
+    if (length == 1) {
+        /* 1e30 */
+        buffer[1] = 'e';
+        return 2 + write_exponent(point - 1, buffer + 2);
+    }
+
+    /* 1234e30 -> 1.234e33 */
+    memmove(buffer + 2, buffer + 1, (size_t)(length - 1));
+    buffer[1] = '.';
+    buffer[length + 1] = 'e';
+    return length + 2 + write_exponent(point - 1, buffer + length + 2);
+}
+
+size_t dtoa_shortest(double value, char* buffer)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    char* position = buffer;
+
+    if ((bits & DP_EXPONENT_MASK) == DP_EXPONENT_MASK) {
+        if (bits & DP_SIGNIFICAND_MASK) {
+            strcpy(buffer, "nan");
+            return 3;
+        }
+
+        strcpy(buffer, (bits & DP_SIGN_MASK) ? "-inf" : "inf");
+        return strlen(buffer);
+    }
+
+    if (bits & DP_SIGN_MASK) {
+        *position++ = '-';
+        bits &= ~DP_SIGN_MASK;
+    }
+
+    if (bits == 0) {
+        *position++ = '0';
+        *position = '\0';
+        return (size_t)(position - buffer);
+    }
+
+    int k = 0;
+    const int length = grisu2(bits, position, &k);
+    position += prettify(position, length, k);
+    *position = '\0';
+
+    return (size_t)(position - buffer);
+}
+
+size_t dtoa_fixed(double value, uint8_t decimals, char* buffer)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if ((bits & DP_EXPONENT_MASK) == DP_EXPONENT_MASK || (bits & ~DP_SIGN_MASK) == 0
+        || decimals > DTOA_FIXED_DECIMALS_MAX) {
+        return dtoa_shortest(value, buffer);
+    }
+
+    char* position = buffer;
+    if (bits & DP_SIGN_MASK) {
+        *position++ = '-';
+        bits &= ~DP_SIGN_MASK;
+    }
+
+    /* Digits are written after a spare one, taken by the carry of rounding up */
+    char* digits = position + 1;
+    int k = 0;
+    int length = grisu2(bits, digits, &k);
+    int point = length + k;
+
+    const int kept = point + decimals;
+    if (kept < length) {
+        const bool round_up = kept >= 0 && digits[kept] >= '5';
+        length = kept > 0 ? kept : 0;
+
+        if (round_up) {
+            int i = length - 1;
+            while (i >= 0 && digits[i] == '9') {
+                i--;
+            }
+
+            if (i >= 0) {
+                digits[i]++;
+                length = i + 1;
+            } else {
+                /* 9.96 -> 10.0 */
+                *--digits = '1';
+                length = 1;
+                point++;
+            }
+        }
+    }
+
+    while (length > 0 && digits[length - 1] == '0') {
+        length--;
+    }
+
+    if (length == 0) {
+        /* Rounded to zero, which is written without sign */
+        strcpy(buffer, "0");
+        return 1;
+    }
+
+    memmove(position, digits, (size_t)length);
+    position += prettify(position, length, point - length);
+    *position = '\0';
+
+    return (size_t)(position - buffer);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DTOA_H
+#define DTOA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    /* Size of buffer which holds any formatted value, including terminating null character */
+    DTOA_BUFFER_SIZE = 32,
+    /* Maximum number of decimals accepted by dtoa_fixed() */
+    DTOA_FIXED_DECIMALS_MAX = 15
+};
+
+/**
+ * Writes the shortest decimal representation of 'value' which reads back to exactly the same double, using the
+ * Grisu2 algorithm. Integral values are written without fraction ("42"), very large and very small values in
+ * exponent form ("1.5e-7"), non-finite values as "nan", "inf" and "-inf".
+ *
+ * 'buffer' has to hold DTOA_BUFFER_SIZE characters. Returns the number of characters written, not counting the
+ * terminating null character.
+ */
+size_t dtoa_shortest(double value, char* buffer);
+
+/**
+ * Writes 'value' rounded half up to at most 'decimals' digits after the decimal point, trailing zeros of the fraction
+ * are omitted. Rounding is applied to the shortest representation, so 0.15 is written as "0.2" with one decimal even
+ * though the nearest double is slightly below 0.15.
+ *
+ * 'buffer' has to hold DTOA_BUFFER_SIZE characters. Returns the number of characters written, not counting the
+ * terminating null character.
+ */
+size_t dtoa_fixed(double value, uint8_t decimals, char* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
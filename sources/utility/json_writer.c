@@ -0,0 +1,165 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utility/json_writer.h"
+#include "utility/wolk_utils.h"
+
+#include <string.h>
+
+/* Longest decimal representation of 64-bit integer, with sign */
+#define NUMBER_DIGITS_SIZE 20
+
+static void append(json_writer_t* writer, const char* text, size_t length)
+{
+    if (writer->overflow || length >= writer->capacity - writer->length) {
+        writer->overflow = true;
+        return;
+    }
+
+    memcpy(writer->buffer + writer->length, text, length);
+    writer->length += length;
+    writer->buffer[writer->length] = '\0';
+}
+
+void json_writer_init(json_writer_t* writer, char* buffer, size_t capacity)
+{
+    /* Sanity check */
+    WOLK_ASSERT(writer);
+    WOLK_ASSERT(buffer);
+    WOLK_ASSERT(capacity > 0);
+
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->length = 0;
+    writer->overflow = false;
+
+    buffer[0] = '\0';
+}
+
+void json_writer_raw(json_writer_t* writer, const char* text)
+{
+    append(writer, text, strlen(text));
+}
+
+void json_writer_raw_length(json_writer_t* writer, const char* text, size_t length)
+{
+    append(writer, text, length);
+}
+
+void json_writer_escaped(json_writer_t* writer, const char* text)
+{
+    json_writer_escaped_length(writer, text, strlen(text));
+}
+
+void json_writer_escaped_length(json_writer_t* writer, const char* text, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char* const end = text + length;
+    const char* run = text;
+
+    for (; text != end; ++text) {
+        const unsigned char character = (unsigned char)*text;
+        if (character != '"' && character != '\\' && character >= 0x20) {
+            continue;
+        }
+
+        /* Copy characters which need no escaping at once */
+        append(writer, run, (size_t)(text - run));
+        run = text + 1;
+
+        char escape[6] = {'\\', (char)character, 0, 0, 0, 0};
+        size_t escape_length = 2;
+        switch (character) {
+        case '"':
+        case '\\':
+            break;
+        case '\n':
+            escape[1] = 'n';
+            break;
+        case '\r':
+            escape[1] = 'r';
+            break;
+        case '\t':
+            escape[1] = 't';
+            break;
+        default:
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hex[character >> 4];
+            escape[5] = hex[character & 0x0F];
+            escape_length = sizeof(escape);
+            break;
+        }
+        append(writer, escape, escape_length);
+    }
+
+    append(writer, run, (size_t)(text - run));
+}
+
+void json_writer_string(json_writer_t* writer, const char* text)
+{
+    append(writer, "\"", 1);
+    json_writer_escaped(writer, text);
+    append(writer, "\"", 1);
+}
+
+void json_writer_key(json_writer_t* writer, const char* key)
+{
+    json_writer_string(writer, key);
+    append(writer, ":", 1);
+}
+
+void json_writer_uint64(json_writer_t* writer, uint64_t value)
+{
+    char digits[NUMBER_DIGITS_SIZE];
+    size_t position = sizeof(digits);
+
+    do {
+        digits[--position] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+
+    append(writer, digits + position, sizeof(digits) - position);
+}
+
+void json_writer_int64(json_writer_t* writer, int64_t value)
+{
+    if (value < 0) {
+        append(writer, "-", 1);
+        json_writer_uint64(writer, (uint64_t)0 - (uint64_t)value);
+        return;
+    }
+
+    json_writer_uint64(writer, (uint64_t)value);
+}
+
+void json_writer_separator(json_writer_t* writer, size_t index)
+{
+    if (index != 0) {
+        append(writer, ",", 1);
+    }
+}
+
+bool json_writer_ok(const json_writer_t* writer)
+{
+    return !writer->overflow;
+}
+
+size_t json_writer_length(const json_writer_t* writer)
+{
+    return writer->length;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Appends JSON text to a fixed size buffer in a single forward pass.
+ *
+ * Buffer is kept NULL terminated after every call. Once text does not fit, writer stops writing and
+ * json_writer_ok() returns false, so serializers can append everything and check for overflow once at the end.
+ */
+typedef struct {
+    char* buffer;
+    size_t capacity;
+    size_t length;
+
+    bool overflow;
+} json_writer_t;
+
+void json_writer_init(json_writer_t* writer, char* buffer, size_t capacity);
+
+/* Appends text as it is, used for structural characters, keys and numeric values */
+void json_writer_raw(json_writer_t* writer, const char* text);
+
+/* Same as json_writer_raw(), for 'length' characters of text */
+void json_writer_raw_length(json_writer_t* writer, const char* text, size_t length);
+
+/* Appends text escaped for use inside JSON string, without surrounding quotes */
+void json_writer_escaped(json_writer_t* writer, const char* text);
+
+/* Same as json_writer_escaped(), for 'length' characters of text which does not have to be NULL terminated */
+void json_writer_escaped_length(json_writer_t* writer, const char* text, size_t length);
+
+/* Appends quoted and escaped JSON string */
+void json_writer_string(json_writer_t* writer, const char* text);
+
+/* Appends '"key":' */
+void json_writer_key(json_writer_t* writer, const char* key);
+
+void json_writer_uint64(json_writer_t* writer, uint64_t value);
+
+void json_writer_int64(json_writer_t* writer, int64_t value);
+
+/* Appends ',' unless this is the first element of an array or object */
+void json_writer_separator(json_writer_t* writer, size_t index);
+
+bool json_writer_ok(const json_writer_t* writer);
+
+size_t json_writer_length(const json_writer_t* writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,21 +16,19 @@
 
 /****************************** MACROS ******************************/
 #define MD5_BLOCK_SIZE 32   // MD5 outputs a 32 byte digest
-typedef unsigned char BYTE; // 8-bit byte
-typedef unsigned int WORD;  // 32-bit word, change to "long" for 16-bit machines
 
 /**************************** DATA TYPES ****************************/
 
 typedef struct {
-    BYTE data[64];
-    WORD datalen;
+    uint8_t data[64];
+    uint32_t datalen;
     unsigned long long bitlen;
-    WORD state[4];
+    uint32_t state[4];
 } MD5_CTX;
 
 /*********************** FUNCTION DECLARATIONS **********************/
 void md5_init(MD5_CTX* ctx);
-void md5_update(MD5_CTX* ctx, const BYTE data[], size_t len);
-void md5_final(MD5_CTX* ctx, BYTE hash[]);
+void md5_update(MD5_CTX* ctx, const uint8_t data[], size_t len);
+void md5_final(MD5_CTX* ctx, uint8_t hash[]);
 
 #endif // WOLKCONNECTOR_C_MD5_H
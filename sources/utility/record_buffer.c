@@ -0,0 +1,187 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utility/record_buffer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Written instead of record length when the rest of the storage is skipped */
+#define WRAP_MARKER 0xFFFFFFFFu
+
+static uint32_t read_length(const record_buffer_t* buffer, uint32_t position)
+{
+    uint32_t length;
+    memcpy(&length, buffer->storage + position, sizeof(length));
+    return length;
+}
+
+static void write_length(record_buffer_t* buffer, uint32_t position, uint32_t length)
+{
+    memcpy(buffer->storage + position, &length, sizeof(length));
+}
+
+static uint32_t head_position(const record_buffer_t* buffer)
+{
+    /* Rest of the storage was too short for the record which follows, it continues at the beginning */
+    if ((buffer->storage_size - buffer->head) < RECORD_BUFFER_HEADER_SIZE
+        || read_length(buffer, buffer->head) == WRAP_MARKER) {
+        return 0;
+    }
+
+    return buffer->head;
+}
+
+static bool find_free_position(record_buffer_t* buffer, uint32_t required, uint32_t* position)
+{
+    if (buffer->count == 0) {
+        buffer->head = 0;
+        buffer->tail = 0;
+
+        *position = 0;
+        return required <= buffer->storage_size;
+    }
+
+    if (buffer->tail > buffer->head) {
+        if ((buffer->storage_size - buffer->tail) >= required) {
+            *position = buffer->tail;
+            return true;
+        }
+
+        if (buffer->head >= required) {
+            if ((buffer->storage_size - buffer->tail) >= RECORD_BUFFER_HEADER_SIZE) {
+                write_length(buffer, buffer->tail, WRAP_MARKER);
+            }
+
+            *position = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    if ((buffer->head - buffer->tail) >= required) {
+        *position = buffer->tail;
+        return true;
+    }
+
+    return false;
+}
+
+void record_buffer_init(record_buffer_t* buffer, void* storage, uint32_t storage_size, bool wrap)
+{
+    buffer->storage = (uint8_t*)storage;
+    buffer->storage_size = storage_size;
+    buffer->wrap = wrap;
+    buffer->popped = 0;
+
+    record_buffer_clear(buffer);
+}
+
+uint8_t* record_buffer_allocate(record_buffer_t* buffer, uint32_t length)
+{
+    uint32_t position;
+
+    if (!buffer || buffer->storage_size < RECORD_BUFFER_HEADER_SIZE
+        || length > (buffer->storage_size - RECORD_BUFFER_HEADER_SIZE)) {
+        return NULL;
+    }
+
+    const uint32_t required = RECORD_BUFFER_HEADER_SIZE + length;
+    while (!find_free_position(buffer, required, &position)) {
+        if (!buffer->wrap) {
+            return NULL;
+        }
+
+        /* Discard the oldest record and try again */
+        record_buffer_pop(buffer);
+    }
+
+    write_length(buffer, position, length);
+
+    buffer->tail = position + required;
+    if (buffer->tail == buffer->storage_size) {
+        buffer->tail = 0;
+    }
+    buffer->count++;
+
+    return buffer->storage + position + RECORD_BUFFER_HEADER_SIZE;
+}
+
+uint8_t* record_buffer_peek(record_buffer_t* buffer, uint32_t* length)
+{
+    if (!buffer || buffer->count == 0) {
+        return NULL;
+    }
+
+    const uint32_t position = head_position(buffer);
+    if (length) {
+        *length = read_length(buffer, position);
+    }
+
+    return buffer->storage + position + RECORD_BUFFER_HEADER_SIZE;
+}
+
+bool record_buffer_pop(record_buffer_t* buffer)
+{
+    if (!buffer || buffer->count == 0) {
+        return false;
+    }
+
+    const uint32_t position = head_position(buffer);
+    buffer->head = position + RECORD_BUFFER_HEADER_SIZE + read_length(buffer, position);
+    if (buffer->head == buffer->storage_size) {
+        buffer->head = 0;
+    }
+
+    buffer->count--;
+    buffer->popped++;
+    if (buffer->count == 0) {
+        buffer->head = 0;
+        buffer->tail = 0;
+    }
+
+    return true;
+}
+
+bool record_buffer_empty(record_buffer_t* buffer)
+{
+    if (!buffer) {
+        return true;
+    }
+
+    return buffer->count == 0;
+}
+
+uint32_t record_buffer_size(record_buffer_t* buffer)
+{
+    if (!buffer) {
+        return 0;
+    }
+
+    return buffer->count;
+}
+
+void record_buffer_clear(record_buffer_t* buffer)
+{
+    if (buffer) {
+        buffer->popped += buffer->count;
+        buffer->head = 0;
+        buffer->tail = 0;
+        buffer->count = 0;
+    }
+}
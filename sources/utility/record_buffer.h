@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RECORD_BUFFER_H
+#define RECORD_BUFFER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Ring of variable-length records packed back-to-back.
+ *
+ * Every record is prefixed by its length and is always stored contiguously; when a record does not fit at the end of
+ * the storage, the remainder is skipped and the record is placed at the beginning.
+ */
+typedef struct {
+    uint8_t* storage;
+    uint32_t storage_size;
+
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+
+    /* Number of records ever removed from the head, including records discarded to make room */
+    uint32_t popped;
+
+    bool wrap;
+} record_buffer_t;
+
+enum {
+    /* Number of bytes used for length prefix of every record */
+    RECORD_BUFFER_HEADER_SIZE = sizeof(uint32_t)
+};
+
+void record_buffer_init(record_buffer_t* buffer, void* storage, uint32_t storage_size, bool wrap);
+
+/**
+ * Reserves contiguous space for record of 'length' bytes and returns pointer to it, or NULL if record can not be
+ * stored. If buffer is full and wraps, the oldest records are discarded to make room.
+ */
+uint8_t* record_buffer_allocate(record_buffer_t* buffer, uint32_t length);
+
+/**
+ * Returns pointer to the oldest record, and stores its length to 'length', or NULL if buffer is empty.
+ */
+uint8_t* record_buffer_peek(record_buffer_t* buffer, uint32_t* length);
+
+bool record_buffer_pop(record_buffer_t* buffer);
+
+bool record_buffer_empty(record_buffer_t* buffer);
+
+uint32_t record_buffer_size(record_buffer_t* buffer);
+
+void record_buffer_clear(record_buffer_t* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
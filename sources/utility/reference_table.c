@@ -0,0 +1,157 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "utility/reference_table.h"
+#include "size_definitions.h"
+#include "utility/wolk_utils.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+static uint32_t hash(const char* reference)
+{
+    /* FNV-1a */
+    uint32_t value = 2166136261u;
+    while (*reference) {
+        value = (value ^ (uint8_t)*reference++) * 16777619u;
+    }
+
+    return value;
+}
+
+static char* slot(const reference_table_t* table, size_t index)
+{
+    return (char*)(table->entries + index * table->entry_size);
+}
+
+static size_t home_index(const reference_table_t* table, const char* reference)
+{
+    return hash(reference) % table->capacity;
+}
+
+void reference_table_init(reference_table_t* table, void* storage, size_t entry_size, size_t capacity)
+{
+    /* Sanity check */
+    WOLK_ASSERT(entry_size >= REFERENCE_SIZE);
+    WOLK_ASSERT(storage != NULL || capacity == 0);
+
+    table->entries = (uint8_t*)storage;
+    table->entry_size = entry_size;
+    table->capacity = capacity;
+    table->count = 0;
+
+    if (storage) {
+        memset(storage, 0, entry_size * capacity);
+    }
+}
+
+void* reference_table_find(const reference_table_t* table, const char* reference)
+{
+    if (table->count == 0) {
+        return NULL;
+    }
+
+    size_t index = home_index(table, reference);
+    for (size_t i = 0; i < table->capacity; ++i) {
+        char* entry = slot(table, index);
+        if (entry[0] == '\0') {
+            return NULL;
+        }
+
+        if (strcmp(entry, reference) == 0) {
+            return entry;
+        }
+
+        index = (index + 1) % table->capacity;
+    }
+
+    return NULL;
+}
+
+void* reference_table_insert(reference_table_t* table, const char* reference)
+{
+    /* Sanity check */
+    WOLK_ASSERT(reference[0] != '\0');
+    WOLK_ASSERT(strlen(reference) < REFERENCE_SIZE);
+
+    if (table->capacity == 0) {
+        return NULL;
+    }
+
+    size_t index = home_index(table, reference);
+    for (size_t i = 0; i < table->capacity; ++i) {
+        char* entry = slot(table, index);
+        if (entry[0] == '\0') {
+            memset(entry, 0, table->entry_size);
+            strcpy(entry, reference);
+            table->count++;
+            return entry;
+        }
+
+        if (strcmp(entry, reference) == 0) {
+            return entry;
+        }
+
+        index = (index + 1) % table->capacity;
+    }
+
+    return NULL;
+}
+
+void reference_table_remove(reference_table_t* table, void* entry)
+{
+    size_t free_index = reference_table_index(table, entry);
+    size_t index = free_index;
+
+    slot(table, free_index)[0] = '\0';
+    table->count--;
+
+    /* Entries which were probed past the freed slot are moved back, so that lookups do not stop at it */
+    for (size_t i = 1; i < table->capacity; ++i) {
+        index = (index + 1) % table->capacity;
+
+        char* next = slot(table, index);
+        if (next[0] == '\0') {
+            break;
+        }
+
+        /* Entry stays if its home slot lies cyclically within (free_index, index] */
+        const size_t home = home_index(table, next);
+        const bool stays = free_index <= index ? (free_index < home && home <= index)
+                                               : (free_index < home || home <= index);
+        if (stays) {
+            continue;
+        }
+
+        memcpy(slot(table, free_index), next, table->entry_size);
+        next[0] = '\0';
+        free_index = index;
+    }
+}
+
+void* reference_table_at(const reference_table_t* table, size_t index)
+{
+    char* entry = slot(table, index);
+    return entry[0] != '\0' ? entry : NULL;
+}
+
+size_t reference_table_index(const reference_table_t* table, const void* entry)
+{
+    return (size_t)((const uint8_t*)entry - table->entries) / table->entry_size;
+}
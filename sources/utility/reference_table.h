@@ -0,0 +1,75 @@
+/*
+ * Copyright 2022 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef REFERENCE_TABLE_H
+#define REFERENCE_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hash table of entries keyed by feed reference, kept in storage given to reference_table_init.
+ *
+ * Every entry starts with 'char reference[REFERENCE_SIZE]', slot whose reference is empty is free. Entries are placed
+ * by hash of their reference and probed linearly, so lookup compares only references with colliding hashes. Entry
+ * keeps its slot until it, or an entry before it, is removed.
+ */
+typedef struct {
+    uint8_t* entries;
+    size_t entry_size;
+    size_t capacity;
+    size_t count;
+} reference_table_t;
+
+/**
+ * Clears 'capacity' entries of 'entry_size' bytes in 'storage'. 'storage' can be NULL if 'capacity' is 0.
+ */
+void reference_table_init(reference_table_t* table, void* storage, size_t entry_size, size_t capacity);
+
+/**
+ * Returns entry of 'reference', or NULL if there is none.
+ */
+void* reference_table_find(const reference_table_t* table, const char* reference);
+
+/**
+ * Returns entry of 'reference', adding cleared entry with 'reference' copied to it if there is none, or NULL if table
+ * is full. 'reference' has to be shorter than REFERENCE_SIZE.
+ */
+void* reference_table_insert(reference_table_t* table, const char* reference);
+
+/**
+ * Removes 'entry'. Entries which follow it can be moved, so pointers to entries are invalidated.
+ */
+void reference_table_remove(reference_table_t* table, void* entry);
+
+/**
+ * Returns entry in slot 'index', or NULL if slot is free.
+ */
+void* reference_table_at(const reference_table_t* table, size_t index);
+
+size_t reference_table_index(const reference_table_t* table, const void* entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
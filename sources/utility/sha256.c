@@ -16,8 +16,17 @@
  *   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 #include "sha256.h"
+
+#include <string.h>
+
 /* #define MINIMIZE_STACK_IMPACT */
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SHA256_SHA_NI_SUPPORTED
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -83,7 +92,7 @@ FN_ uint32_t _G1(uint32_t x)
     return (_r(x, 17) ^ _r(x, 19) ^ (x >> 10));
 }
 
-FN_ uint32_t _word(uint8_t* c)
+FN_ uint32_t _word(const uint8_t* c)
 {
     return (_shw(c[0], 24) | _shw(c[1], 16) | _shw(c[2], 8) | (c[3]));
 }
@@ -95,7 +104,10 @@ FN_ void _addbits(sha256_context* ctx, uint32_t n)
     ctx->bits[0] = (ctx->bits[0] + n) & 0xFFFFFFFF;
 }
 
-static void _hash(sha256_context* ctx)
+/* Processes 'blocks' consecutive 64 byte blocks */
+typedef void (*sha256_transform_t)(uint32_t hash[8], const uint8_t* data, size_t blocks);
+
+static void _hash(uint32_t hash[8], const uint8_t* block)
 {
     register uint32_t a, b, c, d, e, f, g, h, i;
     uint32_t t[2];
@@ -103,18 +115,18 @@ static void _hash(sha256_context* ctx)
     uint32_t W[64];
 #endif
 
-    a = ctx->hash[0];
-    b = ctx->hash[1];
-    c = ctx->hash[2];
-    d = ctx->hash[3];
-    e = ctx->hash[4];
-    f = ctx->hash[5];
-    g = ctx->hash[6];
-    h = ctx->hash[7];
+    a = hash[0];
+    b = hash[1];
+    c = hash[2];
+    d = hash[3];
+    e = hash[4];
+    f = hash[5];
+    g = hash[6];
+    h = hash[7];
 
     for (i = 0; i < 64; i++) {
         if (i < 16)
-            W[i] = _word(&ctx->buf[_shw(i, 2)]);
+            W[i] = _word(&block[_shw(i, 2)]);
         else
             W[i] = _G1(W[i - 2]) + W[i - 7] + _G0(W[i - 15]) + W[i - 16];
 
@@ -130,14 +142,121 @@ static void _hash(sha256_context* ctx)
         a = t[0] + t[1];
     }
 
-    ctx->hash[0] += a;
-    ctx->hash[1] += b;
-    ctx->hash[2] += c;
-    ctx->hash[3] += d;
-    ctx->hash[4] += e;
-    ctx->hash[5] += f;
-    ctx->hash[6] += g;
-    ctx->hash[7] += h;
+    hash[0] += a;
+    hash[1] += b;
+    hash[2] += c;
+    hash[3] += d;
+    hash[4] += e;
+    hash[5] += f;
+    hash[6] += g;
+    hash[7] += h;
+}
+
+static void _transform_portable(uint32_t hash[8], const uint8_t* data, size_t blocks)
+{
+    for (; blocks > 0; blocks--, data += 64)
+        _hash(hash, data);
+}
+
+#ifdef SHA256_SHA_NI_SUPPORTED
+/* Based on Intel SHA Extensions reference, state is kept as ABEF and CDGH halves */
+__attribute__((target("sha,sse4.1,ssse3"))) static void _transform_sha_ni(uint32_t hash[8], const uint8_t* data,
+                                                                          size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, msg, tmp, abef, cdgh;
+    __m128i m[4];
+    uint32_t n;
+
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&hash[0]), 0xB1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&hash[4]), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks > 0; blocks--, data += 64) {
+        abef = state0;
+        cdgh = state1;
+
+        for (n = 0; n < 4; n++)
+            m[n] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * n)), mask);
+
+        /* Four rounds per iteration, message schedule in place over last four words groups */
+        for (n = 0; n < 16; n++) {
+            if (n >= 4) {
+                tmp = _mm_sha256msg1_epu32(m[n & 3], m[(n + 1) & 3]);
+                tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(m[(n + 3) & 3], m[(n + 2) & 3], 4));
+                m[n & 3] = _mm_sha256msg2_epu32(tmp, m[(n + 3) & 3]);
+            }
+
+            msg = _mm_add_epi32(m[n & 3], _mm_loadu_si128((const __m128i*)&K[4 * n]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i*)&hash[0], state0);
+    _mm_storeu_si128((__m128i*)&hash[4], state1);
+}
+
+static bool _has_sha_ni(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+        return false;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (ebx & bit_SHA) != 0;
+}
+#endif
+
+static sha256_transform_t _transform = _transform_portable;
+static sha256_implementation_t _implementation = SHA256_IMPLEMENTATION_PORTABLE;
+
+bool sha256_set_implementation(sha256_implementation_t implementation)
+{
+    switch (implementation) {
+    case SHA256_IMPLEMENTATION_PORTABLE:
+        _transform = _transform_portable;
+        break;
+
+#ifdef SHA256_SHA_NI_SUPPORTED
+    case SHA256_IMPLEMENTATION_SHA_NI:
+        if (!_has_sha_ni())
+            return false;
+        _transform = _transform_sha_ni;
+        break;
+#endif
+
+    default:
+        return false;
+    }
+
+    _implementation = implementation;
+    return true;
+}
+
+sha256_implementation_t sha256_select_implementation(void)
+{
+    if (!sha256_set_implementation(SHA256_IMPLEMENTATION_SHA_NI))
+        sha256_set_implementation(SHA256_IMPLEMENTATION_PORTABLE);
+
+    return _implementation;
+}
+
+sha256_implementation_t sha256_get_implementation(void)
+{
+    return _implementation;
 }
 
 void sha256_init(sha256_context* ctx)
@@ -158,19 +277,41 @@ void sha256_init(sha256_context* ctx)
 
 void sha256_hash(sha256_context* ctx, const void* data, size_t len)
 {
-    register size_t i;
+    register size_t i, n;
     const uint8_t* bytes = (const uint8_t*)data;
 
-    if ((ctx != NULL) && (bytes != NULL))
-        for (i = 0; i < len; i++) {
-            ctx->buf[ctx->len] = bytes[i];
-            ctx->len++;
-            if (ctx->len == sizeof(ctx->buf)) {
-                _hash(ctx);
-                _addbits(ctx, sizeof(ctx->buf) * 8);
-                ctx->len = 0;
-            }
-        }
+    if ((ctx == NULL) || (bytes == NULL))
+        return;
+
+    /* Complete partially filled block first */
+    if (ctx->len > 0) {
+        n = sizeof(ctx->buf) - ctx->len;
+        n = (len < n) ? len : n;
+        memcpy(&ctx->buf[ctx->len], bytes, n);
+        ctx->len += (uint32_t)n;
+        bytes += n;
+        len -= n;
+
+        if (ctx->len < sizeof(ctx->buf))
+            return;
+
+        _transform(ctx->hash, ctx->buf, 1);
+        _addbits(ctx, sizeof(ctx->buf) * 8);
+        ctx->len = 0;
+    }
+
+    /* Whole blocks are hashed in place */
+    n = len / sizeof(ctx->buf);
+    if (n > 0) {
+        _transform(ctx->hash, bytes, n);
+        for (i = 0; i < n; i++)
+            _addbits(ctx, sizeof(ctx->buf) * 8);
+        bytes += n * sizeof(ctx->buf);
+        len -= n * sizeof(ctx->buf);
+    }
+
+    memcpy(ctx->buf, bytes, len);
+    ctx->len = (uint32_t)len;
 }
 
 void sha256_done(sha256_context* ctx, uint8_t* hash)
@@ -184,7 +325,7 @@ void sha256_done(sha256_context* ctx, uint8_t* hash)
             ctx->buf[i] = 0x00;
 
         if (ctx->len > 55) {
-            _hash(ctx);
+            _transform(ctx->hash, ctx->buf, 1);
             for (j = 0; j < sizeof(ctx->buf); j++)
                 ctx->buf[j] = 0x00;
         }
@@ -198,7 +339,7 @@ void sha256_done(sha256_context* ctx, uint8_t* hash)
         ctx->buf[58] = _shb(ctx->bits[1], 8);
         ctx->buf[57] = _shb(ctx->bits[1], 16);
         ctx->buf[56] = _shb(ctx->bits[1], 24);
-        _hash(ctx);
+        _transform(ctx->hash, ctx->buf, 1);
 
         if (hash != NULL)
             for (i = 0, j = 24; i < 4; i++, j -= 8) {
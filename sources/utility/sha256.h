@@ -19,6 +19,7 @@
 #ifndef SHA256_H
 #define SHA256_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #ifdef _MSC_VER
 #ifndef uint8_t
@@ -42,6 +43,18 @@ typedef struct {
     uint32_t len;
 } sha256_context;
 
+typedef enum {
+    SHA256_IMPLEMENTATION_PORTABLE = 0,
+    /* x86 SHA extensions */
+    SHA256_IMPLEMENTATION_SHA_NI
+} sha256_implementation_t;
+
+/* Selects the fastest implementation supported by the CPU, portable one is used until it is called */
+sha256_implementation_t sha256_select_implementation(void);
+/* Returns false if the implementation is not supported by the compiler or CPU */
+bool sha256_set_implementation(sha256_implementation_t implementation);
+sha256_implementation_t sha256_get_implementation(void);
+
 void sha256_init(sha256_context* ctx);
 void sha256_hash(sha256_context* ctx, const void* data, size_t len);
 void sha256_done(sha256_context* ctx, uint8_t* hash);
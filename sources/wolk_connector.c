@@ -21,9 +21,12 @@
 #include "model/firmware_update.h"
 #include "model/outbound_message.h"
 #include "model/outbound_message_factory.h"
+#include "persistence/in_memory_packed_persistence.h"
 #include "persistence/in_memory_persistence.h"
+#include "persistence/mmap_log_persistence.h"
 #include "persistence/persistence.h"
 #include "protocol/parser.h"
+#include "utility/dtoa.h"
 #include "utility/wolk_utils.h"
 
 #include <stdbool.h>
@@ -32,15 +35,75 @@
 
 #define MQTT_KEEP_ALIVE_INTERVAL 60 // Unit: s
 
+/* Reference values are added to, with settings which apply to it */
+typedef struct {
+    const char* reference;
+    const char* key; /* Serialized reference of interned feed, NULL otherwise */
+    size_t key_length;
+    int8_t decimals;
+    feed_filter_t* filter;
+    feed_aggregation_t* aggregation;
+} feed_settings_t;
+
 static WOLK_ERR_T mqtt_keep_alive(wolk_ctx_t* ctx, uint64_t tick);
 
 static WOLK_ERR_T receive(wolk_ctx_t* ctx);
 
 static WOLK_ERR_T publish(wolk_ctx_t* ctx, outbound_message_t* outbound_message);
-static WOLK_ERR_T subscribe(wolk_ctx_t* ctx, const char* topic);
+static int publish_view(wolk_ctx_t* ctx, const outbound_message_view_t* view, outbound_packet_t type);
+static int subscribe(wolk_ctx_t* ctx, char topics[][TOPIC_SIZE], const size_t* topic_lengths, int number_of_topics);
+
+static int start_outbound_packet(wolk_ctx_t* ctx, int length, outbound_packet_t type);
+static int continue_outbound_packet(wolk_ctx_t* ctx);
+static int continue_outbound(wolk_ctx_t* ctx);
+static bool is_persisted_packet_head(wolk_ctx_t* ctx);
+static WOLK_ERR_T finish_outbound_packet(wolk_ctx_t* ctx);
 
 static bool is_wolk_initialized(wolk_ctx_t* ctx);
 
+static numeric_feed_precision_t* find_numeric_feed_precision(wolk_ctx_t* ctx, const char* reference);
+static feed_filter_t* find_feed_filter(wolk_ctx_t* ctx, const char* reference);
+static feed_aggregation_t* find_feed_aggregation(wolk_ctx_t* ctx, const char* reference);
+static void find_feed_settings(wolk_ctx_t* ctx, const char* reference, feed_settings_t* settings);
+static WOLK_ERR_T interned_feed_settings(wolk_ctx_t* ctx, wolk_feed_handle_t handle, feed_settings_t* settings);
+static void apply_feed_settings(const feed_settings_t* settings, typed_feed_t* feed);
+static bool is_valid_feed_time(const feed_settings_t* settings, uint64_t utc_time, size_t number_of_feeds);
+static WOLK_ERR_T add_string_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_string_feeds_t* feeds,
+                                   size_t number_of_feeds);
+static WOLK_ERR_T add_numeric_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_numeric_feeds_t* feeds,
+                                    size_t number_of_feeds);
+static WOLK_ERR_T add_multi_value_numeric_feed(wolk_ctx_t* ctx, const feed_settings_t* settings, double* values,
+                                               uint16_t value_size, uint64_t utc_time);
+static WOLK_ERR_T add_bool_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_boolean_feeds_t* feeds,
+                                 size_t number_of_feeds);
+static bool accept_typed_feed(wolk_ctx_t* ctx, feed_filter_t* filter, const typed_feed_t* feed);
+static bool is_aggregated(const feed_settings_t* settings, const typed_feed_t* feed);
+static WOLK_ERR_T aggregate_typed_feed(wolk_ctx_t* ctx, const feed_settings_t* settings, const typed_feed_t* feed,
+                                       wolk_feed_batch_t* batch);
+static WOLK_ERR_T push_aggregated_reading(wolk_ctx_t* ctx, const feed_settings_t* settings, typed_feed_t* reading,
+                                          wolk_feed_batch_t* batch);
+static WOLK_ERR_T close_feed_aggregations(wolk_ctx_t* ctx, bool force);
+static WOLK_ERR_T push_typed_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, typed_feed_t* feeds,
+                                   size_t number_of_feeds);
+static WOLK_ERR_T store_typed_feeds(wolk_ctx_t* ctx, const typed_feed_t* feeds, size_t number_of_feeds);
+static WOLK_ERR_T feed_batch_add(wolk_feed_batch_t* batch, const feed_settings_t* settings, typed_feed_t* feed);
+static WOLK_ERR_T feed_batch_append(wolk_feed_batch_t* batch, const typed_feed_t* feed);
+
+static bool store_outbound_message(void* context, outbound_message_t* outbound_message);
+static bool publish_outbound_message(void* context, outbound_message_t* outbound_message);
+static bool serialize_feed_registration(parser_t* parser, void* items, size_t number_of_items,
+                                        outbound_message_t* outbound_message);
+static bool serialize_feed_removal(parser_t* parser, void* items, size_t number_of_items,
+                                   outbound_message_t* outbound_message);
+static bool serialize_parameters(parser_t* parser, void* items, size_t number_of_items,
+                                 outbound_message_t* outbound_message);
+static bool serialize_synchronize_parameters(parser_t* parser, void* items, size_t number_of_items,
+                                             outbound_message_t* outbound_message);
+static bool serialize_attributes(parser_t* parser, void* items, size_t number_of_items,
+                                 outbound_message_t* outbound_message);
+static bool serialize_file_list(parser_t* parser, void* items, size_t number_of_items,
+                                outbound_message_t* outbound_message);
+
 static void handle_feeds(wolk_ctx_t* ctx, feed_t* feeds, size_t number_of_feeds);
 static void handle_parameter_message(wolk_ctx_t* ctx, parameter_t* parameter_message, size_t number_of_parameters);
 static void handle_utc_command(wolk_ctx_t* ctx, utc_command_t* utc);
@@ -73,7 +136,26 @@ static void listener_firmware_update_on_verification(firmware_update_t* firmware
 static void handle_firmware_update_installation(firmware_update_t* firmware_update, firmware_update_t* parameter);
 static void handle_firmware_update_abort(firmware_update_t* firmware_update);
 
-static WOLK_ERR_T subscribe_to(wolk_ctx_t* ctx, char message_type[TOPIC_MESSAGE_TYPE_SIZE]);
+static int subscribe_next(wolk_ctx_t* ctx);
+
+static void register_topic_handlers(wolk_ctx_t* ctx);
+
+static void receive_feed_values(void* context, char* payload, size_t payload_length);
+static void receive_feed_values_array(wolk_ctx_t* ctx, char* payload, size_t payload_length);
+static void receive_parameters(void* context, char* payload, size_t payload_length);
+static void receive_parameters_array(wolk_ctx_t* ctx, char* payload, size_t payload_length);
+static void receive_time(void* context, char* payload, size_t payload_length);
+static void receive_error(void* context, char* payload, size_t payload_length);
+static void receive_details_synchronization(void* context, char* payload, size_t payload_length);
+static void receive_file_upload_initiate(void* context, char* payload, size_t payload_length);
+static void receive_file_binary_response(void* context, char* payload, size_t payload_length);
+static void receive_file_abort(void* context, char* payload, size_t payload_length);
+static void receive_file_url_download_initiate(void* context, char* payload, size_t payload_length);
+static void receive_file_list(void* context, char* payload, size_t payload_length);
+static void receive_file_delete(void* context, char* payload, size_t payload_length);
+static void receive_file_purge(void* context, char* payload, size_t payload_length);
+static void receive_firmware_update_install(void* context, char* payload, size_t payload_length);
+static void receive_firmware_update_abort(void* context, char* payload, size_t payload_length);
 
 WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func, const char* device_key,
                      const char* device_password, outbound_mode_t outbound_mode, feed_handler_t feed_handler,
@@ -81,9 +163,6 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
                      details_synchronization_handler_t details_synchronization_handler)
 {
     /* Sanity check */
-    WOLK_ASSERT(snd_func != NULL);
-    WOLK_ASSERT(rcv_func != NULL);
-
     WOLK_ASSERT(device_key != NULL);
     WOLK_ASSERT(device_password != NULL);
 
@@ -94,20 +173,23 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
 
     MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
     ctx->connectData = connectData;
-    ctx->sock = 0;
 
-    ctx->iof.send = snd_func;
-    ctx->iof.recv = rcv_func;
+    transmission_io_functions_t io_functions = {0};
+    io_functions.send = snd_func;
+    io_functions.recv = rcv_func;
 
-    ctx->sock = transmission_open(&ctx->iof);
-    if (ctx->sock < 0) {
+    if (transmission_open(&ctx->transmission, &io_functions) < 0) {
         return W_TRUE;
     }
+    ctx->outbound_packet_type = OUTBOUND_PACKET_NONE;
+    ctx->outbound_persisted_id = 0;
+    ctx->is_subscribing = false;
+    ctx->next_subscription = 0;
 
     strcpy(&ctx->device_key[0], device_key);
     strcpy(&ctx->device_password[0], device_password);
 
-    ctx->mqtt_transport.sck = &ctx->sock;
+    ctx->mqtt_transport.sck = &ctx->transmission;
     ctx->mqtt_transport.getfn = transmission_get_data_nb;
     ctx->mqtt_transport.state = 0;
     ctx->connectData.clientID.cstring = &ctx->device_key[0];
@@ -118,11 +200,28 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
 
     ctx->feed_handler = feed_handler;
     ctx->parameter_handler = parameter_handler;
+    ctx->feed_item_handler = NULL;
+    ctx->typed_feed_item_handler = NULL;
+    ctx->parameter_item_handler = NULL;
     ctx->details_synchronization_handler = details_synchronization_handler;
+    reference_table_init(&ctx->numeric_feed_precisions, ctx->numeric_feed_precision_storage,
+                         sizeof(numeric_feed_precision_t), NUMERIC_FEED_PRECISIONS_MAX);
+    reference_table_init(&ctx->feed_filters, NULL, sizeof(feed_filter_t), 0);
+    reference_table_init(&ctx->feed_aggregations, ctx->feed_aggregation_storage, sizeof(feed_aggregation_t),
+                         FEED_AGGREGATIONS_MAX);
+    reference_table_init(&ctx->interned_feeds, NULL, sizeof(interned_feed_t), 0);
+    ctx->feed_settings_generation = 0;
+    ctx->uptime = 0;
 
     ctx->outbound_mode = outbound_mode;
 
     parser_init(&ctx->parser);
+    parser_init_topics(&ctx->parser, ctx->device_key);
+    register_topic_handlers(ctx);
+
+    in_memory_packed_persistence_init(&ctx->control_queue, ctx->control_queue_storage,
+                                      sizeof(ctx->control_queue_storage), false);
+    in_memory_packed_persistence_set_topics(&ctx->control_queue, &ctx->parser.outbound_topics);
 
     ctx->utc = 0;
 
@@ -132,19 +231,100 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
     return W_FALSE;
 }
 
+WOLK_ERR_T wolk_init_transport_context(wolk_ctx_t* ctx, void* context, send_with_context_func_t snd_func,
+                                       recv_with_context_func_t rcv_func)
+{
+    /* Sanity check */
+    WOLK_ASSERT(snd_func != NULL);
+    WOLK_ASSERT(rcv_func != NULL);
+
+    ctx->transmission.io_functions.send_with_context = snd_func;
+    ctx->transmission.io_functions.recv_with_context = rcv_func;
+    ctx->transmission.io_functions.context = context;
+
+    return W_FALSE;
+}
+
 WOLK_ERR_T wolk_init_in_memory_persistence(wolk_ctx_t* ctx, void* storage, uint32_t size, bool wrap)
 {
-    in_memory_persistence_init(storage, size, wrap);
-    persistence_init(&ctx->persistence, in_memory_persistence_push, in_memory_persistence_peek,
-                     in_memory_persistence_pop, in_memory_persistence_is_empty);
+    in_memory_persistence_init(&ctx->persistence_instance.in_memory, storage, size, wrap);
+    persistence_init(&ctx->persistence, &ctx->persistence_instance.in_memory, in_memory_persistence_push,
+                     in_memory_persistence_peek, in_memory_persistence_pop, in_memory_persistence_is_empty);
+    persistence_set_view(&ctx->persistence, in_memory_persistence_peek_view, in_memory_persistence_drop);
+    persistence_set_batch(&ctx->persistence, in_memory_persistence_peek_n, in_memory_persistence_pop_n);
+    persistence_set_head_id(&ctx->persistence, in_memory_persistence_head_id);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_init_in_memory_packed_persistence(wolk_ctx_t* ctx, void* storage, uint32_t size, bool wrap)
+{
+    in_memory_packed_persistence_init(&ctx->persistence_instance.in_memory_packed, storage, size, wrap);
+    in_memory_packed_persistence_set_topics(&ctx->persistence_instance.in_memory_packed, &ctx->parser.outbound_topics);
+    persistence_init(&ctx->persistence, &ctx->persistence_instance.in_memory_packed, in_memory_packed_persistence_push,
+                     in_memory_packed_persistence_peek, in_memory_packed_persistence_pop,
+                     in_memory_packed_persistence_is_empty);
+    persistence_set_view(&ctx->persistence, in_memory_packed_persistence_peek_view,
+                         in_memory_packed_persistence_drop);
+    persistence_set_batch(&ctx->persistence, NULL, in_memory_packed_persistence_pop_n);
+    persistence_set_head_id(&ctx->persistence, in_memory_packed_persistence_head_id);
+
+    return W_FALSE;
+}
+
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+WOLK_ERR_T wolk_init_mmap_log_persistence(wolk_ctx_t* ctx, const char* directory, uint32_t segment_size,
+                                          uint32_t max_segments, bool wrap)
+{
+    if (!mmap_log_persistence_init(&ctx->persistence_instance.mmap_log, directory, segment_size, max_segments, wrap)) {
+        return W_TRUE;
+    }
+
+    persistence_init(&ctx->persistence, &ctx->persistence_instance.mmap_log, mmap_log_persistence_push,
+                     mmap_log_persistence_peek, mmap_log_persistence_pop, mmap_log_persistence_is_empty);
+    persistence_set_view(&ctx->persistence, mmap_log_persistence_peek_view, mmap_log_persistence_drop);
+    persistence_set_head_id(&ctx->persistence, mmap_log_persistence_head_id);
+
+    return W_FALSE;
+}
+#endif
+
+WOLK_ERR_T wolk_init_custom_persistence(wolk_ctx_t* ctx, void* context, persistence_push_t push,
+                                        persistence_peek_t peek, persistence_pop_t pop,
+                                        persistence_is_empty_t is_empty)
+{
+    persistence_init(&ctx->persistence, context, push, peek, pop, is_empty);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_init_custom_persistence_view(wolk_ctx_t* ctx, persistence_peek_view_t peek_view,
+                                             persistence_drop_t drop)
+{
+    /* Sanity check */
+    WOLK_ASSERT(persistence_is_initialized(&ctx->persistence));
+
+    persistence_set_view(&ctx->persistence, peek_view, drop);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_init_custom_persistence_batch(wolk_ctx_t* ctx, persistence_peek_n_t peek_n, persistence_pop_n_t pop_n)
+{
+    /* Sanity check */
+    WOLK_ASSERT(persistence_is_initialized(&ctx->persistence));
+
+    persistence_set_batch(&ctx->persistence, peek_n, pop_n);
 
     return W_FALSE;
 }
 
-WOLK_ERR_T wolk_init_custom_persistence(wolk_ctx_t* ctx, persistence_push_t push, persistence_peek_t peek,
-                                        persistence_pop_t pop, persistence_is_empty_t is_empty)
+WOLK_ERR_T wolk_init_custom_persistence_head_id(wolk_ctx_t* ctx, persistence_head_id_t head_id)
 {
-    persistence_init(&ctx->persistence, push, peek, pop, is_empty);
+    /* Sanity check */
+    WOLK_ASSERT(persistence_is_initialized(&ctx->persistence));
+
+    persistence_set_head_id(&ctx->persistence, head_id);
 
     return W_FALSE;
 }
@@ -175,6 +355,39 @@ WOLK_ERR_T wolk_init_file_management(
     return W_FALSE;
 }
 
+WOLK_ERR_T wolk_set_file_management_window(wolk_ctx_t* ctx, size_t window_size, void* storage, size_t storage_size)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    if (!file_management_set_window(&ctx->file_management, window_size, (uint8_t*)storage, storage_size)) {
+        return W_TRUE;
+    }
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_file_management_read_back_verification(wolk_ctx_t* ctx, bool enabled)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    file_management_set_read_back_verification(&ctx->file_management, enabled);
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_file_management_transfer_persistence(wolk_ctx_t* ctx,
+                                                        file_management_transfer_state_store_t store,
+                                                        file_management_transfer_state_read_t read,
+                                                        file_management_transfer_resume_t resume)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    file_management_set_transfer_state_persistence(&ctx->file_management, store, read, resume);
+    return W_FALSE;
+}
+
 WOLK_ERR_T wolk_init_firmware_update(wolk_ctx_t* ctx, firmware_update_start_installation_t start_installation,
                                      firmware_update_is_installation_completed_t is_installation_completed,
                                      firmware_update_verification_store_t verification_store,
@@ -196,35 +409,32 @@ WOLK_ERR_T wolk_connect(wolk_ctx_t* ctx)
     WOLK_ASSERT(is_wolk_initialized(ctx));
 
     char buf[MQTT_PACKET_SIZE];
-    char topic_buf[TOPIC_SIZE];
-
-    /* Setup and Connect to MQTT */
 
-    int len = MQTTSerialize_connect((unsigned char*)buf, sizeof(buf), &ctx->connectData);
-    if (transmission_buffer(ctx->sock, (unsigned char*)buf, len) == TRANSPORT_DONE) {
+    /* Send and receive functions are given either to wolk_init or to wolk_init_transport_context */
+    const transmission_io_functions_t* io_functions = &ctx->transmission.io_functions;
+    if ((io_functions->send == NULL && io_functions->send_with_context == NULL)
+        || (io_functions->recv == NULL && io_functions->recv_with_context == NULL)) {
         return W_TRUE;
     }
 
-    /* Subscribe to topics */
-    subscribe_to(ctx, ctx->parser.FEED_VALUES_MESSAGE_TOPIC);
-    subscribe_to(ctx, ctx->parser.PARAMETERS_TOPIC);
-    subscribe_to(ctx, ctx->parser.SYNC_TIME_TOPIC);
-    subscribe_to(ctx, ctx->parser.ERROR_TOPIC);
-    subscribe_to(ctx, ctx->parser.DETAILS_SYNCHRONIZATION_TOPIC);
+    /* Packet left unsent on previous connection is dropped, persisted message remains in persistence */
+    ctx->outbound_packet_type = OUTBOUND_PACKET_NONE;
+
+    /* So are control messages, file transfer requests its chunks again once connected */
+    while (in_memory_packed_persistence_drop(&ctx->control_queue)) {
+    }
 
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_UPLOAD_INITIATE_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_BINARY_RESPONSE_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_UPLOAD_ABORT_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_INITIATE_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_ABORT_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_FILE_LIST_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_FILE_DELETE_TOPIC);
-    subscribe_to(ctx, ctx->parser.FILE_MANAGEMENT_FILE_PURGE_TOPIC);
+    /* Setup and Connect to MQTT */
 
-    subscribe_to(ctx, ctx->parser.FIRMWARE_UPDATE_INSTALL_TOPIC);
-    subscribe_to(ctx, ctx->parser.FIRMWARE_UPDATE_ABORT_TOPIC);
+    int len = MQTTSerialize_connect((unsigned char*)buf, sizeof(buf), &ctx->connectData);
+    if (transmission_buffer(&ctx->transmission, (unsigned char*)buf, len) == TRANSPORT_DONE) {
+        return W_TRUE;
+    }
 
-    if (subscribe(ctx, topic_buf) != W_FALSE) {
+    /* Subscriptions are sent as connection accepts them, ahead of any message */
+    ctx->is_subscribing = true;
+    ctx->next_subscription = 0;
+    if (continue_outbound(ctx) == TRANSPORT_ERROR) {
         return W_TRUE;
     }
 
@@ -234,6 +444,8 @@ WOLK_ERR_T wolk_connect(wolk_ctx_t* ctx)
                                                      ctx->file_management.get_file_list(file_list));
     }
 
+    file_management_resume(&ctx->file_management);
+
     if (ctx->firmware_update.is_initialized) {
         listener_firmware_update_on_verification(&ctx->firmware_update);
     }
@@ -248,9 +460,13 @@ WOLK_ERR_T wolk_disconnect(wolk_ctx_t* ctx)
 
     unsigned char buf[MQTT_PACKET_SIZE] = "";
 
+    if (finish_outbound_packet(ctx) != W_FALSE) {
+        return W_TRUE;
+    }
+
     /* disconnect message */
     int length = MQTTSerialize_disconnect(buf, sizeof(buf));
-    if (transmission_buffer(ctx->sock, buf, length) == TRANSPORT_DONE) {
+    if (transmission_buffer(&ctx->transmission, buf, length) == TRANSPORT_DONE) {
         return W_TRUE;
     }
 
@@ -262,6 +478,14 @@ WOLK_ERR_T wolk_process(wolk_ctx_t* ctx, uint64_t tick)
     /* Sanity check */
     WOLK_ASSERT(is_wolk_initialized(ctx));
 
+    ctx->uptime += tick;
+    /* Reading is dropped if it can not be pushed, as values which are not aggregated */
+    close_feed_aggregations(ctx, false);
+
+    if (continue_outbound(ctx) == TRANSPORT_ERROR) {
+        return W_TRUE;
+    }
+
     if (mqtt_keep_alive(ctx, tick) != W_FALSE) {
         return W_TRUE;
     }
@@ -291,30 +515,11 @@ WOLK_ERR_T wolk_add_string_feed(wolk_ctx_t* ctx, const char* reference, wolk_str
     WOLK_ASSERT(is_wolk_initialized(ctx));
     WOLK_ASSERT(is_wolk_initialized(reference));
     WOLK_ASSERT(is_wolk_initialized(feeds));
-    WOLK_ASSERT(is_wolk_initialized(number_of_feeds));
-    WOLK_ASSERT(number_of_feeds > FEEDS_MAX_NUMBER);
-
-    feed_t feed;
-    feed_initialize(&feed, number_of_feeds, reference);
-
-    for (size_t i = 0; i < number_of_feeds; ++i) {
-        if (feeds->utc_time < 1000000000000 && feeds->utc_time != 0) // Unit ms and zero is valid value
-        {
-            printf("Failed UTC attached to feed with reference %s. It has to be in ms!\n", reference);
-            return W_TRUE;
-        }
 
-        feed_set_data_at(&feed, feeds->value, i);
-        feed_set_utc(&feed, feeds->utc_time);
+    feed_settings_t settings;
+    find_feed_settings(ctx, reference, &settings);
 
-        feeds++;
-    }
-
-    outbound_message_t outbound_message = {0};
-    outbound_message_make_from_feeds(&ctx->parser, ctx->device_key, &feed, STRING, number_of_feeds, 1,
-                                     &outbound_message);
-
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return add_string_feeds(ctx, &settings, feeds, number_of_feeds);
 }
 
 WOLK_ERR_T wolk_add_numeric_feed(wolk_ctx_t* ctx, const char* reference, wolk_numeric_feeds_t* feeds,
@@ -324,35 +529,11 @@ WOLK_ERR_T wolk_add_numeric_feed(wolk_ctx_t* ctx, const char* reference, wolk_nu
     WOLK_ASSERT(is_wolk_initialized(ctx));
     WOLK_ASSERT(is_wolk_initialized(reference));
     WOLK_ASSERT(is_wolk_initialized(feeds));
-    WOLK_ASSERT(is_wolk_initialized(number_of_feeds));
-    WOLK_ASSERT(number_of_feeds > FEEDS_MAX_NUMBER);
-
-    char value_string[FEED_ELEMENT_SIZE] = "";
-    feed_t feed;
-    feed_initialize(&feed, number_of_feeds, reference);
-
-    for (size_t i = 0; i < number_of_feeds; ++i) {
-        if (feeds->utc_time < 1000000000000 && feeds->utc_time != 0) // Unit ms and zero is valid value
-        {
-            printf("Failed UTC attached to feed with reference %s. It has to be in ms!\n", reference);
-            return W_TRUE;
-        }
-
-        if (!snprintf(value_string, FEED_ELEMENT_SIZE, "%2f", feeds->value)) {
-            return W_TRUE;
-        }
-
-        feed_set_data_at(&feed, value_string, i);
-        feed_set_utc(&feed, feeds->utc_time);
-
-        feeds++;
-    }
 
-    outbound_message_t outbound_message = {0};
-    outbound_message_make_from_feeds(&ctx->parser, ctx->device_key, &feed, NUMERIC, number_of_feeds, 1,
-                                     &outbound_message);
+    feed_settings_t settings;
+    find_feed_settings(ctx, reference, &settings);
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return add_numeric_feeds(ctx, &settings, feeds, number_of_feeds);
 }
 
 WOLK_ERR_T wolk_add_multi_value_numeric_feed(wolk_ctx_t* ctx, const char* reference, double* values,
@@ -360,31 +541,11 @@ WOLK_ERR_T wolk_add_multi_value_numeric_feed(wolk_ctx_t* ctx, const char* refere
 {
     /* Sanity check */
     WOLK_ASSERT(is_wolk_initialized(ctx));
-    WOLK_ASSERT(value_size > FEEDS_MAX_NUMBER);
-
-    if (utc_time < 1000000000000 && utc_time != 0) // Unit ms and zero is valid value
-    {
-        printf("Failed UTC attached to feeds. It has to be in ms!\n");
-        return W_TRUE;
-    }
 
-    feed_t feed;
-    feed_initialize(&feed, 1, reference); // one feed consisting of N numeric values
-    feed_set_utc(&feed, utc_time);
+    feed_settings_t settings;
+    find_feed_settings(ctx, reference, &settings);
 
-    char value_string_representation[FEED_ELEMENT_SIZE] = "";
-    for (size_t i = 0; i < value_size; ++i) {
-        if (!snprintf(value_string_representation, FEED_ELEMENT_SIZE, "%f", values[i])) {
-            return W_TRUE;
-        }
-
-        feed_set_data_at(&feed, value_string_representation, i);
-    }
-
-    outbound_message_t outbound_message = {0};
-    outbound_message_make_from_feeds(&ctx->parser, ctx->device_key, &feed, VECTOR, 1, value_size, &outbound_message);
-
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return add_multi_value_numeric_feed(ctx, &settings, values, value_size, utc_time);
 }
 
 WOLK_ERR_T wolk_add_bool_feeds(wolk_ctx_t* ctx, const char* reference, wolk_boolean_feeds_t* feeds,
@@ -393,372 +554,1160 @@ WOLK_ERR_T wolk_add_bool_feeds(wolk_ctx_t* ctx, const char* reference, wolk_bool
     /* Sanity check */
     WOLK_ASSERT(is_wolk_initialized(ctx));
 
-    feed_t feed;
-    feed_initialize(&feed, number_of_feeds, reference);
+    feed_settings_t settings;
+    find_feed_settings(ctx, reference, &settings);
 
-    for (size_t i = 0; i < number_of_feeds; ++i) {
-        if (feeds->utc_time < 1000000000000 && feeds->utc_time != 0) // Unit ms and zero is valid value
-        {
-            printf("Failed UTC attached to feed with reference %s. It has to be in ms!\n", reference);
-            return W_TRUE;
-        }
+    return add_bool_feeds(ctx, &settings, feeds, number_of_feeds);
+}
 
-        feed_set_data_at(&feed, BOOL_TO_STR(feeds->value), i);
-        feed_set_utc(&feed, feeds->utc_time);
+WOLK_ERR_T wolk_init_feed_handles(wolk_ctx_t* ctx, interned_feed_t* feeds, size_t number_of_feeds)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(feeds != NULL || number_of_feeds == 0);
 
-        feeds++;
+    if (number_of_feeds > INT16_MAX) {
+        return W_TRUE;
     }
 
-    outbound_message_t outbound_message = {0};
-    outbound_message_make_from_feeds(&ctx->parser, ctx->device_key, &feed, BOOLEAN, number_of_feeds, 1,
-                                     &outbound_message);
+    reference_table_init(&ctx->interned_feeds, feeds, sizeof(interned_feed_t), number_of_feeds);
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return W_FALSE;
 }
 
-
-WOLK_ERR_T wolk_publish(wolk_ctx_t* ctx)
+wolk_feed_handle_t wolk_feed_intern(wolk_ctx_t* ctx, const char* reference)
 {
     /* Sanity check */
     WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(reference != NULL);
 
-    uint16_t i;
-    outbound_message_t outbound_message = {0};
-
-    for (i = 0; i < PUBLISH_BATCH_SIZE; ++i) {
-        if (persistence_is_empty(&ctx->persistence)) {
-            return W_FALSE;
-        }
+    if (reference[0] == '\0' || strlen(reference) >= REFERENCE_SIZE) {
+        return WOLK_FEED_HANDLE_INVALID;
+    }
 
-        if (!persistence_peek(&ctx->persistence, &outbound_message)) {
-            continue;
-        }
+    const size_t number_of_interned_feeds = ctx->interned_feeds.count;
+    interned_feed_t* feed = (interned_feed_t*)reference_table_insert(&ctx->interned_feeds, reference);
+    if (!feed) {
+        return WOLK_FEED_HANDLE_INVALID;
+    }
 
-        if (publish(ctx, &outbound_message) != W_FALSE) {
-            return W_TRUE;
-        }
+    const wolk_feed_handle_t handle = (wolk_feed_handle_t)reference_table_index(&ctx->interned_feeds, feed);
+    if (ctx->interned_feeds.count == number_of_interned_feeds) {
+        /* Already interned */
+        return handle;
+    }
 
-        persistence_pop(&ctx->persistence, &outbound_message);
+    if (!parser_serialize_typed_feed_key(&ctx->parser, reference, feed->key, sizeof(feed->key), &feed->key_length)) {
+        /* Serialized as any other reference */
+        feed->key_length = 0;
     }
+    feed->settings_generation = ctx->feed_settings_generation - 1;
 
-    return W_FALSE;
+    return handle;
 }
 
-WOLK_ERR_T wolk_register_feed(wolk_ctx_t* ctx, feed_registration_t* feeds, size_t number_of_feeds)
+WOLK_ERR_T wolk_add_string_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_string_feeds_t* feeds,
+                                          size_t number_of_feeds)
 {
-    outbound_message_t outbound_message = {0};
-    if (!outbound_message_feed_registration(&ctx->parser, ctx->device_key, feeds, number_of_feeds, &outbound_message))
+    feed_settings_t settings;
+    if (interned_feed_settings(ctx, handle, &settings) != W_FALSE) {
         return W_TRUE;
+    }
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return add_string_feeds(ctx, &settings, feeds, number_of_feeds);
 }
 
-WOLK_ERR_T wolk_remove_feed(wolk_ctx_t* ctx, feed_registration_t* feeds, size_t number_of_feeds)
+WOLK_ERR_T wolk_add_numeric_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_numeric_feeds_t* feeds,
+                                           size_t number_of_feeds)
 {
-    outbound_message_t outbound_message = {0};
-    if (!outbound_message_feed_removal(&ctx->parser, ctx->device_key, feeds, number_of_feeds, &outbound_message))
+    feed_settings_t settings;
+    if (interned_feed_settings(ctx, handle, &settings) != W_FALSE) {
         return W_TRUE;
+    }
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    return add_numeric_feeds(ctx, &settings, feeds, number_of_feeds);
 }
 
-WOLK_ERR_T wolk_pull_feed_values(wolk_ctx_t* ctx)
+WOLK_ERR_T wolk_add_multi_value_numeric_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, double* values,
+                                                       uint16_t value_size, uint64_t utc_time)
 {
-    if (ctx->outbound_mode == PULL) {
-        outbound_message_t outbound_message = {0};
-        outbound_message_pull_feed_values(&ctx->parser, ctx->device_key, &outbound_message);
-
-        return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    feed_settings_t settings;
+    if (interned_feed_settings(ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
     }
 
-    return W_TRUE;
+    return add_multi_value_numeric_feed(ctx, &settings, values, value_size, utc_time);
 }
 
-WOLK_ERR_T wolk_init_parameter(parameter_t* parameter, char* name, char* value)
+WOLK_ERR_T wolk_add_bool_feeds_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_boolean_feeds_t* feeds,
+                                         size_t number_of_feeds)
 {
-    parameter_init(parameter, name, value);
+    feed_settings_t settings;
+    if (interned_feed_settings(ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
+    }
 
-    return W_FALSE;
+    return add_bool_feeds(ctx, &settings, feeds, number_of_feeds);
 }
 
-WOLK_ERR_T wolk_set_value_parameter(parameter_t* parameter, char* value)
+WOLK_ERR_T wolk_feed_batch_begin(wolk_ctx_t* ctx, wolk_feed_batch_t* batch)
 {
-    parameter_set_value(parameter, value);
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(batch != NULL);
+
+    batch->ctx = ctx;
+    batch->number_of_feeds = 0;
+    outbound_message_begin_typed_feeds(&ctx->parser, &batch->message, &batch->length);
 
     return W_FALSE;
 }
 
-WOLK_ERR_T wolk_change_parameter(wolk_ctx_t* ctx, parameter_t* parameter, size_t number_of_parameters)
+WOLK_ERR_T wolk_feed_batch_add_numeric(wolk_feed_batch_t* batch, const char* reference, double value,
+                                       uint64_t utc_time)
 {
-    outbound_message_t outbound_message = {0};
-    outbound_message_update_parameters(&ctx->parser, ctx->device_key, parameter, number_of_parameters,
-                                       &outbound_message);
+    feed_settings_t settings;
+    find_feed_settings(batch->ctx, reference, &settings);
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    typed_feed_t feed;
+    typed_feed_init_numeric(&feed, reference, value, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_pull_parameters(wolk_ctx_t* ctx)
+WOLK_ERR_T wolk_feed_batch_add_multi_value_numeric(wolk_feed_batch_t* batch, const char* reference,
+                                                   const double* values, uint16_t value_size, uint64_t utc_time)
 {
-    if (ctx->outbound_mode == PULL) {
-        outbound_message_t outbound_message = {0};
-        outbound_message_pull_parameters(&ctx->parser, ctx->device_key, &outbound_message);
-
-        return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    if (value_size == 0) {
+        return W_TRUE;
     }
 
-    return W_TRUE;
+    feed_settings_t settings;
+    find_feed_settings(batch->ctx, reference, &settings);
+
+    typed_feed_t feed;
+    typed_feed_init_vector(&feed, reference, values, value_size, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_sync_parameters(wolk_ctx_t* ctx, parameter_t* parameters, size_t number_of_parameters)
+WOLK_ERR_T wolk_feed_batch_add_bool(wolk_feed_batch_t* batch, const char* reference, bool value, uint64_t utc_time)
 {
-    outbound_message_t outbound_message = {0};
-    outbound_message_synchronize_parameters(&ctx->parser, ctx->device_key, parameters, number_of_parameters,
-                                            &outbound_message);
+    feed_settings_t settings;
+    find_feed_settings(batch->ctx, reference, &settings);
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    typed_feed_t feed;
+    typed_feed_init_boolean(&feed, reference, value, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_sync_time_request(wolk_ctx_t* ctx)
+WOLK_ERR_T wolk_feed_batch_add_string(wolk_feed_batch_t* batch, const char* reference, const char* value,
+                                      uint64_t utc_time)
 {
-    outbound_message_t outbound_message = {0};
-    outbound_message_synchronize_time(&ctx->parser, ctx->device_key, &outbound_message);
+    feed_settings_t settings;
+    find_feed_settings(batch->ctx, reference, &settings);
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    typed_feed_t feed;
+    typed_feed_init_string(&feed, reference, value, strlen(value), utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_details_synchronization(wolk_ctx_t* ctx)
+WOLK_ERR_T wolk_feed_batch_add_numeric_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle, double value,
+                                                 uint64_t utc_time)
 {
-    outbound_message_t outbound_message = {0};
-    outbound_message_details_synchronize(&ctx->parser, ctx->device_key, &outbound_message);
+    feed_settings_t settings;
+    if (interned_feed_settings(batch->ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
+    }
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    typed_feed_t feed;
+    typed_feed_init_numeric(&feed, settings.reference, value, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_init_attribute(wolk_attribute_t* attribute, char* name, char* data_type, char* value)
+WOLK_ERR_T wolk_feed_batch_add_multi_value_numeric_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle,
+                                                             const double* values, uint16_t value_size,
+                                                             uint64_t utc_time)
 {
-    attribute_init(attribute, name, data_type, value);
+    feed_settings_t settings;
+    if (value_size == 0 || interned_feed_settings(batch->ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
+    }
 
-    return W_FALSE;
+    typed_feed_t feed;
+    typed_feed_init_vector(&feed, settings.reference, values, value_size, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-WOLK_ERR_T wolk_register_attribute(wolk_ctx_t* ctx, attribute_t* attributes, size_t number_of_attributes)
+WOLK_ERR_T wolk_feed_batch_add_bool_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle, bool value,
+                                              uint64_t utc_time)
 {
-    outbound_message_t outbound_message = {0};
-    outbound_message_attribute_registration(&ctx->parser, ctx->device_key, attributes, number_of_attributes,
-                                            &outbound_message);
+    feed_settings_t settings;
+    if (interned_feed_settings(batch->ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
+    }
 
-    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    typed_feed_t feed;
+    typed_feed_init_boolean(&feed, settings.reference, value, utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
 }
 
-/* Local function definitions */
+WOLK_ERR_T wolk_feed_batch_add_string_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle,
+                                                const char* value, uint64_t utc_time)
+{
+    feed_settings_t settings;
+    if (interned_feed_settings(batch->ctx, handle, &settings) != W_FALSE) {
+        return W_TRUE;
+    }
 
-static WOLK_ERR_T mqtt_keep_alive(wolk_ctx_t* ctx, uint64_t tick)
+    typed_feed_t feed;
+    typed_feed_init_string(&feed, settings.reference, value, strlen(value), utc_time);
+
+    return feed_batch_add(batch, &settings, &feed);
+}
+
+WOLK_ERR_T wolk_feed_batch_commit(wolk_feed_batch_t* batch)
 {
-    unsigned char buf[MQTT_PACKET_SIZE] = "";
+    /* Sanity check */
+    WOLK_ASSERT(batch != NULL);
 
-    if (ctx->connectData.keepAliveInterval < (MQTT_KEEP_ALIVE_INTERVAL * 1000)) { // Convert to ms
-        ctx->connectData.keepAliveInterval += tick;
+    if (batch->number_of_feeds == 0) {
         return W_FALSE;
     }
 
-    int len = MQTTSerialize_pingreq(buf, MQTT_PACKET_SIZE);
-    transmission_buffer_nb_start(ctx->sock, buf, len);
+    wolk_ctx_t* ctx = batch->ctx;
+    const bool pushed = persistence_push(&ctx->persistence, &batch->message);
 
-    do {
-        switch (transmission_buffer_nb(ctx->sock)) {
-        case TRANSPORT_DONE:
-            ctx->connectData.keepAliveInterval = 0;
-            return W_FALSE;
+    batch->number_of_feeds = 0;
+    outbound_message_begin_typed_feeds(&ctx->parser, &batch->message, &batch->length);
 
-        case TRANSPORT_ERROR:
-            return W_TRUE;
+    return pushed ? W_FALSE : W_TRUE;
+}
 
-        case TRANSPORT_AGAIN:
-            continue;
+WOLK_ERR_T wolk_publish(wolk_ctx_t* ctx)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
 
-        default:
-            /* Sanity check */
-            WOLK_ASSERT(false);
-            return W_TRUE;
+    uint16_t i;
+    outbound_message_t outbound_message = {0};
+    outbound_message_view_t view;
+    int status = continue_outbound(ctx);
+
+    for (i = 0; i < PUBLISH_BATCH_SIZE && status == TRANSPORT_DONE; ++i) {
+        if (persistence_has_view(&ctx->persistence)) {
+            /* Serialize straight from persistence storage */
+            if (!persistence_peek_view(&ctx->persistence, &view)) {
+                /* Message which can not be read would otherwise hold back the ones behind it */
+                if (persistence_is_empty(&ctx->persistence) || !persistence_drop(&ctx->persistence)) {
+                    return W_FALSE;
+                }
+                continue;
+            }
+        } else {
+            if (persistence_peek_n(&ctx->persistence, &outbound_message, 1) == 0) {
+                return W_FALSE;
+            }
+
+            outbound_message_get_view(&outbound_message, &view);
         }
-    } while (true);
+
+        /* Message is removed from persistence once it is completely sent, unless it is discarded meanwhile */
+        if (persistence_has_head_id(&ctx->persistence)) {
+            ctx->outbound_persisted_id = persistence_head_id(&ctx->persistence);
+        }
+        status = publish_view(ctx, &view, OUTBOUND_PACKET_PERSISTED);
+    }
+
+    /* Sending of the last message is resumed on the next call */
+    return status == TRANSPORT_ERROR ? W_TRUE : W_FALSE;
 }
 
-static WOLK_ERR_T receive(wolk_ctx_t* ctx)
+WOLK_ERR_T wolk_set_feed_item_handler(wolk_ctx_t* ctx, feed_item_handler_t handler, void* context)
 {
-    unsigned char mqtt_packet[MQTT_PACKET_SIZE];
-    int mqtt_packet_len = sizeof(mqtt_packet);
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
 
-    if (MQTTPacket_readnb(mqtt_packet, mqtt_packet_len, &(ctx->mqtt_transport)) == PUBLISH) {
-        unsigned char dup;
-        int qos;
-        unsigned char retained;
-        unsigned short msgid;
+    ctx->feed_item_handler = handler;
+    ctx->feed_item_handler_context = context;
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_typed_feed_item_handler(wolk_ctx_t* ctx, typed_feed_item_handler_t handler, void* context)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    ctx->typed_feed_item_handler = handler;
+    ctx->typed_feed_item_handler_context = context;
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_parameter_item_handler(wolk_ctx_t* ctx, parameter_item_handler_t handler, void* context)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    ctx->parameter_item_handler = handler;
+    ctx->parameter_item_handler_context = context;
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_register_topic_handler(wolk_ctx_t* ctx, const char* message_type, topic_handler_t handler,
+                                       void* context)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(handler != NULL);
+
+    return topic_router_add(&ctx->topic_router, message_type, handler, context) ? W_FALSE : W_TRUE;
+}
+
+WOLK_ERR_T wolk_set_numeric_feed_precision(wolk_ctx_t* ctx, const char* reference, int decimals)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(reference != NULL);
+
+    if (reference[0] == '\0' || strlen(reference) >= REFERENCE_SIZE || decimals > DTOA_FIXED_DECIMALS_MAX) {
+        return W_TRUE;
+    }
+
+    /* Settings of interned feeds are looked up again */
+    ctx->feed_settings_generation++;
+
+    if (decimals < 0) {
+        numeric_feed_precision_t* precision = find_numeric_feed_precision(ctx, reference);
+        if (precision) {
+            reference_table_remove(&ctx->numeric_feed_precisions, precision);
+        }
+        return W_FALSE;
+    }
+
+    numeric_feed_precision_t* precision =
+        (numeric_feed_precision_t*)reference_table_insert(&ctx->numeric_feed_precisions, reference);
+    if (!precision) {
+        return W_TRUE;
+    }
+    precision->decimals = (uint8_t)decimals;
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_init_feed_filters(wolk_ctx_t* ctx, feed_filter_t* filters, size_t number_of_filters)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(filters != NULL || number_of_filters == 0);
+
+    /* Settings of interned feeds are looked up again */
+    ctx->feed_settings_generation++;
+
+    reference_table_init(&ctx->feed_filters, filters, sizeof(feed_filter_t), number_of_filters);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_feed_filter(wolk_ctx_t* ctx, const char* reference, const feed_filter_settings_t* settings)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(reference != NULL);
+
+    if (reference[0] == '\0' || strlen(reference) >= REFERENCE_SIZE) {
+        return W_TRUE;
+    }
+
+    /* Settings of interned feeds are looked up again */
+    ctx->feed_settings_generation++;
+
+    if (settings == NULL) {
+        feed_filter_t* filter = find_feed_filter(ctx, reference);
+        if (filter) {
+            reference_table_remove(&ctx->feed_filters, filter);
+        }
+        return W_FALSE;
+    }
+
+    feed_filter_t* filter = (feed_filter_t*)reference_table_insert(&ctx->feed_filters, reference);
+    if (!filter) {
+        return W_TRUE;
+    }
+    feed_filter_init(filter, reference, settings);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_feed_aggregation(wolk_ctx_t* ctx, const char* reference, feed_aggregation_type_t type,
+                                     uint64_t window)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+    WOLK_ASSERT(reference != NULL);
+
+    if (reference[0] == '\0' || strlen(reference) >= REFERENCE_SIZE) {
+        return W_TRUE;
+    }
+
+    /* Settings of interned feeds are looked up again */
+    ctx->feed_settings_generation++;
+
+    /* Reading of the open window is pushed before aggregation changes or stops */
+    WOLK_ERR_T result = W_FALSE;
+    feed_aggregation_t* aggregation = find_feed_aggregation(ctx, reference);
+    typed_feed_t reading;
+    if (aggregation && feed_aggregation_close(aggregation, 0, true, &reading)) {
+        feed_settings_t settings;
+        find_feed_settings(ctx, reference, &settings);
+        result = push_aggregated_reading(ctx, &settings, &reading, NULL);
+    }
+
+    if (window == 0) {
+        if (aggregation) {
+            reference_table_remove(&ctx->feed_aggregations, aggregation);
+        }
+        return result;
+    }
+
+    aggregation = (feed_aggregation_t*)reference_table_insert(&ctx->feed_aggregations, reference);
+    if (!aggregation) {
+        return W_TRUE;
+    }
+    feed_aggregation_init(aggregation, reference, type, window);
+
+    return result;
+}
+
+WOLK_ERR_T wolk_flush_feed_aggregations(wolk_ctx_t* ctx)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    return close_feed_aggregations(ctx, true);
+}
+
+WOLK_BOOL_T wolk_is_publish_in_progress(wolk_ctx_t* ctx)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    const bool is_control_pending = ctx->is_subscribing || !in_memory_packed_persistence_is_empty(&ctx->control_queue);
+    return ctx->outbound_packet_type != OUTBOUND_PACKET_NONE || is_control_pending ? W_TRUE : W_FALSE;
+}
+
+WOLK_ERR_T wolk_register_feed(wolk_ctx_t* ctx, feed_registration_t* feeds, size_t number_of_feeds)
+{
+    return outbound_message_split(&ctx->parser, serialize_feed_registration, feeds, sizeof(*feeds), number_of_feeds,
+                                  store_outbound_message, ctx)
+               ? W_FALSE
+               : W_TRUE;
+}
+
+WOLK_ERR_T wolk_remove_feed(wolk_ctx_t* ctx, feed_registration_t* feeds, size_t number_of_feeds)
+{
+    return outbound_message_split(&ctx->parser, serialize_feed_removal, feeds, sizeof(*feeds), number_of_feeds,
+                                  store_outbound_message, ctx)
+               ? W_FALSE
+               : W_TRUE;
+}
+
+WOLK_ERR_T wolk_pull_feed_values(wolk_ctx_t* ctx)
+{
+    if (ctx->outbound_mode == PULL) {
+        outbound_message_t outbound_message = {0};
+        outbound_message_pull_feed_values(&ctx->parser, &outbound_message);
+
+        return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    }
+
+    return W_TRUE;
+}
+
+WOLK_ERR_T wolk_init_parameter(parameter_t* parameter, char* name, char* value)
+{
+    parameter_init(parameter, name, value);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_set_value_parameter(parameter_t* parameter, char* value)
+{
+    parameter_set_value(parameter, value);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_change_parameter(wolk_ctx_t* ctx, parameter_t* parameter, size_t number_of_parameters)
+{
+    return outbound_message_split(&ctx->parser, serialize_parameters, parameter, sizeof(*parameter),
+                                  number_of_parameters, store_outbound_message, ctx)
+               ? W_FALSE
+               : W_TRUE;
+}
+
+WOLK_ERR_T wolk_pull_parameters(wolk_ctx_t* ctx)
+{
+    if (ctx->outbound_mode == PULL) {
+        outbound_message_t outbound_message = {0};
+        outbound_message_pull_parameters(&ctx->parser, &outbound_message);
+
+        return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    }
+
+    return W_TRUE;
+}
+
+WOLK_ERR_T wolk_sync_parameters(wolk_ctx_t* ctx, parameter_t* parameters, size_t number_of_parameters)
+{
+    return outbound_message_split(&ctx->parser, serialize_synchronize_parameters, parameters, sizeof(*parameters),
+                                  number_of_parameters, store_outbound_message, ctx)
+               ? W_FALSE
+               : W_TRUE;
+}
+
+WOLK_ERR_T wolk_sync_time_request(wolk_ctx_t* ctx)
+{
+    outbound_message_t outbound_message = {0};
+    outbound_message_synchronize_time(&ctx->parser, &outbound_message);
+
+    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+}
+
+WOLK_ERR_T wolk_details_synchronization(wolk_ctx_t* ctx)
+{
+    outbound_message_t outbound_message = {0};
+    outbound_message_details_synchronize(&ctx->parser, &outbound_message);
+
+    return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+}
+
+WOLK_ERR_T wolk_init_attribute(wolk_attribute_t* attribute, char* name, char* data_type, char* value)
+{
+    attribute_init(attribute, name, data_type, value);
+
+    return W_FALSE;
+}
+
+WOLK_ERR_T wolk_register_attribute(wolk_ctx_t* ctx, attribute_t* attributes, size_t number_of_attributes)
+{
+    return outbound_message_split(&ctx->parser, serialize_attributes, attributes, sizeof(*attributes),
+                                  number_of_attributes, store_outbound_message, ctx)
+               ? W_FALSE
+               : W_TRUE;
+}
+
+/* Local function definitions */
+
+static WOLK_ERR_T mqtt_keep_alive(wolk_ctx_t* ctx, uint64_t tick)
+{
+    if (ctx->connectData.keepAliveInterval < (MQTT_KEEP_ALIVE_INTERVAL * 1000)) { // Convert to ms
+        ctx->connectData.keepAliveInterval += tick;
+        return W_FALSE;
+    }
+
+    /* Ping waits for packet in progress, keep alive period is restarted once the ping is sent */
+    if (ctx->outbound_packet_type != OUTBOUND_PACKET_NONE) {
+        return W_FALSE;
+    }
+
+    int len = MQTTSerialize_pingreq(ctx->outbound_packet, MQTT_PACKET_SIZE);
+    if (start_outbound_packet(ctx, len, OUTBOUND_PACKET_PING) == TRANSPORT_ERROR) {
+        return W_TRUE;
+    }
+
+    return W_FALSE;
+}
+
+static WOLK_ERR_T receive(wolk_ctx_t* ctx)
+{
+    unsigned char* mqtt_packet = ctx->inbound_packet;
+    int mqtt_packet_len = MQTT_PACKET_SIZE;
+
+    if (MQTTPacket_readnb(mqtt_packet, mqtt_packet_len, &(ctx->mqtt_transport)) == PUBLISH) {
+        unsigned char dup;
+        int qos;
+        unsigned char retained;
+        unsigned short msgid;
 
         MQTTString topic_mqtt_str = {0};
         unsigned char* payload;
         int payload_len = 0;
 
-        if (MQTTDeserialize_publish(&dup, &qos, &retained, &msgid, &topic_mqtt_str, &payload, &payload_len, mqtt_packet,
-                                    mqtt_packet_len)
-            != 1) {
+        if (MQTTDeserialize_publish(&dup, &qos, &retained, &msgid, &topic_mqtt_str, &payload, &payload_len, mqtt_packet,
+                                    mqtt_packet_len)
+            != 1) {
+            return W_TRUE;
+        }
+
+        const topic_route_t* route = topic_router_find(&ctx->topic_router, topic_mqtt_str.lenstring.data,
+                                                       (size_t)topic_mqtt_str.lenstring.len);
+        if (route != NULL) {
+            route->handler(route->context, (char*)payload, (size_t)payload_len);
+        }
+    }
+
+    return W_FALSE;
+}
+
+static WOLK_ERR_T publish(wolk_ctx_t* ctx, outbound_message_t* outbound_message)
+{
+    /* Message waits in control queue while packet in progress occupies outbound packet buffer */
+    if (!in_memory_packed_persistence_push(&ctx->control_queue, outbound_message)) {
+        return W_TRUE;
+    }
+
+    return continue_outbound(ctx) == TRANSPORT_ERROR ? W_TRUE : W_FALSE;
+}
+
+static int publish_view(wolk_ctx_t* ctx, const outbound_message_view_t* view, outbound_packet_t type)
+{
+    MQTTString mqtt_topic = MQTTString_initializer;
+    mqtt_topic.lenstring.data = view->topic;
+    mqtt_topic.lenstring.len = view->topic_length;
+
+    int len = MQTTSerialize_publish(ctx->outbound_packet, MQTT_PACKET_SIZE, 0, 0, 0, 0, mqtt_topic,
+                                    (unsigned char*)view->payload, (int)view->payload_length);
+    if (len <= 0) {
+        return TRANSPORT_ERROR;
+    }
+
+    return start_outbound_packet(ctx, len, type);
+}
+
+static int subscribe(wolk_ctx_t* ctx, char topics[][TOPIC_SIZE], const size_t* topic_lengths, int number_of_topics)
+{
+    MQTTString topic_filters[SUBSCRIPTION_TOPICS_MAX];
+    int requested_qos[SUBSCRIPTION_TOPICS_MAX];
+    int i;
+
+    /* Sanity check */
+    WOLK_ASSERT(number_of_topics <= SUBSCRIPTION_TOPICS_MAX);
+
+    for (i = 0; i < number_of_topics; ++i) {
+        MQTTString topic_filter = MQTTString_initializer;
+        topic_filter.lenstring.data = topics[i];
+        topic_filter.lenstring.len = (int)topic_lengths[i];
+
+        topic_filters[i] = topic_filter;
+        requested_qos[i] = 0;
+    }
+
+    /* All topics are requested by a single packet */
+    const int len = MQTTSerialize_subscribe(ctx->outbound_packet, MQTT_PACKET_SIZE, 0, 1, number_of_topics,
+                                            topic_filters, requested_qos);
+    return start_outbound_packet(ctx, len, OUTBOUND_PACKET_SUBSCRIBE);
+}
+
+static int start_outbound_packet(wolk_ctx_t* ctx, int length, outbound_packet_t type)
+{
+    /* Sanity check */
+    WOLK_ASSERT(ctx->outbound_packet_type == OUTBOUND_PACKET_NONE);
+    WOLK_ASSERT(type != OUTBOUND_PACKET_NONE);
+
+    if (length <= 0) {
+        return TRANSPORT_ERROR;
+    }
+
+    transmission_buffer_nb_start(&ctx->transmission, ctx->outbound_packet, length);
+    ctx->outbound_packet_type = type;
+
+    return continue_outbound_packet(ctx);
+}
+
+static int continue_outbound_packet(wolk_ctx_t* ctx)
+{
+    if (ctx->outbound_packet_type == OUTBOUND_PACKET_NONE) {
+        return TRANSPORT_DONE;
+    }
+
+    const int status = transmission_buffer_nb(&ctx->transmission);
+    if (status == TRANSPORT_AGAIN) {
+        return TRANSPORT_AGAIN;
+    }
+
+    if (status == TRANSPORT_DONE) {
+        switch (ctx->outbound_packet_type) {
+        case OUTBOUND_PACKET_PERSISTED:
+            if (!is_persisted_packet_head(ctx)) {
+                /* Sent message was discarded by wrap, head is the next message which is not sent yet */
+                break;
+            }
+
+            if (persistence_has_view(&ctx->persistence)) {
+                persistence_drop(&ctx->persistence);
+            } else {
+                persistence_pop_n(&ctx->persistence, NULL, 1);
+            }
+            break;
+
+        case OUTBOUND_PACKET_PING:
+            ctx->connectData.keepAliveInterval = 0;
+            break;
+
+        case OUTBOUND_PACKET_CONTROL:
+            in_memory_packed_persistence_drop(&ctx->control_queue);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    /* On error persisted message stays in persistence and is sent again after reconnect */
+    ctx->outbound_packet_type = OUTBOUND_PACKET_NONE;
+    return status;
+}
+
+static int continue_outbound(wolk_ctx_t* ctx)
+{
+    outbound_message_view_t view;
+    int status = continue_outbound_packet(ctx);
+
+    /* Subscriptions, then control messages, each once the previous packet is sent */
+    while (status == TRANSPORT_DONE) {
+        if (ctx->is_subscribing) {
+            status = subscribe_next(ctx);
+        } else if (in_memory_packed_persistence_peek_view(&ctx->control_queue, &view)) {
+            status = publish_view(ctx, &view, OUTBOUND_PACKET_CONTROL);
+            if (status == TRANSPORT_ERROR) {
+                /* Message is lost with the connection, as it would be if it was sent at once */
+                in_memory_packed_persistence_drop(&ctx->control_queue);
+            }
+        } else {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static bool is_persisted_packet_head(wolk_ctx_t* ctx)
+{
+    if (!persistence_has_head_id(&ctx->persistence)) {
+        return true;
+    }
+
+    return !persistence_is_empty(&ctx->persistence)
+           && persistence_head_id(&ctx->persistence) == ctx->outbound_persisted_id;
+}
+
+static WOLK_ERR_T finish_outbound_packet(wolk_ctx_t* ctx)
+{
+    int status;
+
+    while ((status = continue_outbound_packet(ctx)) == TRANSPORT_AGAIN) {
+    }
+
+    return status == TRANSPORT_DONE ? W_FALSE : W_TRUE;
+}
+
+static bool is_wolk_initialized(wolk_ctx_t* ctx)
+{
+    /* Sanity Check */
+    WOLK_ASSERT(ctx);
+
+    return ctx->is_initialized && persistence_is_initialized(&ctx->persistence);
+}
+
+static numeric_feed_precision_t* find_numeric_feed_precision(wolk_ctx_t* ctx, const char* reference)
+{
+    return (numeric_feed_precision_t*)reference_table_find(&ctx->numeric_feed_precisions, reference);
+}
+
+static feed_filter_t* find_feed_filter(wolk_ctx_t* ctx, const char* reference)
+{
+    return (feed_filter_t*)reference_table_find(&ctx->feed_filters, reference);
+}
+
+static feed_aggregation_t* find_feed_aggregation(wolk_ctx_t* ctx, const char* reference)
+{
+    return (feed_aggregation_t*)reference_table_find(&ctx->feed_aggregations, reference);
+}
+
+static void find_feed_settings(wolk_ctx_t* ctx, const char* reference, feed_settings_t* settings)
+{
+    const numeric_feed_precision_t* precision = find_numeric_feed_precision(ctx, reference);
+
+    settings->reference = reference;
+    settings->key = NULL;
+    settings->key_length = 0;
+    settings->decimals = precision ? (int8_t)precision->decimals : -1;
+    settings->filter = find_feed_filter(ctx, reference);
+    settings->aggregation = find_feed_aggregation(ctx, reference);
+}
+
+static WOLK_ERR_T interned_feed_settings(wolk_ctx_t* ctx, wolk_feed_handle_t handle, feed_settings_t* settings)
+{
+    /* Sanity check */
+    WOLK_ASSERT(is_wolk_initialized(ctx));
+
+    if (handle < 0 || (size_t)handle >= ctx->interned_feeds.capacity) {
+        return W_TRUE;
+    }
+
+    interned_feed_t* feed = (interned_feed_t*)reference_table_at(&ctx->interned_feeds, (size_t)handle);
+    if (!feed) {
+        return W_TRUE;
+    }
+    if (feed->settings_generation != ctx->feed_settings_generation) {
+        find_feed_settings(ctx, feed->reference, settings);
+        feed->decimals = settings->decimals;
+        feed->filter = settings->filter;
+        feed->aggregation = settings->aggregation;
+        feed->settings_generation = ctx->feed_settings_generation;
+    }
+
+    settings->reference = feed->reference;
+    settings->key = feed->key_length > 0 ? feed->key : NULL;
+    settings->key_length = feed->key_length;
+    settings->decimals = feed->decimals;
+    settings->filter = feed->filter;
+    settings->aggregation = feed->aggregation;
+    return W_FALSE;
+}
+
+static void apply_feed_settings(const feed_settings_t* settings, typed_feed_t* feed)
+{
+    feed->key = settings->key;
+    feed->key_length = settings->key_length;
+    feed->decimals = settings->decimals;
+}
+
+static bool is_valid_feed_time(const feed_settings_t* settings, uint64_t utc_time, size_t number_of_feeds)
+{
+    if (utc_time < 1000000000000 && utc_time != 0) // Unit ms and zero is valid value
+    {
+        printf("Failed UTC attached to feed with reference %s. It has to be in ms!\n", settings->reference);
+        return false;
+    }
+
+    /* Several readings of the same reference need their own timestamps */
+    return number_of_feeds == 1 || utc_time != 0;
+}
+
+static WOLK_ERR_T add_string_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_string_feeds_t* feeds,
+                                   size_t number_of_feeds)
+{
+    if (number_of_feeds == 0) {
+        return W_TRUE;
+    }
+
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        if (!is_valid_feed_time(settings, feeds[i].utc_time, number_of_feeds)) {
             return W_TRUE;
         }
+    }
+
+    /* Any number of readings is packed into as many messages as needed */
+    wolk_feed_batch_t batch;
+    wolk_feed_batch_begin(ctx, &batch);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        typed_feed_t feed;
+        typed_feed_init_string(&feed, settings->reference, feeds[i].value, strlen(feeds[i].value),
+                               feeds[i].utc_time);
+
+        if (feed_batch_add(&batch, settings, &feed) != W_FALSE) {
+            return W_TRUE;
+        }
+    }
 
-        WOLK_ASSERT(TOPIC_SIZE > topic_mqtt_str.lenstring.len);
+    return wolk_feed_batch_commit(&batch);
+}
 
-        char topic_str[TOPIC_SIZE] = "";
+static WOLK_ERR_T add_numeric_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_numeric_feeds_t* feeds,
+                                    size_t number_of_feeds)
+{
+    if (number_of_feeds == 0) {
+        return W_TRUE;
+    }
 
-        if (topic_mqtt_str.lenstring.len > TOPIC_SIZE) {
-            printf("Failed to parse received MQTT message. It is longer than topic buffer!\n");
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        if (!is_valid_feed_time(settings, feeds[i].utc_time, number_of_feeds)) {
             return W_TRUE;
         }
-        strncpy(topic_str, topic_mqtt_str.lenstring.data, topic_mqtt_str.lenstring.len);
-
-        if (strstr(topic_str, ctx->parser.FEED_VALUES_MESSAGE_TOPIC) != NULL) {
-            feed_t feeds_received[FEED_ELEMENT_SIZE];
-            const size_t number_of_deserialized_feeds =
-                parser_deserialize_feeds_message(&ctx->parser, (char*)payload, (size_t)payload_len, &feeds_received);
-            if (number_of_deserialized_feeds != 0) {
-                handle_feeds(ctx, &feeds_received, number_of_deserialized_feeds);
-            }
-        } else if (strstr(topic_str, ctx->parser.PARAMETERS_TOPIC)) {
-            parameter_t parameter_message[FEED_ELEMENT_SIZE];
-            const size_t number_of_deserialized_parameters = parser_deserialize_parameter_message(
-                &ctx->parser, (char*)payload, (size_t)payload_len, &parameter_message);
-            if (number_of_deserialized_parameters != 0) {
-                handle_parameter_message(ctx, &parameter_message, number_of_deserialized_parameters);
-            }
-        } else if (strstr(topic_str, ctx->parser.SYNC_TIME_TOPIC)) {
-            utc_command_t utc_command;
-            const size_t num_deserialized_commands =
-                parser_deserialize_time(&ctx->parser, (char*)payload, (size_t)payload_len, &utc_command);
-            if (num_deserialized_commands != 0) {
-                handle_utc_command(ctx, &utc_command);
-            }
-        } else if (strstr(topic_str, ctx->parser.ERROR_TOPIC)) {
-            if (payload_len != 0) {
-                handle_error_message(ctx, &payload);
-            }
-        } else if (strstr(topic_str, ctx->parser.DETAILS_SYNCHRONIZATION_TOPIC)) {
-            feed_registration_t feeds[FEED_ELEMENT_SIZE];
-            attribute_t attributes[FEED_ELEMENT_SIZE];
-            size_t number_of_feeds = 0;
-            size_t number_of_attributes = 0;
-
-            if (parser_deserialize_details_synchronization(&ctx->parser, (char*)payload, (size_t)payload_len, feeds,
-                                                           &number_of_feeds, attributes, &number_of_attributes)) {
-                handle_details_synchronization_message(ctx, feeds, number_of_feeds, attributes, number_of_attributes);
-            }
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_UPLOAD_INITIATE_TOPIC)) {
-            file_management_parameter_t file_management_parameter;
-            const size_t num_deserialized_parameter = parser_deserialize_file_management_parameter(
-                &ctx->parser, (char*)payload, (size_t)payload_len, &file_management_parameter);
-            if (num_deserialized_parameter != 0) {
-                handle_file_management_parameter(&ctx->file_management, &file_management_parameter);
-            }
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_BINARY_RESPONSE_TOPIC)) {
-            handle_file_management_packet(&ctx->file_management, (uint8_t*)payload, (size_t)payload_len);
-        } else if ((strstr(topic_str, ctx->parser.FILE_MANAGEMENT_UPLOAD_ABORT_TOPIC))
-                   || (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_ABORT_TOPIC))) {
-            handle_file_management_abort(&ctx->file_management, (uint8_t*)payload, (size_t)payload_len);
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_INITIATE_TOPIC)) {
-            char url_download[FILE_MANAGEMENT_URL_SIZE] = {0};
-            if (parser_deserialize_url_download(&ctx->parser, (char*)payload, (size_t)payload_len, url_download))
-                handle_file_management_url_download(&ctx->file_management, url_download);
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_FILE_LIST_TOPIC)) {
-            handle_file_management_file_list(&ctx->file_management);
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_FILE_DELETE_TOPIC)) {
-            file_list_t file_list[FILE_MANAGEMENT_FILE_LIST_SIZE];
-            const size_t number_deserialized =
-                parser_deserialize_file_delete(&ctx->parser, (char*)payload, (size_t)payload_len, file_list);
-            if (number_deserialized) {
-                handle_file_management_file_delete(&ctx->file_management, file_list, number_deserialized);
-            }
-        } else if (strstr(topic_str, ctx->parser.FILE_MANAGEMENT_FILE_PURGE_TOPIC)) {
-            handle_file_management_file_purge(&ctx->file_management);
-        } else if (strstr(topic_str, ctx->parser.FIRMWARE_UPDATE_INSTALL_TOPIC)) {
-            firmware_update_t firmware_update_parameter;
-            if (parse_deserialize_firmware_update_parameter(&ctx->parser, (char*)payload, (size_t)payload_len,
-                                                            &firmware_update_parameter)) {
-                handle_firmware_update_installation(&ctx->firmware_update, &firmware_update_parameter);
-            }
-        } else if (strstr(topic_str, ctx->parser.FIRMWARE_UPDATE_ABORT_TOPIC)) {
-            handle_firmware_update_abort(&ctx->firmware_update);
+    }
+
+    /* Any number of readings is packed into as many messages as needed */
+    wolk_feed_batch_t batch;
+    wolk_feed_batch_begin(ctx, &batch);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        typed_feed_t feed;
+        typed_feed_init_numeric(&feed, settings->reference, feeds[i].value, feeds[i].utc_time);
+
+        if (feed_batch_add(&batch, settings, &feed) != W_FALSE) {
+            return W_TRUE;
         }
     }
 
-    return W_FALSE;
+    return wolk_feed_batch_commit(&batch);
 }
 
-static WOLK_ERR_T publish(wolk_ctx_t* ctx, outbound_message_t* outbound_message)
+static WOLK_ERR_T add_multi_value_numeric_feed(wolk_ctx_t* ctx, const feed_settings_t* settings, double* values,
+                                               uint16_t value_size, uint64_t utc_time)
 {
-    unsigned char buf[MQTT_PACKET_SIZE] = "";
+    if (value_size == 0) {
+        return W_TRUE;
+    }
 
-    MQTTString mqtt_topic = MQTTString_initializer;
-    mqtt_topic.cstring = outbound_message_get_topic(outbound_message);
+    if (utc_time < 1000000000000 && utc_time != 0) // Unit ms and zero is valid value
+    {
+        printf("Failed UTC attached to feeds. It has to be in ms!\n");
+        return W_TRUE;
+    }
 
-    unsigned char* payload = (unsigned char*)outbound_message_get_payload(outbound_message);
-    int len = MQTTSerialize_publish(buf, MQTT_PACKET_SIZE, 0, 0, 0, 0, mqtt_topic, payload,
-                                    (int)strlen((const char*)payload));
-    transmission_buffer_nb_start(ctx->sock, buf, len);
+    /* One feed consisting of N numeric values */
+    typed_feed_t typed_feed;
+    typed_feed_init_vector(&typed_feed, settings->reference, values, value_size, utc_time);
 
-    do {
-        switch (transmission_buffer_nb(ctx->sock)) {
-        case TRANSPORT_DONE:
-            return W_FALSE;
+    return push_typed_feeds(ctx, settings, &typed_feed, 1);
+}
+
+static WOLK_ERR_T add_bool_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, wolk_boolean_feeds_t* feeds,
+                                 size_t number_of_feeds)
+{
+    if (number_of_feeds == 0) {
+        return W_TRUE;
+    }
 
-        case TRANSPORT_ERROR:
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        if (!is_valid_feed_time(settings, feeds[i].utc_time, number_of_feeds)) {
             return W_TRUE;
+        }
+    }
 
-        case TRANSPORT_AGAIN:
-            continue;
+    /* Any number of readings is packed into as many messages as needed */
+    wolk_feed_batch_t batch;
+    wolk_feed_batch_begin(ctx, &batch);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        typed_feed_t feed;
+        typed_feed_init_boolean(&feed, settings->reference, feeds[i].value, feeds[i].utc_time);
 
-        default:
-            /* Sanity check */
-            WOLK_ASSERT(false);
+        if (feed_batch_add(&batch, settings, &feed) != W_FALSE) {
             return W_TRUE;
         }
-    } while (true);
+    }
+
+    return wolk_feed_batch_commit(&batch);
 }
 
-static WOLK_ERR_T subscribe(wolk_ctx_t* ctx, const char* topic)
+static bool accept_typed_feed(wolk_ctx_t* ctx, feed_filter_t* filter, const typed_feed_t* feed)
 {
-    unsigned char buf[MQTT_PACKET_SIZE] = "";
+    if (!filter) {
+        return true;
+    }
 
-    int req_qos = 0;
+    const uint64_t time = feed->utc != 0 ? feed->utc : ctx->uptime;
+    switch (feed->type) {
+    case NUMERIC:
+        return feed_filter_accept_numeric(filter, feed->value.numeric, time);
+    case BOOLEAN:
+        return feed_filter_accept_numeric(filter, feed->value.boolean ? 1 : 0, time);
+    case VECTOR:
+        return feed_filter_accept_data(filter, feed->vector, feed->size * sizeof(*feed->vector), time);
+    default:
+        return feed_filter_accept_data(filter, feed->value.string.data, feed->value.string.length, time);
+    }
+}
+
+static bool is_aggregated(const feed_settings_t* settings, const typed_feed_t* feed)
+{
+    /* Only single numeric values are aggregated */
+    return settings->aggregation != NULL && feed->type == NUMERIC;
+}
 
-    MQTTString topicString = MQTTString_initializer;
-    topicString.cstring = topic;
+static WOLK_ERR_T aggregate_typed_feed(wolk_ctx_t* ctx, const feed_settings_t* settings, const typed_feed_t* feed,
+                                       wolk_feed_batch_t* batch)
+{
+    typed_feed_t reading;
+    const uint64_t time = feed->utc != 0 ? feed->utc : ctx->uptime;
+    if (!feed_aggregation_add(settings->aggregation, feed->value.numeric, time, feed->utc != 0, ctx->uptime,
+                              &reading)) {
+        return W_FALSE;
+    }
 
-    const int len = MQTTSerialize_subscribe(buf, MQTT_PACKET_SIZE, 0, 1, 1, &topicString, &req_qos);
-    transmission_buffer_nb_start(ctx->sock, buf, len);
+    return push_aggregated_reading(ctx, settings, &reading, batch);
+}
 
-    do {
-        switch (transmission_buffer_nb(ctx->sock)) {
-        case TRANSPORT_DONE:
-            return W_FALSE;
+static WOLK_ERR_T push_aggregated_reading(wolk_ctx_t* ctx, const feed_settings_t* settings, typed_feed_t* reading,
+                                          wolk_feed_batch_t* batch)
+{
+    apply_feed_settings(settings, reading);
+    if (!accept_typed_feed(ctx, settings->filter, reading)) {
+        return W_FALSE;
+    }
 
-        case TRANSPORT_ERROR:
-            return W_TRUE;
+    return batch ? feed_batch_append(batch, reading) : store_typed_feeds(ctx, reading, 1);
+}
 
-        case TRANSPORT_AGAIN:
+static WOLK_ERR_T close_feed_aggregations(wolk_ctx_t* ctx, bool force)
+{
+    WOLK_ERR_T result = W_FALSE;
+    for (size_t i = 0; i < ctx->feed_aggregations.capacity; ++i) {
+        feed_aggregation_t* aggregation = (feed_aggregation_t*)reference_table_at(&ctx->feed_aggregations, i);
+        if (!aggregation) {
             continue;
+        }
 
-        default:
-            /* Sanity check */
-            WOLK_ASSERT(false);
+        typed_feed_t reading;
+        if (feed_aggregation_close(aggregation, ctx->uptime, force, &reading)) {
+            feed_settings_t settings;
+            find_feed_settings(ctx, aggregation->reference, &settings);
+
+            if (push_aggregated_reading(ctx, &settings, &reading, NULL) != W_FALSE) {
+                result = W_TRUE;
+            }
+        }
+    }
+
+    return result;
+}
+
+static WOLK_ERR_T push_typed_feeds(wolk_ctx_t* ctx, const feed_settings_t* settings, typed_feed_t* feeds,
+                                   size_t number_of_feeds)
+{
+    /* Several readings of the same message need their own timestamps */
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        if (number_of_feeds > 1 && feeds[i].utc == 0) {
             return W_TRUE;
         }
-    } while (true);
+    }
+
+    /* Readings which are aggregated or filtered out are not pushed as they are */
+    size_t number_of_accepted_feeds = 0;
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        apply_feed_settings(settings, &feeds[i]);
+
+        if (is_aggregated(settings, &feeds[i])) {
+            if (aggregate_typed_feed(ctx, settings, &feeds[i], NULL) != W_FALSE) {
+                return W_TRUE;
+            }
+        } else if (accept_typed_feed(ctx, settings->filter, &feeds[i])) {
+            feeds[number_of_accepted_feeds++] = feeds[i];
+        }
+    }
+
+    return number_of_accepted_feeds > 0 ? store_typed_feeds(ctx, feeds, number_of_accepted_feeds) : W_FALSE;
 }
 
-static bool is_wolk_initialized(wolk_ctx_t* ctx)
+static WOLK_ERR_T store_typed_feeds(wolk_ctx_t* ctx, const typed_feed_t* feeds, size_t number_of_feeds)
 {
-    /* Sanity Check */
-    WOLK_ASSERT(ctx);
+    outbound_message_t outbound_message = {0};
+    if (outbound_message_make_from_typed_feeds(&ctx->parser, feeds, number_of_feeds, &outbound_message)) {
+        return persistence_push(&ctx->persistence, &outbound_message) ? W_FALSE : W_TRUE;
+    }
 
-    return ctx->is_initialized && persistence_is_initialized(&ctx->persistence);
+    /* Readings which do not fit into one message are split across as many as needed */
+    wolk_feed_batch_t batch;
+    wolk_feed_batch_begin(ctx, &batch);
+    for (size_t i = 0; i < number_of_feeds; ++i) {
+        if (feed_batch_append(&batch, &feeds[i]) != W_FALSE) {
+            return W_TRUE;
+        }
+    }
+
+    return wolk_feed_batch_commit(&batch);
+}
+
+static WOLK_ERR_T feed_batch_add(wolk_feed_batch_t* batch, const feed_settings_t* settings, typed_feed_t* feed)
+{
+    /* Sanity check */
+    WOLK_ASSERT(batch != NULL);
+
+    if (feed->utc < 1000000000000 && feed->utc != 0) // Unit ms and zero is valid value
+    {
+        printf("Failed UTC attached to feed with reference %s. It has to be in ms!\n", feed->reference);
+        return W_TRUE;
+    }
+
+    apply_feed_settings(settings, feed);
+
+    if (is_aggregated(settings, feed)) {
+        return aggregate_typed_feed(batch->ctx, settings, feed, batch);
+    }
+
+    if (!accept_typed_feed(batch->ctx, settings->filter, feed)) {
+        return W_FALSE;
+    }
+
+    return feed_batch_append(batch, feed);
+}
+
+static WOLK_ERR_T feed_batch_append(wolk_feed_batch_t* batch, const typed_feed_t* feed)
+{
+    wolk_ctx_t* ctx = batch->ctx;
+    if (outbound_message_append_typed_feed(&ctx->parser, feed, &batch->message, &batch->length)) {
+        batch->number_of_feeds++;
+        return W_FALSE;
+    }
+
+    /* Message is full, feed goes to the next one */
+    if (batch->number_of_feeds == 0 || wolk_feed_batch_commit(batch) != W_FALSE) {
+        return W_TRUE;
+    }
+
+    if (!outbound_message_append_typed_feed(&ctx->parser, feed, &batch->message, &batch->length)) {
+        return W_TRUE;
+    }
+    batch->number_of_feeds++;
+
+    return W_FALSE;
+}
+
+static bool store_outbound_message(void* context, outbound_message_t* outbound_message)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    return persistence_push(&ctx->persistence, outbound_message);
+}
+
+static bool publish_outbound_message(void* context, outbound_message_t* outbound_message)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    return publish(ctx, outbound_message) == W_FALSE;
+}
+
+static bool serialize_feed_registration(parser_t* parser, void* items, size_t number_of_items,
+                                        outbound_message_t* outbound_message)
+{
+    return outbound_message_feed_registration(parser, (feed_registration_t*)items, number_of_items, outbound_message);
+}
+
+static bool serialize_feed_removal(parser_t* parser, void* items, size_t number_of_items,
+                                   outbound_message_t* outbound_message)
+{
+    return outbound_message_feed_removal(parser, (feed_registration_t*)items, number_of_items, outbound_message);
+}
+
+static bool serialize_parameters(parser_t* parser, void* items, size_t number_of_items,
+                                 outbound_message_t* outbound_message)
+{
+    return outbound_message_update_parameters(parser, (parameter_t*)items, number_of_items, outbound_message);
+}
+
+static bool serialize_synchronize_parameters(parser_t* parser, void* items, size_t number_of_items,
+                                             outbound_message_t* outbound_message)
+{
+    return outbound_message_synchronize_parameters(parser, (parameter_t*)items, number_of_items, outbound_message);
+}
+
+static bool serialize_attributes(parser_t* parser, void* items, size_t number_of_items,
+                                 outbound_message_t* outbound_message)
+{
+    return outbound_message_attribute_registration(parser, (attribute_t*)items, number_of_items, outbound_message);
+}
+
+static bool serialize_file_list(parser_t* parser, void* items, size_t number_of_items,
+                                outbound_message_t* outbound_message)
+{
+    return outbound_message_make_from_file_management_file_list(parser, (file_list_t*)items, number_of_items,
+                                                                outbound_message);
 }
 
 static void handle_feeds(wolk_ctx_t* ctx, feed_t* feeds, size_t number_of_feeds)
@@ -877,8 +1826,8 @@ static void listener_file_management_on_status(file_management_t* file_managemen
 
     wolk_ctx_t* wolk_ctx = (wolk_ctx_t*)file_management->wolk_ctx;
     outbound_message_t outbound_message = {0};
-    outbound_message_make_from_file_management_status(&wolk_ctx->parser, wolk_ctx->device_key,
-                                                      file_management->file_name, &status, &outbound_message);
+    outbound_message_make_from_file_management_status(&wolk_ctx->parser, file_management->file_name, &status,
+                                                      &outbound_message);
 
     publish(wolk_ctx, &outbound_message);
 }
@@ -893,8 +1842,7 @@ static void listener_file_management_on_packet_request(file_management_t* file_m
     wolk_ctx_t* wolk_ctx = (wolk_ctx_t*)file_management->wolk_ctx;
 
     outbound_message_t outbound_message = {0};
-    outbound_message_make_from_file_management_packet_request(&wolk_ctx->parser, wolk_ctx->device_key, &request,
-                                                              &outbound_message);
+    outbound_message_make_from_file_management_packet_request(&wolk_ctx->parser, &request, &outbound_message);
 
     publish(wolk_ctx, &outbound_message);
 }
@@ -913,8 +1861,8 @@ static void listener_file_management_on_url_download_status(file_management_t* f
     file_management_parameter_set_file_url(&file_management_parameter, file_management->file_url);
     file_management_parameter_set_filename(&file_management_parameter, file_management->file_name);
 
-    outbound_message_make_from_file_management_url_download_status(
-        &wolk_ctx->parser, wolk_ctx->device_key, &file_management_parameter, &status, &outbound_message);
+    outbound_message_make_from_file_management_url_download_status(&wolk_ctx->parser, &file_management_parameter,
+                                                                   &status, &outbound_message);
 
     publish(wolk_ctx, &outbound_message);
 }
@@ -928,12 +1876,9 @@ static void listener_file_management_on_file_list_status(file_management_t* file
     WOLK_ASSERT(file_list_items);
 
     wolk_ctx_t* wolk_ctx = (wolk_ctx_t*)file_management->wolk_ctx;
-    outbound_message_t outbound_message = {0};
 
-    outbound_message_make_from_file_management_file_list(&wolk_ctx->parser, wolk_ctx->device_key, file_list,
-                                                         file_list_items, &outbound_message);
-
-    publish(wolk_ctx, &outbound_message);
+    outbound_message_split(&wolk_ctx->parser, serialize_file_list, file_list, sizeof(*file_list), file_list_items,
+                           publish_outbound_message, wolk_ctx);
 }
 
 static void listener_firmware_update_on_status(firmware_update_t* firmware_update)
@@ -945,8 +1890,7 @@ static void listener_firmware_update_on_status(firmware_update_t* firmware_updat
     wolk_ctx_t* wolk_ctx = (wolk_ctx_t*)firmware_update->wolk_ctx;
     outbound_message_t outbound_message = {0};
 
-    outbound_message_make_from_firmware_update_status(&wolk_ctx->parser, wolk_ctx->device_key, firmware_update,
-                                                      &outbound_message);
+    outbound_message_make_from_firmware_update_status(&wolk_ctx->parser, firmware_update, &outbound_message);
 
     publish(wolk_ctx, &outbound_message);
 }
@@ -976,13 +1920,238 @@ static void handle_firmware_update_abort(firmware_update_t* firmware_update)
     firmware_update_handle_abort(firmware_update);
 }
 
-static WOLK_ERR_T subscribe_to(wolk_ctx_t* ctx, char message_type[TOPIC_MESSAGE_TYPE_SIZE])
+static int subscribe_next(wolk_ctx_t* ctx)
 {
-    char topic[TOPIC_SIZE] = "";
+    char topics[SUBSCRIPTION_TOPICS_MAX][TOPIC_SIZE];
+    size_t topic_lengths[SUBSCRIPTION_TOPICS_MAX];
+    int number_of_topics = 0;
+
+    /* Topics are joined from router prefix, 'p2d/<device_key>/', which is built once */
+    const char* prefix = ctx->topic_router.prefix;
+    const size_t prefix_length = ctx->topic_router.prefix_length;
+
+#ifdef WOLK_SUBSCRIBE_WILDCARD
+    memcpy(topics[0], prefix, prefix_length);
+    topics[0][prefix_length] = '#';
+    topic_lengths[0] = prefix_length + 1;
+    number_of_topics = 1;
+
+    ctx->next_subscription = ctx->topic_router.number_of_routes;
+#else
+    /* Every message type with a handler, as few packets as possible */
+    while (ctx->next_subscription < ctx->topic_router.number_of_routes && number_of_topics < SUBSCRIPTION_TOPICS_MAX) {
+        const topic_route_t* route = &ctx->topic_router.routes[ctx->next_subscription];
+
+        memcpy(topics[number_of_topics], prefix, prefix_length);
+        memcpy(topics[number_of_topics] + prefix_length, route->message_type, route->message_type_length);
+        topic_lengths[number_of_topics] = prefix_length + route->message_type_length;
+
+        ++number_of_topics;
+        ++ctx->next_subscription;
+    }
+#endif
 
-    parser_create_topic(&ctx->parser, ctx->parser.P2D_TOPIC, ctx->device_key, message_type, topic);
-    if (subscribe(ctx, topic) != W_FALSE) {
-        return W_TRUE;
+    ctx->is_subscribing = ctx->next_subscription < ctx->topic_router.number_of_routes;
+    if (number_of_topics == 0) {
+        return TRANSPORT_DONE;
     }
-    return W_FALSE;
+
+    return subscribe(ctx, topics, topic_lengths, number_of_topics);
+}
+
+static void register_topic_handlers(wolk_ctx_t* ctx)
+{
+    char prefix[TOPIC_SIZE] = "";
+    char no_message_type[TOPIC_MESSAGE_TYPE_SIZE] = "";
+
+    /* Inbound topics are p2d/<device_key>/<message type> */
+    parser_create_topic(&ctx->parser, ctx->parser.P2D_TOPIC, ctx->device_key, no_message_type, prefix);
+    topic_router_init(&ctx->topic_router, prefix);
+
+    topic_router_add(&ctx->topic_router, ctx->parser.FEED_VALUES_MESSAGE_TOPIC, receive_feed_values, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.PARAMETERS_TOPIC, receive_parameters, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.SYNC_TIME_TOPIC, receive_time, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.ERROR_TOPIC, receive_error, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.DETAILS_SYNCHRONIZATION_TOPIC, receive_details_synchronization,
+                     ctx);
+
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_UPLOAD_INITIATE_TOPIC,
+                     receive_file_upload_initiate, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_BINARY_RESPONSE_TOPIC,
+                     receive_file_binary_response, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_UPLOAD_ABORT_TOPIC, receive_file_abort, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_INITIATE_TOPIC,
+                     receive_file_url_download_initiate, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_URL_DOWNLOAD_ABORT_TOPIC, receive_file_abort,
+                     ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_FILE_LIST_TOPIC, receive_file_list, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_FILE_DELETE_TOPIC, receive_file_delete, ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FILE_MANAGEMENT_FILE_PURGE_TOPIC, receive_file_purge, ctx);
+
+    topic_router_add(&ctx->topic_router, ctx->parser.FIRMWARE_UPDATE_INSTALL_TOPIC, receive_firmware_update_install,
+                     ctx);
+    topic_router_add(&ctx->topic_router, ctx->parser.FIRMWARE_UPDATE_ABORT_TOPIC, receive_firmware_update_abort, ctx);
+}
+
+static void receive_feed_values(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+
+    if (ctx->typed_feed_item_handler != NULL) {
+        parser_deserialize_typed_feeds_each(&ctx->parser, payload, payload_length, ctx->typed_feed_item_handler,
+                                            ctx->typed_feed_item_handler_context);
+    } else if (ctx->feed_item_handler != NULL) {
+        /* Only one feed is held at a time */
+        feed_t feed;
+        parser_deserialize_feeds_message_each(&ctx->parser, payload, payload_length, &feed, ctx->feed_item_handler,
+                                              ctx->feed_item_handler_context);
+    } else if (ctx->feed_handler != NULL) {
+        receive_feed_values_array(ctx, payload, payload_length);
+    }
+}
+
+static void receive_feed_values_array(wolk_ctx_t* ctx, char* payload, size_t payload_length)
+{
+    feed_t feeds_received[FEED_ELEMENT_SIZE];
+
+    const size_t number_of_deserialized_feeds =
+        parser_deserialize_feeds_message(&ctx->parser, payload, payload_length, feeds_received);
+    if (number_of_deserialized_feeds != 0) {
+        handle_feeds(ctx, feeds_received, number_of_deserialized_feeds);
+    }
+}
+
+static void receive_parameters(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+
+    if (ctx->parameter_item_handler != NULL) {
+        parameter_t parameter;
+        parser_deserialize_parameter_message_each(&ctx->parser, payload, payload_length, &parameter,
+                                                  ctx->parameter_item_handler, ctx->parameter_item_handler_context);
+    } else if (ctx->parameter_handler != NULL) {
+        receive_parameters_array(ctx, payload, payload_length);
+    }
+}
+
+static void receive_parameters_array(wolk_ctx_t* ctx, char* payload, size_t payload_length)
+{
+    parameter_t parameter_message[FEED_ELEMENT_SIZE];
+
+    const size_t number_of_deserialized_parameters =
+        parser_deserialize_parameter_message(&ctx->parser, payload, payload_length, parameter_message);
+    if (number_of_deserialized_parameters != 0) {
+        handle_parameter_message(ctx, parameter_message, number_of_deserialized_parameters);
+    }
+}
+
+static void receive_time(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    utc_command_t utc_command;
+
+    const size_t num_deserialized_commands =
+        parser_deserialize_time(&ctx->parser, payload, payload_length, &utc_command);
+    if (num_deserialized_commands != 0) {
+        handle_utc_command(ctx, &utc_command);
+    }
+}
+
+static void receive_error(void* context, char* payload, size_t payload_length)
+{
+    if (payload_length != 0) {
+        handle_error_message((wolk_ctx_t*)context, payload);
+    }
+}
+
+static void receive_details_synchronization(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    feed_registration_t feeds[FEED_ELEMENT_SIZE];
+    attribute_t attributes[FEED_ELEMENT_SIZE];
+    size_t number_of_feeds = 0;
+    size_t number_of_attributes = 0;
+
+    if (parser_deserialize_details_synchronization(&ctx->parser, payload, payload_length, feeds, &number_of_feeds,
+                                                   attributes, &number_of_attributes)) {
+        handle_details_synchronization_message(ctx, feeds, number_of_feeds, attributes, number_of_attributes);
+    }
+}
+
+static void receive_file_upload_initiate(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    file_management_parameter_t file_management_parameter;
+
+    const size_t num_deserialized_parameter =
+        parser_deserialize_file_management_parameter(&ctx->parser, payload, payload_length, &file_management_parameter);
+    if (num_deserialized_parameter != 0) {
+        handle_file_management_parameter(&ctx->file_management, &file_management_parameter);
+    }
+}
+
+static void receive_file_binary_response(void* context, char* payload, size_t payload_length)
+{
+    handle_file_management_packet(&((wolk_ctx_t*)context)->file_management, (uint8_t*)payload, payload_length);
+}
+
+static void receive_file_abort(void* context, char* payload, size_t payload_length)
+{
+    handle_file_management_abort(&((wolk_ctx_t*)context)->file_management, (uint8_t*)payload, payload_length);
+}
+
+static void receive_file_url_download_initiate(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    char url_download[FILE_MANAGEMENT_URL_SIZE] = {0};
+
+    if (parser_deserialize_url_download(&ctx->parser, payload, payload_length, url_download)) {
+        handle_file_management_url_download(&ctx->file_management, url_download);
+    }
+}
+
+static void receive_file_list(void* context, char* payload, size_t payload_length)
+{
+    WOLK_UNUSED(payload);
+    WOLK_UNUSED(payload_length);
+
+    handle_file_management_file_list(&((wolk_ctx_t*)context)->file_management);
+}
+
+static void receive_file_delete(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    file_list_t file_list[FILE_MANAGEMENT_FILE_LIST_SIZE];
+
+    const size_t number_deserialized = parser_deserialize_file_delete(&ctx->parser, payload, payload_length, file_list);
+    if (number_deserialized) {
+        handle_file_management_file_delete(&ctx->file_management, file_list, number_deserialized);
+    }
+}
+
+static void receive_file_purge(void* context, char* payload, size_t payload_length)
+{
+    WOLK_UNUSED(payload);
+    WOLK_UNUSED(payload_length);
+
+    handle_file_management_file_purge(&((wolk_ctx_t*)context)->file_management);
+}
+
+static void receive_firmware_update_install(void* context, char* payload, size_t payload_length)
+{
+    wolk_ctx_t* ctx = (wolk_ctx_t*)context;
+    firmware_update_t firmware_update_parameter;
+
+    if (parse_deserialize_firmware_update_parameter(&ctx->parser, payload, payload_length,
+                                                    &firmware_update_parameter)) {
+        handle_firmware_update_installation(&ctx->firmware_update, &firmware_update_parameter);
+    }
+}
+
+static void receive_firmware_update_abort(void* context, char* payload, size_t payload_length)
+{
+    WOLK_UNUSED(payload);
+    WOLK_UNUSED(payload_length);
+
+    handle_firmware_update_abort(&((wolk_ctx_t*)context)->firmware_update);
 }
@@ -30,11 +30,19 @@ extern "C" {
 #include "MQTTPacket.h"
 #include "connectivity/data_transmission.h"
 #include "model/attribute.h"
+#include "model/feed_aggregation.h"
+#include "model/feed_filter.h"
 #include "model/file_management/file_management.h"
 #include "model/utc_command.h"
+#include "persistence/in_memory_packed_persistence.h"
+#include "persistence/in_memory_persistence.h"
+#include "persistence/mmap_log_persistence.h"
 #include "persistence/persistence.h"
 #include "protocol/parser.h"
+#include "protocol/topic_router.h"
 #include "size_definitions.h"
+#include "utility/dtoa.h"
+#include "utility/reference_table.h"
 #include "wolk_types.h"
 
 #include <stdbool.h>
@@ -77,6 +85,7 @@ typedef struct wolk_boolean_feeds_t {
 } wolk_boolean_feeds_t;
 
 typedef feed_t wolk_feed_t;
+typedef typed_feed_t wolk_typed_feed_t;
 typedef feed_registration_t wolk_feed_registration_t;
 typedef parameter_t wolk_parameter_t;
 typedef attribute_t wolk_attribute_t;
@@ -91,6 +100,16 @@ typedef int (*send_func_t)(unsigned char* bytes, unsigned int num_bytes);
  */
 typedef int (*recv_func_t)(unsigned char* bytes, unsigned int num_bytes);
 
+/**
+ * @brief Callback declaration for writting bytes to socket of connection identified by 'context'
+ */
+typedef int (*send_with_context_func_t)(void* context, unsigned char* bytes, unsigned int num_bytes);
+
+/**
+ * @brief Callback declaration for reading bytes from socket of connection identified by 'context'
+ */
+typedef int (*recv_with_context_func_t)(void* context, unsigned char* bytes, unsigned int num_bytes);
+
 /**
  * @brief Declaration of feed value handler.
  *
@@ -107,6 +126,31 @@ typedef void (*feed_handler_t)(wolk_feed_t* feeds, size_t number_of_feeds);
  */
 typedef void (*parameter_handler_t)(wolk_parameter_t* parameter_message, size_t number_of_parameters);
 
+/**
+ * @brief Declaration of handler which receives incoming feeds one at a time, without buffering the whole message.
+ *
+ * @param context Context given to wolk_set_feed_item_handler()
+ * @param feed Received feed, valid only during the call
+ */
+typedef void (*feed_item_handler_t)(void* context, wolk_feed_t* feed);
+
+/**
+ * @brief Declaration of handler which receives incoming feeds one at a time in their native type: numeric values as
+ * double, booleans as bool and anything else as string referencing the received message.
+ *
+ * @param context Context given to wolk_set_typed_feed_item_handler()
+ * @param feed Received feed, valid only during the call
+ */
+typedef void (*typed_feed_item_handler_t)(void* context, const wolk_typed_feed_t* feed);
+
+/**
+ * @brief Declaration of handler which receives incoming parameters one at a time, without buffering the whole message.
+ *
+ * @param context Context given to wolk_set_parameter_item_handler()
+ * @param parameter Received parameter, valid only during the call
+ */
+typedef void (*parameter_item_handler_t)(void* context, wolk_parameter_t* parameter);
+
 /**
  * @brief Declaration of details synchronization handler. It will be called as a response on the
  * wolk_details_synchronization() call. It will give list of the all feeds and attributes from the platform.
@@ -118,15 +162,65 @@ typedef void (*details_synchronization_handler_t)(wolk_feed_registration_t* feed
                                                   wolk_attribute_t* attributes, size_t number_of_received_attributes);
 
 
+/**
+ * @brief Number of decimals values of a numeric feed are rounded to. @see wolk_set_numeric_feed_precision()
+ */
+typedef struct {
+    char reference[REFERENCE_SIZE];
+    uint8_t decimals;
+} numeric_feed_precision_t;
+
+/**
+ * @brief Handle of feed reference returned by wolk_feed_intern()
+ */
+typedef int16_t wolk_feed_handle_t;
+
+#define WOLK_FEED_HANDLE_INVALID ((wolk_feed_handle_t)-1)
+
+/**
+ * @brief Feed reference interned by wolk_feed_intern(), serialized once along with settings which apply to it.
+ */
+typedef struct {
+    char reference[REFERENCE_SIZE];
+    char key[FEED_KEY_SIZE]; /**< Reference serialized as it precedes the value */
+    size_t key_length;       /**< Zero if serialized reference does not fit into key */
+
+    uint32_t settings_generation; /**< Settings below are looked up again once the one of context changes */
+    int8_t decimals;
+    feed_filter_t* filter;
+    feed_aggregation_t* aggregation;
+} interned_feed_t;
+
+/**
+ * @brief Outbound packet whose sending is in progress, determines what is done once it is completely sent.
+ */
+typedef enum {
+    OUTBOUND_PACKET_NONE = 0,
+    OUTBOUND_PACKET_PERSISTED, /**< Message from persistence, removed from persistence once sent */
+    OUTBOUND_PACKET_PING,      /**< Keep alive ping, restarts keep alive period once sent */
+    OUTBOUND_PACKET_SUBSCRIBE, /**< Subscription to topics of inbound messages */
+    OUTBOUND_PACKET_CONTROL    /**< Message from control queue, removed from control queue once sent */
+} outbound_packet_t;
+
 /**
  * @brief  WolkAbout IoT Platform connector context.
  * Most of the parameters are used to initialize WolkConnect library forwarding to wolk_init().
  */
 typedef struct wolk_ctx {
-    int sock;
     MQTTPacket_connectData connectData;
     MQTTTransport mqtt_transport;
-    transmission_io_functions_t iof;
+    transmission_t transmission; /**< Send/receive functions and write in progress of this connection */
+
+    unsigned char inbound_packet[MQTT_PACKET_SIZE];  /**< Packet being received */
+    unsigned char outbound_packet[MQTT_PACKET_SIZE]; /**< Serialized packet whose sending is in progress */
+    outbound_packet_t outbound_packet_type; /**< Type of packet in outbound_packet, OUTBOUND_PACKET_NONE if idle */
+    uint32_t outbound_persisted_id; /**< Persistence head identity of OUTBOUND_PACKET_PERSISTED packet being sent */
+
+    unsigned char control_queue_storage[CONTROL_QUEUE_SIZE];
+    in_memory_packed_persistence_t control_queue; /**< Connector's own messages, sent ahead of persisted messages */
+
+    bool is_subscribing;      /**< Topic routes from next_subscription on are yet to be subscribed to */
+    size_t next_subscription; /**< Index of the first topic route not subscribed to on this connection */
 
     outbound_mode_t outbound_mode;
 
@@ -136,6 +230,13 @@ typedef struct wolk_ctx {
     parameter_handler_t parameter_handler; /**< Callback for handling received configuration from WolkAbout IoT
                                                       Platform. @see parameter_handler_t*/
 
+    feed_item_handler_t feed_item_handler; /**< Replaces feed_handler when set. @see feed_item_handler_t */
+    void* feed_item_handler_context;
+    typed_feed_item_handler_t typed_feed_item_handler; /**< Replaces feed_item_handler when set */
+    void* typed_feed_item_handler_context;
+    parameter_item_handler_t parameter_item_handler; /**< Replaces parameter_handler when set */
+    void* parameter_item_handler_context;
+
     details_synchronization_handler_t details_synchronization_handler; /**< Callback for handling received details
 configuration from WolkAbout IoT Platform. @see attribute_handler_t*/
 
@@ -151,6 +252,26 @@ configuration from WolkAbout IoT Platform. @see attribute_handler_t*/
     parser_t parser;
 
     persistence_t persistence;
+    union {
+        in_memory_persistence_t in_memory;
+        in_memory_packed_persistence_t in_memory_packed;
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+        mmap_log_persistence_t mmap_log;
+#endif
+    } persistence_instance; /**< State of built-in persistence implementation, used as persistence context */
+
+    topic_router_t topic_router; /**< Handlers of inbound messages by message type */
+
+    numeric_feed_precision_t numeric_feed_precision_storage[NUMERIC_FEED_PRECISIONS_MAX];
+    reference_table_t numeric_feed_precisions; /**< Numeric feeds which are not formatted in shortest form */
+
+    reference_table_t feed_filters; /**< Feeds reported by exception. @see wolk_init_feed_filters() */
+    feed_aggregation_t feed_aggregation_storage[FEED_AGGREGATIONS_MAX];
+    reference_table_t feed_aggregations; /**< @see wolk_set_feed_aggregation() */
+    uint64_t uptime; /**< Sum of wolk_process() ticks, time of feed values without UTC time */
+
+    reference_table_t interned_feeds; /**< Slot index is wolk_feed_handle_t. @see wolk_init_feed_handles() */
+    uint32_t feed_settings_generation; /**< Changed by every change of feed precision, filter or aggregation */
 
     file_management_t file_management;
 
@@ -161,13 +282,25 @@ configuration from WolkAbout IoT Platform. @see attribute_handler_t*/
     bool is_initialized;
 } wolk_ctx_t;
 
+/**
+ * @brief Feed values of many references collected into as few messages as possible.
+ * @see wolk_feed_batch_begin()
+ */
+typedef struct {
+    wolk_ctx_t* ctx;
+
+    outbound_message_t message; /**< Message being filled */
+    size_t length;              /**< Length of the payload serialized so far */
+    size_t number_of_feeds;     /**< Number of feeds in message */
+} wolk_feed_batch_t;
+
 /**
  * @brief Initializes WolkAbout IoT Platform connector context
  *
  * @param ctx Context
  *
- * @param snd_func Callback function that handles outgoing traffic
- * @param rcv_func Callback function that handles incoming traffic
+ * @param snd_func Callback function that handles outgoing traffic, NULL if wolk_init_transport_context() is used
+ * @param rcv_func Callback function that handles incoming traffic, NULL if wolk_init_transport_context() is used
  *
  * @param device_key Device key provided by WolkAbout IoT Platform upon device
  * creation
@@ -187,6 +320,21 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
                      parameter_handler_t parameter_handler,
                      details_synchronization_handler_t details_synchronization_handler);
 
+/**
+ * @brief Replaces send and receive functions given to wolk_init with ones which receive 'context', so that single set
+ * of functions can serve many connections. Must be called after wolk_init, which then may be given NULL send and
+ * receive functions, and before wolk_connect, which fails if neither set of functions is given
+ *
+ * @param ctx Context
+ * @param context Connection identifier passed as first argument to 'snd_func' and 'rcv_func'
+ * @param snd_func Callback function that handles outgoing traffic
+ * @param rcv_func Callback function that handles incoming traffic
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_init_transport_context(wolk_ctx_t* ctx, void* context, send_with_context_func_t snd_func,
+                                       recv_with_context_func_t rcv_func);
+
 /**
  * @brief Initializes persistence mechanism with in-memory implementation
  *
@@ -200,10 +348,46 @@ WOLK_ERR_T wolk_init(wolk_ctx_t* ctx, send_func_t snd_func, recv_func_t rcv_func
  */
 WOLK_ERR_T wolk_init_in_memory_persistence(wolk_ctx_t* ctx, void* storage, uint32_t size, bool wrap);
 
+/**
+ * @brief Initializes persistence mechanism with in-memory implementation which packs messages as variable-length
+ * records, so small messages occupy only as much of the storage as their topic and payload need.
+ * Topics of device's messages are stored as 2 byte IDs
+ *
+ * @param ctx Context
+ * @param storage Address to start of the memory which will be used by
+ * persistence mechanism
+ * @param size Size of memory in bytes
+ * @param wrap If storage is full overwrite oldest item(s) when pushing new item
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_init_in_memory_packed_persistence(wolk_ctx_t* ctx, void* storage, uint32_t size, bool wrap);
+
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+/**
+ * @brief Initializes persistence mechanism with file backed implementation, which appends messages to memory mapped
+ * segment files and survives restarts. Topics of device's messages are stored as 2 byte IDs, so log has to be reopened
+ * by the same device
+ *
+ * @param ctx Context
+ * @param directory Directory where segment files are kept
+ * @param segment_size Size of single segment file in bytes, has to fit the largest message
+ * @param max_segments Maximum number of segment files, at least 2
+ * @param wrap If all segments are full discard the oldest segment when pushing new item
+ *
+ * @return Error code
+ *
+ * @see mmap_log_persistence.h for durability guarantees
+ */
+WOLK_ERR_T wolk_init_mmap_log_persistence(wolk_ctx_t* ctx, const char* directory, uint32_t segment_size,
+                                          uint32_t max_segments, bool wrap);
+#endif
+
 /**
  * @brief Initializes persistence mechanism with custom implementation
  *
  * @param ctx Context
+ * @param context Custom persistence instance, passed as first argument to every persistence function
  * @param push Function pointer to 'push' implementation
  * @param peek Function pointer to 'peek' implementation
  * @param pop Function pointer to 'pop' implementation
@@ -213,9 +397,58 @@ WOLK_ERR_T wolk_init_in_memory_persistence(wolk_ctx_t* ctx, void* storage, uint3
  *
  * @see persistence.h for signatures of methods to be implemented, and
  * implementation contract
+ * @see packed_record.h for storing messages as records, which refer to topics in ctx->parser.outbound_topics by ID
+ * unless they outlive the process
+ */
+WOLK_ERR_T wolk_init_custom_persistence(wolk_ctx_t* ctx, void* context, persistence_push_t push,
+                                        persistence_peek_t peek, persistence_pop_t pop,
+                                        persistence_is_empty_t is_empty);
+
+/**
+ * @brief Enables publishing directly from custom persistence storage, without copying messages out of it.
+ * Must be called after wolk_init_custom_persistence
+ *
+ * @param ctx Context
+ * @param peek_view Function pointer to 'peek view' implementation
+ * @param drop Function pointer to 'drop' implementation
+ *
+ * @return Error code
+ *
+ * @see persistence.h for signatures of methods to be implemented, and
+ * implementation contract
+ */
+WOLK_ERR_T wolk_init_custom_persistence_view(wolk_ctx_t* ctx, persistence_peek_view_t peek_view,
+                                             persistence_drop_t drop);
+
+/**
+ * @brief Provides batched 'peek n' and 'pop n' implementations for custom persistence. Either can be NULL, in which
+ * case it is emulated with single item calls. Must be called after wolk_init_custom_persistence
+ *
+ * @param ctx Context
+ * @param peek_n Function pointer to 'peek n' implementation
+ * @param pop_n Function pointer to 'pop n' implementation
+ *
+ * @return Error code
+ *
+ * @see persistence.h for signatures of methods to be implemented, and
+ * implementation contract
+ */
+WOLK_ERR_T wolk_init_custom_persistence_batch(wolk_ctx_t* ctx, persistence_peek_n_t peek_n, persistence_pop_n_t pop_n);
+
+/**
+ * @brief Provides identity of the oldest item for custom persistence. Must be provided by persistence which discards
+ * the oldest items when full, otherwise message which was discarded while being sent is mistaken for the next one,
+ * which is then removed without being sent. Must be called after wolk_init_custom_persistence
+ *
+ * @param ctx Context
+ * @param head_id Function pointer to 'head id' implementation
+ *
+ * @return Error code
+ *
+ * @see persistence.h for signatures of methods to be implemented, and
+ * implementation contract
  */
-WOLK_ERR_T wolk_init_custom_persistence(wolk_ctx_t* ctx, persistence_push_t push, persistence_peek_t peek,
-                                        persistence_pop_t pop, persistence_is_empty_t is_empty);
+WOLK_ERR_T wolk_init_custom_persistence_head_id(wolk_ctx_t* ctx, persistence_head_id_t head_id);
 
 /**
  * @brief Initializes File Management
@@ -242,6 +475,49 @@ WOLK_ERR_T wolk_init_file_management(
     file_management_is_url_download_done_t is_url_download_done, file_management_get_file_list_t get_file_list,
     file_management_remove_file_t remove_file, file_management_purge_files_t purge_files);
 
+/**
+ * @brief Pipelines file transfer, by keeping up to 'window_size' chunk requests outstanding. Must be called after
+ * wolk_init_file_management, while no file is being transferred
+ *
+ * @param ctx Context
+ * @param window_size Number of outstanding chunk requests, 1 requests next chunk once previous one is written
+ * @param storage Memory where chunks which arrive out of order wait to be written
+ * @param storage_size Size of storage in bytes, at least ('window_size' - 1) * ('chunk_size' + 2 *
+ * FILE_MANAGEMENT_HASH_SIZE)
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_file_management_window(wolk_ctx_t* ctx, size_t window_size, void* storage, size_t storage_size);
+
+/**
+ * @brief Transferred file is hashed as its chunks are written. Enabling read back verification additionally reads
+ * whole file back through 'read_chunk' and verifies its hash once transfer completes
+ *
+ * @param ctx Context
+ * @param enabled true to read file back after transfer, false by default
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_file_management_read_back_verification(wolk_ctx_t* ctx, bool enabled);
+
+/**
+ * @brief Persists file transfer progress after every written chunk, so that wolk_connect resumes transfer interrupted
+ * by device restart from the last written chunk. Transfer interrupted only by lost connection is resumed on
+ * wolk_connect regardless
+ *
+ * @param ctx Context
+ * @param store Function pointer to 'file_management_transfer_state_store' implementation, NULL disables persistence
+ * @param read Function pointer to 'file_management_transfer_state_read' implementation
+ * @param resume Function pointer to 'file_management_transfer_resume' implementation, which truncates file to the
+ * stored progress before transfer continues. Transfer is not restored after restart without it
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_file_management_transfer_persistence(wolk_ctx_t* ctx,
+                                                        file_management_transfer_state_store_t store,
+                                                        file_management_transfer_state_read_t read,
+                                                        file_management_transfer_resume_t resume);
+
 /**
  * @brief Initializes Firmware Update
  *
@@ -269,8 +545,10 @@ WOLK_ERR_T wolk_init_firmware_update(wolk_ctx_t* ctx, firmware_update_start_inst
  *  parameter_handler_t parameter_handler, details_synchronization_handler_t details_synchronization_handler)
  *  2. Persistence must be initialized using
  *      wolk_init_in_memory_persistence(wolk_ctx_t* ctx, void* storage, uint32_t size, bool wrap) or
- *      wolk_init_custom_persistence(wolk_ctx_t* ctx, persistence_push_t push, persistence_peek_t peek,
- *      persistence_pop_t pop, persistence_is_empty_t is_empty)
+ *      wolk_init_custom_persistence(wolk_ctx_t* ctx, void* context, persistence_push_t push,
+ *      persistence_peek_t peek, persistence_pop_t pop, persistence_is_empty_t is_empty)
+ *
+ * Subscriptions which connection does not accept at once are sent by following wolk_process() calls.
  *
  * @param ctx Context
  *
@@ -291,6 +569,11 @@ WOLK_ERR_T wolk_disconnect(wolk_ctx_t* ctx);
  * @brief Must be called periodically to keep alive connection to WolkAbout IoT
  * platform, obtain and perform incoming traffic
  *
+ * Packet which could not be sent at once is kept and sending is resumed on next wolk_process() or wolk_publish() call,
+ * instead of waiting for the connection to accept it.
+ * Subscriptions and messages of file management and firmware update wait in control queue for the packet in progress,
+ * and are sent ahead of persisted messages.
+ *
  * @param ctx Context
  * @param tick Period at which wolk_process is called
  *
@@ -319,6 +602,8 @@ WOLK_ERR_T wolk_init_feed(feed_registration_t* feed, char* name, const char* ref
  * be in milliseconds.
  * @param number_of_feeds Number of feeds that is captured
  *
+ * Feeds which do not fit into one message are split across as many messages as needed.
+ *
  *  @return Error code
  */
 WOLK_ERR_T wolk_add_string_feed(wolk_ctx_t* ctx, const char* reference, wolk_string_feeds_t* feeds,
@@ -333,6 +618,8 @@ WOLK_ERR_T wolk_add_string_feed(wolk_ctx_t* ctx, const char* reference, wolk_str
  * milliseconds.
  * @param number_of_feeds Number of feeds that is captured
  *
+ * Feeds which do not fit into one message are split across as many messages as needed.
+ *
  * @return Error code
  */
 WOLK_ERR_T wolk_add_numeric_feed(wolk_ctx_t* ctx, const char* reference, wolk_numeric_feeds_t* feeds,
@@ -340,12 +627,12 @@ WOLK_ERR_T wolk_add_numeric_feed(wolk_ctx_t* ctx, const char* reference, wolk_nu
 
 /**
  * @brief Add multi-value numeric feed. For feeds that has more than one numeric number associated as value, like
- * location is. Max number of numeric values is define with FEEDS_MAX_NUMBER from size_definition
+ * location is. All values are sent in one message, so their number is limited only by PAYLOAD_SIZE
  *
  * @param ctx Context
  * @param reference Feed reference
  * @param values Feed values
- * @param value_size Number of numeric values limited by FEEDS_MAX_NUMBER
+ * @param value_size Number of numeric values
  * @param utc_time UTC time of feed value acquisition [miliseconds]
  *
  * @return Error code
@@ -362,21 +649,290 @@ WOLK_ERR_T wolk_add_multi_value_numeric_feed(wolk_ctx_t* ctx, const char* refere
  * milliseconds.
  * @param number_of_feeds Number of feeds that is captured
  *
+ * Feeds which do not fit into one message are split across as many messages as needed.
+ *
  * @return Error code
  */
 WOLK_ERR_T wolk_add_bool_feeds(wolk_ctx_t* ctx, const char* reference, wolk_boolean_feeds_t* feeds,
                                size_t number_of_feeds);
 
+/**
+ * @brief Provides storage for references interned by wolk_feed_intern(), one per interned reference. References are
+ * placed by their hash, keeping a few feeds free shortens interning. References interned before are discarded, and
+ * their handles become invalid.
+ *
+ * @param ctx Context
+ * @param feeds Storage which has to outlive the context
+ * @param number_of_feeds Number of feeds in storage, up to INT16_MAX
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_init_feed_handles(wolk_ctx_t* ctx, interned_feed_t* feeds, size_t number_of_feeds);
+
+/**
+ * @brief Interns feed reference for adding values by handle. Reference is copied and serialized once, precision,
+ * filter and aggregation set for it are looked up only after they change, so adding values by handle does no string
+ * copies or comparisons. Interning the same reference again returns the same handle.
+ *
+ * @param ctx Context
+ * @param reference Feed reference
+ *
+ * @return Handle, WOLK_FEED_HANDLE_INVALID if there is no free feed in storage given to wolk_init_feed_handles()
+ */
+wolk_feed_handle_t wolk_feed_intern(wolk_ctx_t* ctx, const char* reference);
+
+/**
+ * @brief Same as wolk_add_string_feed(), for interned reference
+ */
+WOLK_ERR_T wolk_add_string_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_string_feeds_t* feeds,
+                                          size_t number_of_feeds);
+
+/**
+ * @brief Same as wolk_add_numeric_feed(), for interned reference
+ */
+WOLK_ERR_T wolk_add_numeric_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_numeric_feeds_t* feeds,
+                                           size_t number_of_feeds);
+
+/**
+ * @brief Same as wolk_add_multi_value_numeric_feed(), for interned reference
+ */
+WOLK_ERR_T wolk_add_multi_value_numeric_feed_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, double* values,
+                                                       uint16_t value_size, uint64_t utc_time);
+
+/**
+ * @brief Same as wolk_add_bool_feeds(), for interned reference
+ */
+WOLK_ERR_T wolk_add_bool_feeds_by_handle(wolk_ctx_t* ctx, wolk_feed_handle_t handle, wolk_boolean_feeds_t* feeds,
+                                         size_t number_of_feeds);
+
+/**
+ * @brief Starts batch of feed values. Values of any number of references added with wolk_feed_batch_add_*() are
+ * packed into feed values messages as long as they fit into PAYLOAD_SIZE; full message is stored to persistence and
+ * the next one is started. wolk_feed_batch_commit() stores the last message.
+ *
+ * @param ctx Context
+ * @param batch Batch, which has to stay in scope until it is committed
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_feed_batch_begin(wolk_ctx_t* ctx, wolk_feed_batch_t* batch);
+
+/**
+ * @brief Adds numeric value to batch, formatted with the precision set for reference
+ *
+ * @param batch Batch
+ * @param reference Feed reference
+ * @param value Feed value
+ * @param utc_time UTC time of value acquisition in milliseconds, 0 to omit it
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_feed_batch_add_numeric(wolk_feed_batch_t* batch, const char* reference, double value,
+                                       uint64_t utc_time);
+
+/**
+ * @brief Adds value of multi-value numeric feed to batch. @see wolk_add_multi_value_numeric_feed()
+ */
+WOLK_ERR_T wolk_feed_batch_add_multi_value_numeric(wolk_feed_batch_t* batch, const char* reference,
+                                                   const double* values, uint16_t value_size, uint64_t utc_time);
+
+/**
+ * @brief Adds boolean value to batch. @see wolk_feed_batch_add_numeric()
+ */
+WOLK_ERR_T wolk_feed_batch_add_bool(wolk_feed_batch_t* batch, const char* reference, bool value, uint64_t utc_time);
+
+/**
+ * @brief Adds string value to batch. @see wolk_feed_batch_add_numeric()
+ */
+WOLK_ERR_T wolk_feed_batch_add_string(wolk_feed_batch_t* batch, const char* reference, const char* value,
+                                      uint64_t utc_time);
+
+/**
+ * @brief Same as wolk_feed_batch_add_numeric(), for interned reference. @see wolk_feed_intern()
+ */
+WOLK_ERR_T wolk_feed_batch_add_numeric_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle, double value,
+                                                 uint64_t utc_time);
+
+/**
+ * @brief Same as wolk_feed_batch_add_multi_value_numeric(), for interned reference
+ */
+WOLK_ERR_T wolk_feed_batch_add_multi_value_numeric_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle,
+                                                             const double* values, uint16_t value_size,
+                                                             uint64_t utc_time);
+
+/**
+ * @brief Same as wolk_feed_batch_add_bool(), for interned reference
+ */
+WOLK_ERR_T wolk_feed_batch_add_bool_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle, bool value,
+                                              uint64_t utc_time);
+
+/**
+ * @brief Same as wolk_feed_batch_add_string(), for interned reference
+ */
+WOLK_ERR_T wolk_feed_batch_add_string_by_handle(wolk_feed_batch_t* batch, wolk_feed_handle_t handle,
+                                                const char* value, uint64_t utc_time);
+
+/**
+ * @brief Stores values added to batch which are not stored yet to persistence. Batch can be reused afterwards.
+ *
+ * @param batch Batch
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_feed_batch_commit(wolk_feed_batch_t* batch);
+
 /**
  * @brief Publish all accumulated data from persistence. It can be any data(feeds, attributed or parameters) added after
  * last publish.
  *
+ * Publishing does not wait for the connection to accept data. When message can not be sent at once, publishing stops
+ * without error and is resumed on next wolk_publish() or wolk_process() call, use wolk_is_publish_in_progress() to
+ * check if message is still being sent. Message is removed from persistence only after it is completely sent.
+ *
  * @param ctx Context
  *
  * @return Error code
  */
 WOLK_ERR_T wolk_publish(wolk_ctx_t* ctx);
 
+/**
+ * @brief Sets handler which receives incoming feeds one at a time as they are deserialized, instead of feed_handler
+ * given to wolk_init() which receives all feeds of a message at once. Memory needed for receiving feeds is then
+ * bounded to a single feed. Pass NULL to use feed_handler again.
+ *
+ * @param ctx Context
+ * @param handler Function called for every received feed
+ * @param context Passed to the handler
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_feed_item_handler(wolk_ctx_t* ctx, feed_item_handler_t handler, void* context);
+
+/**
+ * @brief Sets handler which receives incoming feeds one at a time in their native type, instead of feed_item_handler
+ * and feed_handler. Values are not copied nor converted to text. Pass NULL to use the other handlers again.
+ *
+ * @param ctx Context
+ * @param handler Function called for every received feed
+ * @param context Passed to the handler
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_typed_feed_item_handler(wolk_ctx_t* ctx, typed_feed_item_handler_t handler, void* context);
+
+/**
+ * @brief Sets handler which receives incoming parameters one at a time as they are deserialized, instead of
+ * parameter_handler given to wolk_init(). Pass NULL to use parameter_handler again.
+ *
+ * @param ctx Context
+ * @param handler Function called for every received parameter
+ * @param context Passed to the handler
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_set_parameter_item_handler(wolk_ctx_t* ctx, parameter_item_handler_t handler, void* context);
+
+/**
+ * @brief Registers handler for inbound messages on topic p2d/<device_key>/<message_type>, replacing the existing one.
+ * Topic is subscribed to on the next wolk_connect() call, so handler should be registered before connecting.
+ *
+ * @param ctx Context
+ * @param message_type Last level of the topic
+ * @param handler Function called with the payload of every received message
+ * @param context Passed to the handler
+ *
+ * @return Error code, W_TRUE if there are already TOPIC_ROUTES_MAX message types with a handler
+ */
+WOLK_ERR_T wolk_register_topic_handler(wolk_ctx_t* ctx, const char* message_type, topic_handler_t handler,
+                                       void* context);
+
+/**
+ * @brief Sets number of decimals values of numeric feed are rounded to when added with wolk_add_numeric_feed() or
+ * wolk_add_multi_value_numeric_feed(). Trailing zeros of the fraction are omitted. Values of feeds without precision
+ * are written in the shortest form which reads back to the same double.
+ *
+ * @param ctx Context
+ * @param reference Feed reference
+ * @param decimals Number of decimals up to DTOA_FIXED_DECIMALS_MAX, negative to use the shortest form again
+ *
+ * Precision can be set for up to NUMERIC_FEED_PRECISIONS_MAX feeds, see size_definitions.h.
+ *
+ * @return Error code, W_TRUE if precision is already set for NUMERIC_FEED_PRECISIONS_MAX feeds
+ */
+WOLK_ERR_T wolk_set_numeric_feed_precision(wolk_ctx_t* ctx, const char* reference, int decimals);
+
+/**
+ * @brief Provides storage for filters set by wolk_set_feed_filter(), one filter per filtered feed. Filters are looked
+ * up by hash of the reference, keeping a few filters free shortens the lookup. Filters set before are discarded.
+ *
+ * @param ctx Context
+ * @param filters Storage which has to outlive the context
+ * @param number_of_filters Number of filters in storage
+ *
+ * @return Error code
+ */
+WOLK_ERR_T wolk_init_feed_filters(wolk_ctx_t* ctx, feed_filter_t* filters, size_t number_of_filters);
+
+/**
+ * @brief Reports values of feed by exception. Values added with wolk_add_*_feed() and wolk_feed_batch_add_*() are
+ * dropped instead of being pushed, unless they change beyond every set deadband since the last reported value or
+ * 'max_silence' elapsed, and never before 'min_interval' elapses. Numeric and boolean values are compared against
+ * deadbands, any change of string or multi-value numeric value is reported.
+ *
+ * Time of values is their UTC time, or time counted by wolk_process() ticks for values without it.
+ *
+ * @param ctx Context
+ * @param reference Feed reference
+ * @param settings Deadbands and intervals in milliseconds, zero disables a setting. NULL reports every value again.
+ *
+ * @return Error code, W_TRUE if there is no free filter in storage given to wolk_init_feed_filters()
+ */
+WOLK_ERR_T wolk_set_feed_filter(wolk_ctx_t* ctx, const char* reference, const feed_filter_settings_t* settings);
+
+/**
+ * @brief Aggregates values of numeric feed over windows. Values added with wolk_add_numeric_feed() and
+ * wolk_feed_batch_add_numeric() are accumulated instead of being pushed, and one reading of each window is pushed once
+ * a value of the next window is added. Reading is timestamped with the start of the window.
+ *
+ * Windows of values without UTC time are timed by wolk_process() ticks and closed by wolk_process() once they end.
+ * Windows of values with UTC time are closed by wolk_process() once they were open for 'window' milliseconds of
+ * ticks, unless a value of the next window closes them earlier. Value added after its window was closed opens it
+ * again, and its reading is pushed separately. Readings are subject to feed filter and precision of the feed.
+ *
+ * @param ctx Context
+ * @param reference Feed reference
+ * @param type Value reported for each window, FEED_AGGREGATION_SUMMARY reports multi-value reading of minimum,
+ * maximum, average and count
+ * @param window Length of window in milliseconds, zero stops aggregating. Reading of the window open when aggregation
+ * is set again or stopped is pushed first
+ *
+ * Aggregation can be set for up to FEED_AGGREGATIONS_MAX feeds, see size_definitions.h.
+ *
+ * @return Error code, W_TRUE if aggregation is already set for FEED_AGGREGATIONS_MAX feeds
+ */
+WOLK_ERR_T wolk_set_feed_aggregation(wolk_ctx_t* ctx, const char* reference, feed_aggregation_type_t type,
+                                     uint64_t window);
+
+/**
+ * @brief Pushes readings of all open aggregation windows without waiting for them to end, e.g. before device goes to
+ * sleep or shuts down. Aggregation continues with the next value added.
+ *
+ * @param ctx Context
+ *
+ * @return Error code, W_TRUE if a reading could not be pushed
+ */
+WOLK_ERR_T wolk_flush_feed_aggregations(wolk_ctx_t* ctx);
+
+/**
+ * @brief Checks if sending of a packet was started and is waiting for the connection to accept the rest of it, or if
+ * subscriptions or control messages wait to be sent
+ *
+ * @param ctx Context
+ *
+ * @return W_TRUE if packet is being sent or waits to be sent, W_FALSE otherwise
+ */
+WOLK_BOOL_T wolk_is_publish_in_progress(wolk_ctx_t* ctx);
+
 /**
  * @brief Initialized attribute
  *
@@ -396,6 +952,8 @@ WOLK_ERR_T wolk_init_attribute(wolk_attribute_t* attribute, char* name, char* da
  * @param attributes Attribute description consists of name, data type and value.
  * @param number_of_attributes Number of attributes that is captured
  *
+ * Attributes which do not fit into one message are split across as many messages as needed.
+ *
  * @return Error code
  */
 WOLK_ERR_T wolk_register_attribute(wolk_ctx_t* ctx, wolk_attribute_t* attributes, size_t number_of_attributes);
@@ -409,6 +967,8 @@ WOLK_ERR_T wolk_register_attribute(wolk_ctx_t* ctx, wolk_attribute_t* attributes
  * responsibility.
  * @param number_of_feeds Number of feeds presented into feeds list
  *
+ * Feeds which do not fit into one message are split across as many messages as needed.
+ *
  * @return Error code
  */
 WOLK_ERR_T wolk_register_feed(wolk_ctx_t* ctx, feed_registration_t* feeds, size_t number_of_feeds);
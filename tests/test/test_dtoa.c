@@ -0,0 +1,92 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "utility/dtoa.h"
+
+
+static char buffer[DTOA_BUFFER_SIZE];
+
+void setUp(void)
+{
+    memset(buffer, 'x', sizeof(buffer));
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_dtoa_shortest_formats(void)
+{
+    TEST_ASSERT_EQUAL_INT(1, dtoa_shortest(0.0, buffer));
+    TEST_ASSERT_EQUAL_STRING("0", buffer);
+
+    dtoa_shortest(42.0, buffer);
+    TEST_ASSERT_EQUAL_STRING("42", buffer);
+
+    dtoa_shortest(0.1, buffer);
+    TEST_ASSERT_EQUAL_STRING("0.1", buffer);
+
+    TEST_ASSERT_EQUAL_INT(7, dtoa_shortest(-273.15, buffer));
+    TEST_ASSERT_EQUAL_STRING("-273.15", buffer);
+
+    dtoa_shortest(0.000001, buffer);
+    TEST_ASSERT_EQUAL_STRING("0.000001", buffer);
+
+    dtoa_shortest(1.5e-7, buffer);
+    TEST_ASSERT_EQUAL_STRING("1.5e-7", buffer);
+
+    dtoa_shortest(1e21, buffer);
+    TEST_ASSERT_EQUAL_STRING("1e21", buffer);
+
+    dtoa_shortest(1.7976931348623157e308, buffer);
+    TEST_ASSERT_EQUAL_STRING("1.7976931348623157e308", buffer);
+
+    dtoa_shortest(5e-324, buffer);
+    TEST_ASSERT_EQUAL_STRING("5e-324", buffer);
+}
+
+void test_dtoa_shortest_reads_back_to_same_value(void)
+{
+    double value = 1.0 / 3.0;
+    for (int i = 0; i < 1000; ++i) {
+        value *= -1.7;
+        dtoa_shortest(value, buffer);
+
+        const double read = strtod(buffer, NULL);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(&read, &value, sizeof(value)));
+    }
+}
+
+void test_dtoa_fixed_rounds_to_decimals(void)
+{
+    dtoa_fixed(21.456, 2, buffer);
+    TEST_ASSERT_EQUAL_STRING("21.46", buffer);
+
+    dtoa_fixed(21.5, 3, buffer);
+    TEST_ASSERT_EQUAL_STRING("21.5", buffer);
+
+    dtoa_fixed(-3.14159, 0, buffer);
+    TEST_ASSERT_EQUAL_STRING("-3", buffer);
+
+    dtoa_fixed(-0.004, 2, buffer);
+    TEST_ASSERT_EQUAL_STRING("0", buffer);
+
+    dtoa_fixed(-0.006, 2, buffer);
+    TEST_ASSERT_EQUAL_STRING("-0.01", buffer);
+
+    dtoa_fixed(9.96, 1, buffer);
+    TEST_ASSERT_EQUAL_STRING("10", buffer);
+
+    dtoa_fixed(1.005, 2, buffer);
+    TEST_ASSERT_EQUAL_STRING("1.01", buffer);
+
+    dtoa_fixed(1e300, 2, buffer);
+    TEST_ASSERT_EQUAL_STRING("1e300", buffer);
+}
+
+#endif // TEST
@@ -0,0 +1,77 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "string.h"
+
+#include "model/feed.h"
+#include "model/feed_aggregation.h"
+
+
+static feed_aggregation_t aggregation;
+static typed_feed_t reading;
+
+void setUp(void)
+{
+    memset(&reading, 0, sizeof(reading));
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_feed_aggregation_average_per_window(void)
+{
+    feed_aggregation_init(&aggregation, "T", FEED_AGGREGATION_AVERAGE, 1000);
+
+    TEST_ASSERT_FALSE(feed_aggregation_add(&aggregation, 1, 1646815080100, true, 0, &reading));
+    TEST_ASSERT_FALSE(feed_aggregation_add(&aggregation, 2, 1646815080500, true, 0, &reading));
+    TEST_ASSERT_FALSE(feed_aggregation_add(&aggregation, 6, 1646815080999, true, 0, &reading));
+
+    TEST_ASSERT_TRUE(feed_aggregation_add(&aggregation, 10, 1646815081000, true, 0, &reading));
+    TEST_ASSERT_EQUAL_STRING("T", reading.reference);
+    TEST_ASSERT_EQUAL_INT(NUMERIC, reading.type);
+    TEST_ASSERT_TRUE(reading.value.numeric > 2.999 && reading.value.numeric < 3.001);
+    TEST_ASSERT_TRUE(reading.utc == 1646815080000);
+
+    TEST_ASSERT_TRUE(feed_aggregation_close(&aggregation, 0, true, &reading));
+    TEST_ASSERT_TRUE(reading.value.numeric > 9.999 && reading.value.numeric < 10.001);
+    TEST_ASSERT_FALSE(feed_aggregation_close(&aggregation, 0, true, &reading));
+}
+
+void test_feed_aggregation_summary(void)
+{
+    feed_aggregation_init(&aggregation, "T", FEED_AGGREGATION_SUMMARY, 100);
+
+    feed_aggregation_add(&aggregation, 4, 10, false, 10, &reading);
+    feed_aggregation_add(&aggregation, -2, 20, false, 20, &reading);
+    feed_aggregation_add(&aggregation, 7, 30, false, 30, &reading);
+
+    TEST_ASSERT_FALSE(feed_aggregation_close(&aggregation, 99, false, &reading));
+    TEST_ASSERT_TRUE(feed_aggregation_close(&aggregation, 100, false, &reading));
+    TEST_ASSERT_EQUAL_INT(VECTOR, reading.type);
+    TEST_ASSERT_EQUAL_INT(4, reading.size);
+    TEST_ASSERT_TRUE(reading.utc == 0);
+    TEST_ASSERT_TRUE(reading.vector[0] < -1.999 && reading.vector[0] > -2.001);
+    TEST_ASSERT_TRUE(reading.vector[1] > 6.999 && reading.vector[1] < 7.001);
+    TEST_ASSERT_TRUE(reading.vector[2] > 2.999 && reading.vector[2] < 3.001);
+    TEST_ASSERT_TRUE(reading.vector[3] > 2.999 && reading.vector[3] < 3.001);
+}
+
+void test_feed_aggregation_utc_window_ends_with_uptime(void)
+{
+    feed_aggregation_init(&aggregation, "T", FEED_AGGREGATION_MAX, 1000);
+
+    /* Window is opened 900 ms after its start, at uptime 5000 */
+    feed_aggregation_add(&aggregation, 3, 1646815080900, true, 5000, &reading);
+    feed_aggregation_add(&aggregation, 8, 1646815080950, true, 5050, &reading);
+
+    TEST_ASSERT_FALSE(feed_aggregation_close(&aggregation, 5999, false, &reading));
+    TEST_ASSERT_TRUE(feed_aggregation_close(&aggregation, 6000, false, &reading));
+    TEST_ASSERT_TRUE(reading.value.numeric > 7.999 && reading.value.numeric < 8.001);
+    TEST_ASSERT_TRUE(reading.utc == 1646815080000);
+    TEST_ASSERT_FALSE(feed_aggregation_close(&aggregation, 7000, false, &reading));
+}
+
+#endif // TEST
@@ -0,0 +1,72 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "string.h"
+
+#include "model/feed_filter.h"
+
+
+static feed_filter_t filter;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_feed_filter_absolute_deadband(void)
+{
+    const feed_filter_settings_t settings = {.absolute_deadband = 0.5};
+    feed_filter_init(&filter, "T", &settings);
+    TEST_ASSERT_EQUAL_STRING("T", filter.reference);
+
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 20.0, 1000));
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 20.0, 2000));
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 20.5, 3000));
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 19.6, 4000));
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 20.6, 5000));
+
+    /* Deadband is relative to the last reported value */
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 21.0, 6000));
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 21.2, 7000));
+}
+
+void test_feed_filter_percent_deadband(void)
+{
+    const feed_filter_settings_t settings = {.percent_deadband = 10};
+    feed_filter_init(&filter, "P", &settings);
+
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 200, 1000));
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 219, 2000));
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 179, 3000));
+}
+
+void test_feed_filter_intervals(void)
+{
+    const feed_filter_settings_t settings = {.absolute_deadband = 1, .min_interval = 100, .max_silence = 1000};
+    feed_filter_init(&filter, "T", &settings);
+
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 1, 1000));
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 10, 1050));
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 10, 1100));
+
+    /* Heartbeat of unchanged value */
+    TEST_ASSERT_FALSE(feed_filter_accept_numeric(&filter, 10, 2099));
+    TEST_ASSERT_TRUE(feed_filter_accept_numeric(&filter, 10, 2100));
+}
+
+void test_feed_filter_data(void)
+{
+    const feed_filter_settings_t settings = {0};
+    feed_filter_init(&filter, "S", &settings);
+
+    TEST_ASSERT_TRUE(feed_filter_accept_data(&filter, "on", 2, 1000));
+    TEST_ASSERT_FALSE(feed_filter_accept_data(&filter, "on", 2, 2000));
+    TEST_ASSERT_TRUE(feed_filter_accept_data(&filter, "off", 3, 3000));
+}
+
+#endif // TEST
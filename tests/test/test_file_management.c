@@ -0,0 +1,383 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdio.h"
+#include "string.h"
+
+#include "model/file_management/file_management.h"
+#include "model/file_management/file_management_parameter.h"
+#include "utility/md5.h"
+#include "utility/sha256.h"
+
+/* Chunk carries 8 bytes of data */
+#define CHUNK_SIZE (2 * FILE_MANAGEMENT_HASH_SIZE + 8)
+#define PACKET_SIZE (2 * FILE_MANAGEMENT_HASH_SIZE + 8)
+/* Requested packet size, which reassembly slots are sized for */
+#define REQUESTED_PACKET_SIZE (CHUNK_SIZE + 2 * FILE_MANAGEMENT_HASH_SIZE)
+#define NUMBER_OF_CHUNKS 4
+
+static const uint8_t file[NUMBER_OF_CHUNKS * 8] = "0123456789abcdefghijklmnopqrstuv";
+static uint8_t packets[NUMBER_OF_CHUNKS][PACKET_SIZE];
+
+static uint8_t written[sizeof(file)];
+static size_t written_size;
+static size_t requests[16];
+static size_t number_of_requests;
+static size_t requested_size;
+static bool is_finalized;
+static size_t number_of_reads;
+static file_management_status_t last_status;
+
+static file_management_transfer_state_t stored_state;
+static bool has_stored_state;
+static size_t resume_offset;
+
+static file_management_t file_management;
+static int wolk_ctx;
+
+static bool start(const char* file_name, size_t file_size)
+{
+    (void)file_name;
+    (void)file_size;
+    return true;
+}
+
+static bool write_chunk(uint8_t* data, size_t data_size)
+{
+    memcpy(written + written_size, data, data_size);
+    written_size += data_size;
+    return true;
+}
+
+static size_t read_chunk(size_t index, uint8_t* data, size_t data_size)
+{
+    (void)data_size;
+    number_of_reads += 1;
+    if (index != 0) {
+        return 0;
+    }
+
+    memcpy(data, written, written_size);
+    return written_size;
+}
+
+static bool abort_transfer(void)
+{
+    return true;
+}
+
+static void finalize(void)
+{
+    is_finalized = true;
+}
+
+static size_t get_file_list(file_list_t* file_list)
+{
+    (void)file_list;
+    return 0;
+}
+
+static void on_packet_request(file_management_t* file_management, file_management_packet_request_t request)
+{
+    (void)file_management;
+    requests[number_of_requests++] = file_management_packet_request_get_chunk_index(&request);
+    requested_size = file_management_packet_request_get_chunk_size(&request);
+}
+
+static void on_status(file_management_t* file_management, file_management_status_t status)
+{
+    (void)file_management;
+    last_status = status;
+}
+
+static void transfer_state_store(const file_management_transfer_state_t* state)
+{
+    has_stored_state = state != NULL;
+    if (state != NULL) {
+        stored_state = *state;
+    }
+}
+
+static bool transfer_state_read(file_management_transfer_state_t* state)
+{
+    if (has_stored_state) {
+        *state = stored_state;
+    }
+    return has_stored_state;
+}
+
+static bool transfer_resume(const char* file_name, size_t offset)
+{
+    (void)file_name;
+    resume_offset = offset;
+    written_size = offset;
+    return true;
+}
+
+static void init_file_management(void)
+{
+    file_management_init(&wolk_ctx, &file_management, "device_key", sizeof(file), CHUNK_SIZE, start, write_chunk,
+                         read_chunk, abort_transfer, finalize, NULL, NULL, get_file_list, NULL, NULL);
+    file_management_set_on_packet_request_listener(&file_management, on_packet_request);
+    file_management_set_on_status_listener(&file_management, on_status);
+}
+
+static void start_transfer(void)
+{
+    uint8_t md5_hash[16];
+    char checksum[2 * sizeof(md5_hash) + 1];
+    MD5_CTX md5_ctx;
+    md5_init(&md5_ctx);
+    md5_update(&md5_ctx, file, sizeof(file));
+    md5_final(&md5_ctx, md5_hash);
+    for (size_t i = 0; i < sizeof(md5_hash); ++i) {
+        sprintf(&checksum[i * 2], "%02x", (unsigned int)md5_hash[i]);
+    }
+
+    file_management_parameter_t parameter;
+    file_management_parameter_init(&parameter);
+    file_management_parameter_set_filename(&parameter, "file");
+    file_management_parameter_set_file_size(&parameter, sizeof(file));
+    file_management_parameter_set_file_hash(&parameter, (const uint8_t*)checksum, FILE_MANAGEMENT_HASH_SIZE);
+
+    file_management_handle_parameter(&file_management, &parameter);
+}
+
+void setUp(void)
+{
+    memset(packets, 0, sizeof(packets));
+    for (size_t i = 0; i < NUMBER_OF_CHUNKS; ++i) {
+        if (i > 0) {
+            memcpy(packets[i], packets[i - 1] + PACKET_SIZE - FILE_MANAGEMENT_HASH_SIZE, FILE_MANAGEMENT_HASH_SIZE);
+        }
+        memcpy(packets[i] + FILE_MANAGEMENT_HASH_SIZE, file + i * 8, 8);
+        sha256(file + i * 8, 8, packets[i] + PACKET_SIZE - FILE_MANAGEMENT_HASH_SIZE);
+    }
+
+    written_size = 0;
+    number_of_requests = 0;
+    is_finalized = false;
+    number_of_reads = 0;
+    has_stored_state = false;
+    resume_offset = 0;
+
+    init_file_management();
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_file_management_stop_and_wait(void)
+{
+    start_transfer();
+    TEST_ASSERT_EQUAL_INT(1, number_of_requests);
+
+    /* Out of order chunk is requested again */
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(2, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(0, requests[1]);
+
+    for (size_t i = 0; i < NUMBER_OF_CHUNKS; ++i) {
+        file_management_handle_packet(&file_management, packets[i], PACKET_SIZE);
+    }
+
+    TEST_ASSERT_EQUAL_INT(2 + NUMBER_OF_CHUNKS - 1, number_of_requests);
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+
+    /* File is hashed while written, without reading it back */
+    TEST_ASSERT_EQUAL_INT(0, number_of_reads);
+}
+
+void test_file_management_read_back_verification(void)
+{
+    file_management_set_read_back_verification(&file_management, true);
+
+    start_transfer();
+    for (size_t i = 0; i < NUMBER_OF_CHUNKS - 1; ++i) {
+        file_management_handle_packet(&file_management, packets[i], PACKET_SIZE);
+    }
+
+    /* Stored file no longer matches what was received */
+    written[0] ^= 1;
+    file_management_handle_packet(&file_management, packets[NUMBER_OF_CHUNKS - 1], PACKET_SIZE);
+
+    TEST_ASSERT_TRUE(number_of_reads > 0);
+    TEST_ASSERT_FALSE(is_finalized);
+    TEST_ASSERT_EQUAL_INT(FILE_MANAGEMENT_ERROR_FILE_HASH_MISMATCH, file_management_status_get_error(&last_status));
+}
+
+void test_file_management_window_reassembles_chunks(void)
+{
+    static uint8_t storage[2 * REQUESTED_PACKET_SIZE];
+
+    TEST_ASSERT_FALSE(file_management_set_window(&file_management, 3, storage, sizeof(storage) - 1));
+    TEST_ASSERT_TRUE(file_management_set_window(&file_management, 3, storage, sizeof(storage)));
+
+    start_transfer();
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(0, requests[0]);
+    TEST_ASSERT_EQUAL_INT(2, requests[2]);
+    TEST_ASSERT_EQUAL_INT(REQUESTED_PACKET_SIZE, requested_size);
+
+    /* Chunks ahead of the awaited one wait, duplicates are ignored */
+    file_management_handle_packet(&file_management, packets[2], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[2], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, written_size);
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(3 * 8, written_size);
+    TEST_ASSERT_EQUAL_INT(4, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(3, requests[3]);
+
+    file_management_handle_packet(&file_management, packets[3], PACKET_SIZE);
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+}
+
+void test_file_management_window_restarts_on_corrupted_chunk(void)
+{
+    static uint8_t storage[REQUESTED_PACKET_SIZE];
+    TEST_ASSERT_TRUE(file_management_set_window(&file_management, 2, storage, sizeof(storage)));
+
+    start_transfer();
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+
+    packets[1][FILE_MANAGEMENT_HASH_SIZE] ^= 1;
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    packets[1][FILE_MANAGEMENT_HASH_SIZE] ^= 1;
+
+    /* Whole window is requested again */
+    TEST_ASSERT_EQUAL_INT(5, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(1, requests[3]);
+    TEST_ASSERT_EQUAL_INT(2, requests[4]);
+
+    for (size_t i = 1; i < NUMBER_OF_CHUNKS; ++i) {
+        file_management_handle_packet(&file_management, packets[i], PACKET_SIZE);
+    }
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+}
+
+void test_file_management_window_ignores_late_duplicates_after_restart(void)
+{
+    static uint8_t storage[2 * REQUESTED_PACKET_SIZE];
+    TEST_ASSERT_TRUE(file_management_set_window(&file_management, 3, storage, sizeof(storage)));
+
+    start_transfer();
+    packets[0][FILE_MANAGEMENT_HASH_SIZE] ^= 1;
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    packets[0][FILE_MANAGEMENT_HASH_SIZE] ^= 1;
+    TEST_ASSERT_EQUAL_INT(6, number_of_requests);
+
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(7, number_of_requests);
+
+    /* Chunks requested before restart arrive after they are written, and take no reassembly slots */
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[3], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(7, number_of_requests);
+
+    file_management_handle_packet(&file_management, packets[2], PACKET_SIZE);
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+}
+
+void test_file_management_window_restarts_count_as_retries(void)
+{
+    start_transfer();
+
+    /* Chunk which can not be stored restarts the window, until transfer gives up */
+    for (size_t i = 0; i < 3; ++i) {
+        file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    }
+
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(FILE_MANAGEMENT_ERROR_RETRY_COUNT_EXCEEDED, file_management_status_get_error(&last_status));
+}
+
+void test_file_management_resume_after_reconnect(void)
+{
+    start_transfer();
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    TEST_ASSERT_EQUAL_INT(2, number_of_requests);
+
+    /* Request for chunk 1 was lost with the connection */
+    file_management_resume(&file_management);
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(1, requests[2]);
+
+    for (size_t i = 1; i < NUMBER_OF_CHUNKS; ++i) {
+        file_management_handle_packet(&file_management, packets[i], PACKET_SIZE);
+    }
+    TEST_ASSERT_TRUE(is_finalized);
+}
+
+void test_file_management_resume_after_restart(void)
+{
+    file_management_set_transfer_state_persistence(&file_management, transfer_state_store, transfer_state_read,
+                                                   transfer_resume);
+
+    start_transfer();
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+    TEST_ASSERT_TRUE(has_stored_state);
+    TEST_ASSERT_EQUAL_INT(2, stored_state.next_chunk_index);
+
+    /* Device restarts, written chunks remain */
+    init_file_management();
+
+    /* Nothing to resume without persistence */
+    file_management_resume(&file_management);
+    TEST_ASSERT_EQUAL_INT(3, number_of_requests);
+
+    file_management_set_transfer_state_persistence(&file_management, transfer_state_store, transfer_state_read,
+                                                   transfer_resume);
+    file_management_resume(&file_management);
+    TEST_ASSERT_EQUAL_INT(4, number_of_requests);
+    TEST_ASSERT_EQUAL_INT(2, requests[3]);
+    TEST_ASSERT_EQUAL_INT(2 * 8, resume_offset);
+
+    file_management_handle_packet(&file_management, packets[2], PACKET_SIZE);
+    file_management_handle_packet(&file_management, packets[3], PACKET_SIZE);
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+    TEST_ASSERT_FALSE(has_stored_state);
+}
+
+void test_file_management_resume_discards_chunk_written_before_restart(void)
+{
+    file_management_set_transfer_state_persistence(&file_management, transfer_state_store, transfer_state_read,
+                                                   transfer_resume);
+
+    start_transfer();
+    file_management_handle_packet(&file_management, packets[0], PACKET_SIZE);
+    const file_management_transfer_state_t state_before_write = stored_state;
+    file_management_handle_packet(&file_management, packets[1], PACKET_SIZE);
+
+    /* Device restarts after chunk 1 is written, but before its progress is stored */
+    stored_state = state_before_write;
+    init_file_management();
+    file_management_set_transfer_state_persistence(&file_management, transfer_state_store, transfer_state_read,
+                                                   transfer_resume);
+    file_management_resume(&file_management);
+    TEST_ASSERT_EQUAL_INT(8, resume_offset);
+    TEST_ASSERT_EQUAL_INT(1, requests[number_of_requests - 1]);
+
+    for (size_t i = 1; i < NUMBER_OF_CHUNKS; ++i) {
+        file_management_handle_packet(&file_management, packets[i], PACKET_SIZE);
+    }
+    TEST_ASSERT_TRUE(is_finalized);
+    TEST_ASSERT_EQUAL_INT(sizeof(file), written_size);
+    TEST_ASSERT_EQUAL_MEMORY(file, written, sizeof(file));
+}
+
+#endif // TEST
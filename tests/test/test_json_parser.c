@@ -4,6 +4,7 @@
 
 #include "MQTTPacket.h"
 #include "size_definitions.h"
+#include "stdio.h"
 #include "string.h"
 #include "wolk_types.h"
 
@@ -165,6 +166,155 @@ void test_json_parser_json_serialize_feed_multivalue(void)
     TEST_ASSERT_EQUAL_STRING("[{\"FB\":\"true,false\",\"timestamp\":1646815080000}]", buffer);
 }
 
+void test_json_parser_json_serialize_typed_feeds(void)
+{
+    typed_feed_t feeds[3];
+    const double location[] = {45.25, 19.8};
+    char buffer[PAYLOAD_SIZE] = "";
+    uint64_t utc = 1646815080000; // in milliseconds
+
+    typed_feed_init_string(&feeds[0], "FS", "FEED \"STRING\"", 13, utc);
+    TEST_ASSERT_TRUE(json_serialize_typed_feeds(feeds, 1, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("[{\"FS\":\"FEED \\\"STRING\\\"\",\"timestamp\":1646815080000}]", buffer);
+
+    typed_feed_init_numeric(&feeds[0], "FN", 3, utc);
+    typed_feed_init_numeric(&feeds[1], "FN", 32.1, utc + 100);
+    typed_feed_init_numeric(&feeds[2], "FN", 1.0 / 3.0, utc + 200);
+    feeds[2].decimals = 2;
+    TEST_ASSERT_TRUE(json_serialize_typed_feeds(feeds, 3, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING(
+        "[{\"FN\":3,\"timestamp\":1646815080000},{\"FN\":32.1,\"timestamp\":1646815080100},{\"FN\":0.33,\"timestamp\":1646815080200}]",
+        buffer);
+
+    typed_feed_init_boolean(&feeds[0], "FB", true, utc);
+    typed_feed_init_boolean(&feeds[1], "FB", false, 0);
+    TEST_ASSERT_FALSE(json_serialize_typed_feeds(feeds, 2, buffer, sizeof(buffer)));
+    TEST_ASSERT_TRUE(json_serialize_typed_feeds(&feeds[1], 1, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("[{\"FB\":\"false\"}]", buffer);
+
+    typed_feed_init_vector(&feeds[0], "LOC", location, 2, utc);
+    TEST_ASSERT_TRUE(json_serialize_typed_feeds(feeds, 1, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("[{\"LOC\":\"45.25,19.8\",\"timestamp\":1646815080000}]", buffer);
+}
+
+void test_json_parser_json_serialize_typed_feed_key(void)
+{
+    typed_feed_t feed;
+    char key[16];
+    char buffer[64];
+    size_t length = 0;
+
+    TEST_ASSERT_TRUE(json_serialize_typed_feed_key("T\"1", key, sizeof(key), &length));
+    TEST_ASSERT_EQUAL_STRING("{\"T\\\"1\":", key);
+    TEST_ASSERT_EQUAL_INT(strlen(key), length);
+
+    /* Serialized key is used instead of the reference */
+    typed_feed_init_numeric(&feed, "ignored", 1.5, 0);
+    feed.key = key;
+    feed.key_length = length;
+    TEST_ASSERT_TRUE(json_serialize_typed_feeds(&feed, 1, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("[{\"T\\\"1\":1.5}]", buffer);
+
+    TEST_ASSERT_FALSE(json_serialize_typed_feed_key("REFERENCE", key, 8, &length));
+}
+
+void test_json_parser_json_append_typed_feed(void)
+{
+    typed_feed_t feed;
+    char buffer[64] = "";
+    size_t length = 0;
+
+    typed_feed_init_numeric(&feed, "T", 20.5, 1646815080000);
+    TEST_ASSERT_TRUE(json_append_typed_feed(&feed, buffer, sizeof(buffer), &length));
+    TEST_ASSERT_EQUAL_STRING("[{\"T\":20.5,\"timestamp\":1646815080000}]", buffer);
+    TEST_ASSERT_EQUAL_INT(strlen(buffer), length);
+
+    typed_feed_init_boolean(&feed, "B", true, 0);
+    TEST_ASSERT_TRUE(json_append_typed_feed(&feed, buffer, sizeof(buffer), &length));
+    TEST_ASSERT_EQUAL_STRING("[{\"T\":20.5,\"timestamp\":1646815080000},{\"B\":\"true\"}]", buffer);
+    TEST_ASSERT_EQUAL_INT(strlen(buffer), length);
+
+    /* Feed which does not fit leaves the message unchanged */
+    typed_feed_init_string(&feed, "S", "value", 5, 0);
+    TEST_ASSERT_FALSE(json_append_typed_feed(&feed, buffer, sizeof(buffer), &length));
+    TEST_ASSERT_EQUAL_STRING("[{\"T\":20.5,\"timestamp\":1646815080000},{\"B\":\"true\"}]", buffer);
+    TEST_ASSERT_EQUAL_INT(strlen(buffer), length);
+}
+
+static size_t split_messages;
+static size_t split_items;
+
+static bool consume_split_message(void* context, outbound_message_t* outbound_message)
+{
+    (void)context;
+
+    TEST_ASSERT_EQUAL_STRING("d2p/some_key/attribute_registration", outbound_message->topic);
+    TEST_ASSERT_EQUAL_INT('[', outbound_message->payload[0]);
+    TEST_ASSERT_EQUAL_INT(']', outbound_message->payload[strlen(outbound_message->payload) - 1]);
+
+    for (const char* name = outbound_message->payload; (name = strstr(name, "\"name\"")) != NULL; ++name) {
+        split_items++;
+    }
+    split_messages++;
+
+    return true;
+}
+
+static bool serialize_split_attributes(parser_t* parser, void* items, size_t number_of_items,
+                                       outbound_message_t* outbound_message)
+{
+    return outbound_message_attribute_registration(parser, (attribute_t*)items, number_of_items, outbound_message);
+}
+
+void test_outbound_message_split(void)
+{
+    static attribute_t attributes[64];
+    char name[16];
+    parser_t parser;
+    parser_init(&parser);
+    parser_init_topics(&parser, "some_key");
+
+    for (size_t i = 0; i < 64; ++i) {
+        sprintf(name, "ATTRIBUTE_%u", (unsigned)i);
+        attribute_init(&attributes[i], name, "STRING", "value of the attribute");
+    }
+
+    split_messages = 0;
+    split_items = 0;
+    TEST_ASSERT_TRUE(outbound_message_split(&parser, serialize_split_attributes, attributes, sizeof(attributes[0]),
+                                            64, consume_split_message, NULL));
+    TEST_ASSERT_TRUE(split_messages > 1);
+    TEST_ASSERT_EQUAL_INT(64, split_items);
+
+    /* Items which fit are not split */
+    split_messages = 0;
+    split_items = 0;
+    TEST_ASSERT_TRUE(outbound_message_split(&parser, serialize_split_attributes, attributes, sizeof(attributes[0]),
+                                            2, consume_split_message, NULL));
+    TEST_ASSERT_EQUAL_INT(1, split_messages);
+    TEST_ASSERT_EQUAL_INT(2, split_items);
+}
+
+void test_parser_outbound_topics(void)
+{
+    char topic[TOPIC_SIZE];
+    outbound_message_t outbound_message;
+    parser_t parser;
+    parser_init(&parser);
+    parser_init_topics(&parser, "some_key");
+
+    TEST_ASSERT_EQUAL_INT(strlen("d2p/some_key/feed_values"),
+                          parser_get_topic(&parser, PARSER_TOPIC_FEED_VALUES, topic));
+    TEST_ASSERT_EQUAL_STRING("d2p/some_key/feed_values", topic);
+
+    TEST_ASSERT_TRUE(parser_serialize_sync_time(&parser, &outbound_message));
+    TEST_ASSERT_EQUAL_STRING("d2p/some_key/time", outbound_message.topic);
+    TEST_ASSERT_EQUAL_STRING("", outbound_message.payload);
+
+    TEST_ASSERT_TRUE(parser_serialize_pull_parameters(&parser, &outbound_message));
+    TEST_ASSERT_EQUAL_STRING("d2p/some_key/pull_parameters", outbound_message.topic);
+}
+
 void test_json_deserialize_file_delete(void)
 {
     char received_payload[100];
@@ -195,6 +345,104 @@ void test_json_deserialize_url_download(void)
     TEST_ASSERT_FALSE(json_deserialize_url_download("", 0, url_download));
 }
 
+static size_t received_items;
+static char received_references[4][REFERENCE_SIZE];
+static char received_values[4][FEED_ELEMENT_SIZE];
+static uint64_t received_utc[4];
+
+static void receive_feed(void* context, feed_t* feed)
+{
+    (void)context;
+
+    strcpy(received_references[received_items], feed->reference);
+    strcpy(received_values[received_items], feed->data[0]);
+    received_utc[received_items] = feed_get_utc(feed);
+    received_items++;
+}
+
+static void receive_parameter(void* context, parameter_t* parameter)
+{
+    (void)context;
+
+    strcpy(received_references[received_items], parameter->name);
+    strcpy(received_values[received_items], parameter->value);
+    received_items++;
+}
+
+void test_json_deserialize_feeds_value_message_each(void)
+{
+    char buffer[] = "[{\"T\":20,\"timestamp\":1646815080000},{\"S\":\"on\"}]";
+    feed_t feed;
+
+    received_items = 0;
+    TEST_ASSERT_EQUAL_INT(2, json_deserialize_feeds_value_message_each(buffer, strlen(buffer), &feed, receive_feed,
+                                                                       NULL));
+    TEST_ASSERT_EQUAL_INT(2, received_items);
+    TEST_ASSERT_EQUAL_STRING("T", received_references[0]);
+    TEST_ASSERT_EQUAL_STRING("20", received_values[0]);
+    TEST_ASSERT_TRUE(received_utc[0] == 1646815080000);
+    TEST_ASSERT_EQUAL_STRING("S", received_references[1]);
+    TEST_ASSERT_EQUAL_STRING("on", received_values[1]);
+    TEST_ASSERT_TRUE(received_utc[1] == 0);
+
+    received_items = 0;
+    TEST_ASSERT_EQUAL_INT(0, json_deserialize_feeds_value_message_each(buffer, 5, &feed, receive_feed, NULL));
+    TEST_ASSERT_EQUAL_INT(0, received_items);
+}
+
+void test_json_deserialize_parameter_message_each(void)
+{
+    char buffer[] = "{\"FIRMWARE_VERSION\":\"1.0.0\",\"MAXIMUM_MESSAGE_SIZE\":2048}";
+    parameter_t parameter;
+
+    received_items = 0;
+    TEST_ASSERT_EQUAL_INT(2, json_deserialize_parameter_message_each(buffer, strlen(buffer), &parameter,
+                                                                     receive_parameter, NULL));
+    TEST_ASSERT_EQUAL_STRING("FIRMWARE_VERSION", received_references[0]);
+    TEST_ASSERT_EQUAL_STRING("1.0.0", received_values[0]);
+    TEST_ASSERT_EQUAL_STRING("MAXIMUM_MESSAGE_SIZE", received_references[1]);
+    TEST_ASSERT_EQUAL_STRING("2048", received_values[1]);
+}
+
+static data_type_t received_types[4];
+static double received_numbers[4];
+
+static void receive_typed_feed(void* context, const typed_feed_t* feed)
+{
+    (void)context;
+
+    strcpy(received_references[received_items], feed->reference);
+    received_types[received_items] = feed->type;
+    if (feed->type == NUMERIC) {
+        received_numbers[received_items] = feed->value.numeric;
+    } else if (feed->type == BOOLEAN) {
+        strcpy(received_values[received_items], BOOL_TO_STR(feed->value.boolean));
+    } else {
+        sprintf(received_values[received_items], "%.*s", (int)feed->value.string.length, feed->value.string.data);
+    }
+    received_utc[received_items] = feed->utc;
+    received_items++;
+}
+
+void test_json_deserialize_typed_feeds_each(void)
+{
+    char buffer[] = "[{\"T\":20.5,\"timestamp\":1646815080000},{\"S\":\"on\"},{\"B\":true}]";
+
+    received_items = 0;
+    TEST_ASSERT_EQUAL_INT(3, json_deserialize_typed_feeds_each(buffer, strlen(buffer), receive_typed_feed, NULL));
+    TEST_ASSERT_EQUAL_STRING("T", received_references[0]);
+    TEST_ASSERT_EQUAL_INT(NUMERIC, received_types[0]);
+    TEST_ASSERT_TRUE(received_numbers[0] == 20.5);
+    TEST_ASSERT_TRUE(received_utc[0] == 1646815080000);
+    TEST_ASSERT_EQUAL_STRING("S", received_references[1]);
+    TEST_ASSERT_EQUAL_INT(STRING, received_types[1]);
+    TEST_ASSERT_EQUAL_STRING("on", received_values[1]);
+    TEST_ASSERT_TRUE(received_utc[1] == 0);
+    TEST_ASSERT_EQUAL_STRING("B", received_references[2]);
+    TEST_ASSERT_EQUAL_INT(BOOLEAN, received_types[2]);
+    TEST_ASSERT_EQUAL_STRING("true", received_values[2]);
+}
+
 //void test_json_deserialize_feeds_value_message_multiple_feeds(void)
 //{
 //    char buffer[256] = "[{\n\"T\": 20,\n}]";
@@ -0,0 +1,68 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "string.h"
+
+#include "utility/json_writer.h"
+
+
+static char buffer[64];
+static json_writer_t writer;
+
+void setUp(void)
+{
+    memset(buffer, 'x', sizeof(buffer));
+    json_writer_init(&writer, buffer, sizeof(buffer));
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_json_writer_builds_object(void)
+{
+    TEST_ASSERT_EQUAL_STRING("", buffer);
+
+    json_writer_raw(&writer, "{");
+    json_writer_key(&writer, "name");
+    json_writer_string(&writer, "T");
+    json_writer_separator(&writer, 1);
+    json_writer_key(&writer, "values");
+    json_writer_raw(&writer, "[");
+    json_writer_separator(&writer, 0);
+    json_writer_int64(&writer, -42);
+    json_writer_separator(&writer, 1);
+    json_writer_uint64(&writer, 18446744073709551615ULL);
+    json_writer_raw(&writer, "]}");
+
+    TEST_ASSERT_TRUE(json_writer_ok(&writer));
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"T\",\"values\":[-42,18446744073709551615]}", buffer);
+    TEST_ASSERT_EQUAL_INT(strlen(buffer), json_writer_length(&writer));
+}
+
+void test_json_writer_escapes_strings(void)
+{
+    json_writer_string(&writer, "a\"b\\c\nd\x01");
+
+    TEST_ASSERT_TRUE(json_writer_ok(&writer));
+    TEST_ASSERT_EQUAL_STRING("\"a\\\"b\\\\c\\nd\\u0001\"", buffer);
+}
+
+void test_json_writer_reports_overflow(void)
+{
+    char small[8];
+    json_writer_init(&writer, small, sizeof(small));
+
+    json_writer_raw(&writer, "1234567");
+    TEST_ASSERT_TRUE(json_writer_ok(&writer));
+    TEST_ASSERT_EQUAL_STRING("1234567", small);
+
+    json_writer_raw(&writer, "8");
+    json_writer_raw(&writer, "");
+    TEST_ASSERT_FALSE(json_writer_ok(&writer));
+    TEST_ASSERT_EQUAL_STRING("1234567", small);
+}
+
+#endif // TEST
@@ -0,0 +1,89 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdio.h"
+#include "string.h"
+
+#include "utility/md5.h"
+
+
+static void md5_hex(const uint8_t* data, size_t length, size_t update_size, char hex[33])
+{
+    uint8_t hash[16];
+    MD5_CTX ctx;
+
+    md5_init(&ctx);
+    for (size_t offset = 0; offset < length; offset += update_size) {
+        md5_update(&ctx, data + offset, length - offset < update_size ? length - offset : update_size);
+    }
+    md5_final(&ctx, hash);
+
+    for (size_t i = 0; i < sizeof(hash); ++i) {
+        sprintf(&hex[i * 2], "%02x", (unsigned int)hash[i]);
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_md5_rfc1321_test_suite(void)
+{
+    static const char* const messages[] = {
+        "",
+        "a",
+        "abc",
+        "message digest",
+        "abcdefghijklmnopqrstuvwxyz",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+        "12345678901234567890123456789012345678901234567890123456789012345678901234567890"};
+    static const char* const digests[] = {"d41d8cd98f00b204e9800998ecf8427e", "0cc175b9c0f1b6a831c399e269772661",
+                                          "900150983cd24fb0d6963f7d28e17f72", "f96b697d7cb7938d525a2f31aaf161d0",
+                                          "c3fcd3d76192e4007dfb496cca67e13b", "d174ab98d277d9f5a5611c2c9f419d9f",
+                                          "57edf4a22be3c955ac49da2e2107b67a"};
+    char hex[33];
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); ++i) {
+        md5_hex((const uint8_t*)messages[i], strlen(messages[i]), strlen(messages[i]) + 1, hex);
+        TEST_ASSERT_EQUAL_STRING(digests[i], hex);
+    }
+}
+
+void test_md5_does_not_depend_on_update_size_and_alignment(void)
+{
+    static uint8_t data[4096 + 3];
+    char expected[33];
+    char hex[33];
+
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    /* Byte at a time, as the reference implementation consumed input */
+    md5_hex(data + 3, 4096, 1, expected);
+
+    md5_hex(data + 3, 4096, 4096, hex);
+    TEST_ASSERT_EQUAL_STRING(expected, hex);
+    md5_hex(data + 3, 4096, 63, hex);
+    TEST_ASSERT_EQUAL_STRING(expected, hex);
+    md5_hex(data + 3, 4096, 1000, hex);
+    TEST_ASSERT_EQUAL_STRING(expected, hex);
+}
+
+void test_md5_one_million_a(void)
+{
+    static uint8_t data[1000000];
+    char hex[33];
+
+    memset(data, 'a', sizeof(data));
+    md5_hex(data, sizeof(data), sizeof(data), hex);
+    TEST_ASSERT_EQUAL_STRING("7707d6ae4e027c70eea2a935c2296f21", hex);
+}
+
+#endif // TEST
@@ -0,0 +1,289 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "persistence/mmap_log_persistence.h"
+#include "utility/crc32.h"
+
+#ifdef MMAP_LOG_PERSISTENCE_SUPPORTED
+
+#include <dirent.h>
+#include <unistd.h>
+
+/* Segment header and two records of 'payload()' fit into one segment, third one does not */
+#define SEGMENT_SIZE 64
+
+static char directory[] = "/tmp/mmap_log_testXXXXXX";
+static mmap_log_persistence_t segment_log;
+
+static void remove_directory(void)
+{
+    char path[PERSISTENCE_PATH_SIZE + 300];
+    struct dirent* entry;
+
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        return;
+    }
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+            unlink(path);
+        }
+    }
+
+    closedir(dir);
+    rmdir(directory);
+}
+
+static const char* payload(int i)
+{
+    static char value[16];
+    snprintf(value, sizeof(value), "payload%d", i);
+    return value;
+}
+
+static bool push(int i)
+{
+    outbound_message_t message;
+    outbound_message_init(&message, "t", payload(i));
+    return mmap_log_persistence_push(&segment_log, &message);
+}
+
+static void assert_pop(int i)
+{
+    outbound_message_t message;
+    TEST_ASSERT_TRUE(mmap_log_persistence_pop(&segment_log, &message));
+    TEST_ASSERT_EQUAL_STRING("t", message.topic);
+    TEST_ASSERT_EQUAL_STRING(payload(i), message.payload);
+}
+
+static void reopen(uint32_t max_segments, bool wrap)
+{
+    mmap_log_persistence_close(&segment_log);
+    TEST_ASSERT_TRUE(mmap_log_persistence_init(&segment_log, directory, SEGMENT_SIZE, max_segments, wrap));
+}
+
+static FILE* open_file(const char* name)
+{
+    char path[PERSISTENCE_PATH_SIZE + 300];
+    snprintf(path, sizeof(path), "%s/%s", directory, name);
+
+    FILE* file = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    return file;
+}
+
+void setUp(void)
+{
+    strcpy(directory, "/tmp/mmap_log_testXXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(directory));
+    TEST_ASSERT_TRUE(mmap_log_persistence_init(&segment_log, directory, SEGMENT_SIZE, 4, false));
+}
+
+void tearDown(void)
+{
+    mmap_log_persistence_close(&segment_log);
+    remove_directory();
+}
+
+
+void test_mmap_log_push_pop_across_segments(void)
+{
+    int i;
+
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+    for (i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE(push(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, segment_log.write.index - segment_log.read.index);
+
+    outbound_message_view_t view;
+    TEST_ASSERT_TRUE(mmap_log_persistence_peek_view(&segment_log, &view));
+    TEST_ASSERT_EQUAL_MEMORY(payload(0), view.payload, view.payload_length);
+
+    for (i = 0; i < 5; ++i) {
+        assert_pop(i);
+    }
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+    TEST_ASSERT_EQUAL_UINT32(segment_log.write.index, segment_log.read.index);
+}
+
+void test_mmap_log_full_without_wrap(void)
+{
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        TEST_ASSERT_TRUE(push(i));
+    }
+    TEST_ASSERT_FALSE(push(8));
+
+    assert_pop(0);
+    TEST_ASSERT_FALSE(push(8));
+
+    /* Consumed segment is reclaimed even though nothing was read past it */
+    assert_pop(1);
+    TEST_ASSERT_TRUE(push(8));
+}
+
+void test_mmap_log_reopen_after_partial_drain(void)
+{
+    int i;
+
+    for (i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE(push(i));
+    }
+    assert_pop(0);
+    assert_pop(1);
+    assert_pop(2);
+
+    reopen(4, false);
+
+    assert_pop(3);
+    TEST_ASSERT_TRUE(push(5));
+
+    reopen(4, false);
+
+    assert_pop(4);
+    assert_pop(5);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+void test_mmap_log_garbage_after_write_offset_is_ignored(void)
+{
+    TEST_ASSERT_TRUE(push(0));
+    const uint32_t write_offset = segment_log.write_offset;
+    mmap_log_persistence_close(&segment_log);
+
+    /* Length of record which would fit into segment, followed by CRC which does not match it */
+    const uint32_t garbage[] = {8, 0xDEADBEEF, 0x12345678, 0x9ABCDEF0};
+    FILE* file = open_file("00000000.seg");
+    fseek(file, (long)write_offset, SEEK_SET);
+    fwrite(garbage, sizeof(garbage), 1, file);
+    fclose(file);
+
+    reopen(4, false);
+    TEST_ASSERT_EQUAL_UINT32(write_offset, segment_log.write_offset);
+
+    TEST_ASSERT_TRUE(push(1));
+    assert_pop(0);
+    assert_pop(1);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+void test_mmap_log_torn_record_is_dropped(void)
+{
+    TEST_ASSERT_TRUE(push(0));
+    const uint32_t torn_offset = segment_log.write_offset;
+    TEST_ASSERT_TRUE(push(1));
+    mmap_log_persistence_close(&segment_log);
+
+    /* Last byte of the second record did not reach the storage */
+    FILE* file = open_file("00000000.seg");
+    fseek(file, (long)(torn_offset + 8 + 2 + 1 + strlen(payload(1)) - 1), SEEK_SET);
+    fputc('X', file);
+    fclose(file);
+
+    reopen(4, false);
+    TEST_ASSERT_EQUAL_UINT32(torn_offset, segment_log.write_offset);
+
+    assert_pop(0);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+void test_mmap_log_undecodable_record_is_dropped(void)
+{
+    outbound_message_view_t view;
+
+    TEST_ASSERT_TRUE(push(0));
+    TEST_ASSERT_TRUE(push(1));
+    mmap_log_persistence_close(&segment_log);
+
+    /* First record refers to topic by ID, which records of this log never do, and its CRC matches */
+    const uint32_t offset = 8;
+    const uint32_t segment_index = 0;
+    uint32_t length;
+    uint8_t record[16];
+    FILE* file = open_file("00000000.seg");
+    fseek(file, (long)offset, SEEK_SET);
+    TEST_ASSERT_EQUAL(1, fread(&length, sizeof(length), 1, file));
+    fseek(file, (long)(offset + 8), SEEK_SET);
+    TEST_ASSERT_EQUAL(1, fread(record, length, 1, file));
+
+    record[0] = 0x00;
+    record[1] = 0x80;
+    uint32_t crc = crc32_update(0, &segment_index, sizeof(segment_index));
+    crc = crc32_update(crc, &length, sizeof(length));
+    crc = crc32_update(crc, record, length);
+
+    fseek(file, (long)(offset + 4), SEEK_SET);
+    fwrite(&crc, sizeof(crc), 1, file);
+    fwrite(record, length, 1, file);
+    fclose(file);
+
+    reopen(4, false);
+    TEST_ASSERT_FALSE(mmap_log_persistence_is_empty(&segment_log));
+    TEST_ASSERT_TRUE(mmap_log_persistence_peek_view(&segment_log, &view));
+    TEST_ASSERT_EQUAL_UINT32(1, segment_log.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, mmap_log_persistence_head_id(&segment_log));
+
+    assert_pop(1);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+void test_mmap_log_stale_checkpoint_slot(void)
+{
+    mmap_log_checkpoint_t checkpoints[MMAP_LOG_CHECKPOINT_SLOTS];
+    int i;
+
+    for (i = 0; i < 3; ++i) {
+        TEST_ASSERT_TRUE(push(i));
+    }
+    assert_pop(0);
+    assert_pop(1);
+    mmap_log_persistence_close(&segment_log);
+
+    /* The newest slot is torn, cursor is restored from the older one, so the last popped record is read again */
+    FILE* file = open_file("checkpoint");
+    TEST_ASSERT_EQUAL(MMAP_LOG_CHECKPOINT_SLOTS, fread(checkpoints, sizeof(checkpoints[0]), MMAP_LOG_CHECKPOINT_SLOTS,
+                                                       file));
+    const size_t newest = (int32_t)(checkpoints[0].sequence - checkpoints[1].sequence) > 0 ? 0 : 1;
+    checkpoints[newest].crc ^= 1;
+    fseek(file, 0, SEEK_SET);
+    fwrite(checkpoints, sizeof(checkpoints[0]), MMAP_LOG_CHECKPOINT_SLOTS, file);
+    fclose(file);
+
+    reopen(4, false);
+
+    assert_pop(1);
+    assert_pop(2);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+void test_mmap_log_wrap_discards_oldest_segment(void)
+{
+    int i;
+
+    reopen(2, true);
+    for (i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(push(i));
+    }
+
+    const uint32_t head_id = mmap_log_persistence_head_id(&segment_log);
+    TEST_ASSERT_TRUE(push(4));
+    TEST_ASSERT_TRUE(head_id != mmap_log_persistence_head_id(&segment_log));
+
+    assert_pop(2);
+    assert_pop(3);
+    assert_pop(4);
+    TEST_ASSERT_TRUE(mmap_log_persistence_is_empty(&segment_log));
+}
+
+#endif
+
+#endif // TEST
@@ -0,0 +1,349 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "string.h"
+
+#include "persistence/in_memory_packed_persistence.h"
+#include "persistence/in_memory_persistence.h"
+#include "persistence/packed_record.h"
+#include "persistence/persistence.h"
+#include "utility/circular_buffer.h"
+#include "utility/record_buffer.h"
+
+
+static uint8_t storage[64];
+static record_buffer_t buffer;
+
+void setUp(void)
+{
+    memset(storage, 0, sizeof(storage));
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_record_buffer_push_peek_pop(void)
+{
+    uint32_t length = 0;
+
+    record_buffer_init(&buffer, storage, sizeof(storage), false);
+    TEST_ASSERT_TRUE(record_buffer_empty(&buffer));
+
+    memcpy(record_buffer_allocate(&buffer, 3), "abc", 3);
+    memcpy(record_buffer_allocate(&buffer, 5), "defgh", 5);
+    TEST_ASSERT_EQUAL_UINT32(2, record_buffer_size(&buffer));
+
+    uint8_t* record = record_buffer_peek(&buffer, &length);
+    TEST_ASSERT_EQUAL_UINT32(3, length);
+    TEST_ASSERT_EQUAL_MEMORY("abc", record, 3);
+    TEST_ASSERT_TRUE(record_buffer_pop(&buffer));
+
+    record = record_buffer_peek(&buffer, &length);
+    TEST_ASSERT_EQUAL_UINT32(5, length);
+    TEST_ASSERT_EQUAL_MEMORY("defgh", record, 5);
+    TEST_ASSERT_TRUE(record_buffer_pop(&buffer));
+
+    TEST_ASSERT_TRUE(record_buffer_empty(&buffer));
+    TEST_ASSERT_NULL(record_buffer_peek(&buffer, &length));
+    TEST_ASSERT_FALSE(record_buffer_pop(&buffer));
+}
+
+void test_record_buffer_full_without_wrap(void)
+{
+    record_buffer_init(&buffer, storage, sizeof(storage), false);
+
+    TEST_ASSERT_NOT_NULL(record_buffer_allocate(&buffer, 28));
+    TEST_ASSERT_NOT_NULL(record_buffer_allocate(&buffer, 28));
+    TEST_ASSERT_NULL(record_buffer_allocate(&buffer, 1));
+    TEST_ASSERT_NULL(record_buffer_allocate(&buffer, sizeof(storage)));
+    TEST_ASSERT_EQUAL_UINT32(2, record_buffer_size(&buffer));
+}
+
+void test_record_buffer_wrap_discards_oldest(void)
+{
+    uint32_t length = 0;
+
+    record_buffer_init(&buffer, storage, sizeof(storage), true);
+
+    memcpy(record_buffer_allocate(&buffer, 20), "11111111111111111111", 20);
+    memcpy(record_buffer_allocate(&buffer, 20), "22222222222222222222", 20);
+    memcpy(record_buffer_allocate(&buffer, 20), "33333333333333333333", 20);
+    TEST_ASSERT_EQUAL_UINT32(2, record_buffer_size(&buffer));
+
+    uint8_t* record = record_buffer_peek(&buffer, &length);
+    TEST_ASSERT_EQUAL_UINT32(20, length);
+    TEST_ASSERT_EQUAL_MEMORY("22222222222222222222", record, 20);
+    TEST_ASSERT_TRUE(record_buffer_pop(&buffer));
+
+    record = record_buffer_peek(&buffer, &length);
+    TEST_ASSERT_EQUAL_MEMORY("33333333333333333333", record, 20);
+}
+
+void test_in_memory_packed_persistence_round_trip(void)
+{
+    static uint8_t persistence_storage[512];
+    in_memory_packed_persistence_t persistence;
+    outbound_message_t message;
+    outbound_message_t peeked;
+
+    in_memory_packed_persistence_init(&persistence, persistence_storage, sizeof(persistence_storage), false);
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_is_empty(&persistence));
+
+    strcpy(message.topic, "d/device_key/p/feed_values");
+    strcpy(message.payload, "[{\"T\":24.5}]");
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_push(&persistence, &message));
+    TEST_ASSERT_FALSE(in_memory_packed_persistence_is_empty(&persistence));
+
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_peek(&persistence, &peeked));
+    TEST_ASSERT_EQUAL_STRING(message.topic, peeked.topic);
+    TEST_ASSERT_EQUAL_STRING(message.payload, peeked.payload);
+
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_pop(&persistence, &peeked));
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_is_empty(&persistence));
+}
+
+void test_in_memory_packed_persistence_peek_view(void)
+{
+    static uint8_t persistence_storage[512];
+    in_memory_packed_persistence_t persistence;
+    outbound_message_t message;
+    outbound_message_view_t view;
+
+    in_memory_packed_persistence_init(&persistence, persistence_storage, sizeof(persistence_storage), false);
+    TEST_ASSERT_FALSE(in_memory_packed_persistence_peek_view(&persistence, &view));
+
+    strcpy(message.topic, "d/device_key/p/feed_values");
+    strcpy(message.payload, "[{\"T\":24.5}]");
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_push(&persistence, &message));
+
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_peek_view(&persistence, &view));
+    TEST_ASSERT_EQUAL_UINT16(strlen(message.topic), view.topic_length);
+    TEST_ASSERT_EQUAL_MEMORY(message.topic, view.topic, view.topic_length);
+    TEST_ASSERT_EQUAL_UINT32(strlen(message.payload), view.payload_length);
+    TEST_ASSERT_EQUAL_MEMORY(message.payload, view.payload, view.payload_length);
+
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_drop(&persistence));
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_is_empty(&persistence));
+}
+
+void test_in_memory_packed_persistence_topic_ids(void)
+{
+    static uint8_t persistence_storage[512];
+    static outbound_topics_t topics;
+    in_memory_packed_persistence_t persistence;
+    outbound_message_t message;
+    outbound_message_t peeked;
+    outbound_message_view_t view;
+    uint32_t record_length;
+
+    strcpy(topics.topics[0], "d2p/device_key/feed_values");
+    strcpy(topics.topics[1], "d2p/device_key/parameters");
+    topics.topic_lengths[0] = (uint16_t)strlen(topics.topics[0]);
+    topics.topic_lengths[1] = (uint16_t)strlen(topics.topics[1]);
+    topics.number_of_topics = 2;
+
+    in_memory_packed_persistence_init(&persistence, persistence_storage, sizeof(persistence_storage), false);
+    in_memory_packed_persistence_set_topics(&persistence, &topics);
+
+    /* Known topic is stored as ID */
+    strcpy(message.topic, "d2p/device_key/parameters");
+    strcpy(message.payload, "{\"N\": \"v\"}");
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_push(&persistence, &message));
+    TEST_ASSERT_NOT_NULL(record_buffer_peek(&persistence.buffer, &record_length));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(uint16_t) + strlen(message.payload), record_length);
+
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_peek_view(&persistence, &view));
+    TEST_ASSERT_EQUAL_UINT16(strlen(message.topic), view.topic_length);
+    TEST_ASSERT_EQUAL_MEMORY(message.topic, view.topic, view.topic_length);
+    TEST_ASSERT_EQUAL_MEMORY(message.payload, view.payload, view.payload_length);
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_pop(&persistence, &peeked));
+    TEST_ASSERT_EQUAL_STRING(message.topic, peeked.topic);
+    TEST_ASSERT_EQUAL_STRING(message.payload, peeked.payload);
+
+    /* Other topics are stored in full */
+    strcpy(message.topic, "d2p/other_device/parameters");
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_push(&persistence, &message));
+    TEST_ASSERT_NOT_NULL(record_buffer_peek(&persistence.buffer, &record_length));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(uint16_t) + strlen(message.topic) + strlen(message.payload), record_length);
+    TEST_ASSERT_TRUE(in_memory_packed_persistence_peek(&persistence, &peeked));
+    TEST_ASSERT_EQUAL_STRING(message.topic, peeked.topic);
+    TEST_ASSERT_EQUAL_STRING(message.payload, peeked.payload);
+}
+
+void test_circular_buffer_peek_and_pop_array_across_end_of_storage(void)
+{
+    uint32_t elements[5];
+    uint32_t read[5] = {0};
+    uint32_t i;
+    circular_buffer_t circular_buffer;
+
+    circular_buffer_init(&circular_buffer, elements, 5, sizeof(uint32_t), false, true);
+    for (i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(circular_buffer_add(&circular_buffer, &i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, circular_buffer_drop_from_beggining(&circular_buffer, 3));
+    for (i = 4; i < 8; ++i) {
+        TEST_ASSERT_TRUE(circular_buffer_add(&circular_buffer, &i));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(4, circular_buffer_peek_array(&circular_buffer, 1, 10, read));
+    TEST_ASSERT_EQUAL_UINT32(4, read[0]);
+    TEST_ASSERT_EQUAL_UINT32(7, read[3]);
+
+    TEST_ASSERT_EQUAL_UINT32(5, circular_buffer_pop_array(&circular_buffer, 10, read));
+    TEST_ASSERT_EQUAL_UINT32(3, read[0]);
+    TEST_ASSERT_EQUAL_UINT32(7, read[4]);
+    TEST_ASSERT_TRUE(circular_buffer_empty(&circular_buffer));
+}
+
+void test_persistence_batch_falls_back_to_single_item_calls(void)
+{
+    static outbound_message_t persistence_storage[4];
+    static outbound_message_t messages[3];
+    in_memory_persistence_t in_memory_persistence;
+    persistence_t persistence;
+    size_t i;
+
+    in_memory_persistence_init(&in_memory_persistence, persistence_storage, sizeof(persistence_storage), false);
+    persistence_init(&persistence, &in_memory_persistence, in_memory_persistence_push, in_memory_persistence_peek,
+                     in_memory_persistence_pop, in_memory_persistence_is_empty);
+
+    for (i = 0; i < 3; ++i) {
+        outbound_message_init(&messages[i], "topic", i == 0 ? "0" : (i == 1 ? "1" : "2"));
+        TEST_ASSERT_TRUE(persistence_push(&persistence, &messages[i]));
+    }
+
+    TEST_ASSERT_EQUAL(1, persistence_peek_n(&persistence, messages, 3));
+    TEST_ASSERT_EQUAL_STRING("0", messages[0].payload);
+    TEST_ASSERT_EQUAL(2, persistence_pop_n(&persistence, NULL, 2));
+
+    persistence_set_batch(&persistence, in_memory_persistence_peek_n, in_memory_persistence_pop_n);
+    TEST_ASSERT_EQUAL(1, persistence_pop_n(&persistence, messages, 3));
+    TEST_ASSERT_EQUAL_STRING("2", messages[0].payload);
+    TEST_ASSERT_TRUE(persistence_is_empty(&persistence));
+}
+
+void test_in_memory_persistence_instances_are_independent(void)
+{
+    static outbound_message_t first_storage[2];
+    static outbound_message_t second_storage[2];
+    in_memory_persistence_t first;
+    in_memory_persistence_t second;
+    outbound_message_t message;
+
+    in_memory_persistence_init(&first, first_storage, sizeof(first_storage), false);
+    in_memory_persistence_init(&second, second_storage, sizeof(second_storage), false);
+
+    outbound_message_init(&message, "first", "1");
+    TEST_ASSERT_TRUE(in_memory_persistence_push(&first, &message));
+
+    TEST_ASSERT_FALSE(in_memory_persistence_is_empty(&first));
+    TEST_ASSERT_TRUE(in_memory_persistence_is_empty(&second));
+    TEST_ASSERT_FALSE(in_memory_persistence_peek(&second, &message));
+}
+
+/* Mirrors wolk_publish: head is dropped once it is sent, only if it was not discarded while being sent */
+static void wrap_while_publishing(persistence_t* persistence, const char* first_unsent_payload)
+{
+    outbound_message_t message;
+    outbound_message_view_t view;
+
+    TEST_ASSERT_TRUE(persistence_peek_view(persistence, &view));
+    TEST_ASSERT_EQUAL_MEMORY("0", view.payload, view.payload_length);
+    const uint32_t sent_id = persistence_head_id(persistence);
+
+    /* Queue is full, push discards message which is being sent */
+    outbound_message_init(&message, "topic", "3");
+    TEST_ASSERT_TRUE(persistence_push(persistence, &message));
+    TEST_ASSERT_NOT_EQUAL(sent_id, persistence_head_id(persistence));
+
+    /* Sending completes */
+    if (persistence_head_id(persistence) == sent_id) {
+        TEST_ASSERT_TRUE(persistence_drop(persistence));
+    }
+
+    TEST_ASSERT_TRUE(persistence_peek_view(persistence, &view));
+    TEST_ASSERT_EQUAL_MEMORY(first_unsent_payload, view.payload, view.payload_length);
+
+    const uint32_t next_id = persistence_head_id(persistence);
+    TEST_ASSERT_TRUE(persistence_drop(persistence));
+    TEST_ASSERT_NOT_EQUAL(next_id, persistence_head_id(persistence));
+}
+
+void test_in_memory_persistence_wrap_while_publishing(void)
+{
+    static outbound_message_t persistence_storage[3];
+    in_memory_persistence_t in_memory_persistence;
+    persistence_t persistence;
+    outbound_message_t message;
+
+    in_memory_persistence_init(&in_memory_persistence, persistence_storage, sizeof(persistence_storage), true);
+    persistence_init(&persistence, &in_memory_persistence, in_memory_persistence_push, in_memory_persistence_peek,
+                     in_memory_persistence_pop, in_memory_persistence_is_empty);
+    persistence_set_view(&persistence, in_memory_persistence_peek_view, in_memory_persistence_drop);
+    persistence_set_head_id(&persistence, in_memory_persistence_head_id);
+
+    outbound_message_init(&message, "topic", "0");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    outbound_message_init(&message, "topic", "1");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    outbound_message_init(&message, "topic", "2");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+
+    wrap_while_publishing(&persistence, "1");
+}
+
+void test_in_memory_packed_persistence_wrap_while_publishing(void)
+{
+    static uint8_t persistence_storage[3 * (RECORD_BUFFER_HEADER_SIZE + PACKED_RECORD_TOPIC_LENGTH_SIZE + 6)];
+    in_memory_packed_persistence_t packed_persistence;
+    persistence_t persistence;
+    outbound_message_t message;
+
+    in_memory_packed_persistence_init(&packed_persistence, persistence_storage, sizeof(persistence_storage), true);
+    persistence_init(&persistence, &packed_persistence, in_memory_packed_persistence_push,
+                     in_memory_packed_persistence_peek, in_memory_packed_persistence_pop,
+                     in_memory_packed_persistence_is_empty);
+    persistence_set_view(&persistence, in_memory_packed_persistence_peek_view, in_memory_packed_persistence_drop);
+    persistence_set_head_id(&persistence, in_memory_packed_persistence_head_id);
+
+    outbound_message_init(&message, "topic", "0");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    outbound_message_init(&message, "topic", "1");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    outbound_message_init(&message, "topic", "2");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+
+    wrap_while_publishing(&persistence, "1");
+}
+
+void test_persistence_head_id_is_kept_by_push_without_wrap(void)
+{
+    static outbound_message_t persistence_storage[3];
+    in_memory_persistence_t in_memory_persistence;
+    persistence_t persistence;
+    outbound_message_t message;
+
+    in_memory_persistence_init(&in_memory_persistence, persistence_storage, sizeof(persistence_storage), false);
+    persistence_init(&persistence, &in_memory_persistence, in_memory_persistence_push, in_memory_persistence_peek,
+                     in_memory_persistence_pop, in_memory_persistence_is_empty);
+    persistence_set_head_id(&persistence, in_memory_persistence_head_id);
+    TEST_ASSERT_TRUE(persistence_has_head_id(&persistence));
+
+    outbound_message_init(&message, "topic", "0");
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    const uint32_t head_id = persistence_head_id(&persistence);
+
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    TEST_ASSERT_TRUE(persistence_push(&persistence, &message));
+    TEST_ASSERT_FALSE(persistence_push(&persistence, &message));
+    TEST_ASSERT_EQUAL_UINT32(head_id, persistence_head_id(&persistence));
+
+    TEST_ASSERT_EQUAL(2, persistence_pop_n(&persistence, NULL, 2));
+    TEST_ASSERT_EQUAL_UINT32(head_id + 2, persistence_head_id(&persistence));
+}
+
+#endif // TEST
@@ -0,0 +1,105 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdio.h"
+#include "string.h"
+
+#include "size_definitions.h"
+#include "utility/reference_table.h"
+
+
+typedef struct {
+    char reference[REFERENCE_SIZE];
+    int value;
+} entry_t;
+
+static entry_t storage[8];
+static reference_table_t table;
+
+void setUp(void)
+{
+    reference_table_init(&table, storage, sizeof(entry_t), sizeof(storage) / sizeof(storage[0]));
+}
+
+void tearDown(void)
+{
+}
+
+
+void test_reference_table_insert_find(void)
+{
+    TEST_ASSERT_NULL(reference_table_find(&table, "T"));
+
+    entry_t* entry = (entry_t*)reference_table_insert(&table, "T");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_STRING("T", entry->reference);
+    TEST_ASSERT_EQUAL_INT(0, entry->value);
+    entry->value = 5;
+
+    TEST_ASSERT_EQUAL_PTR(entry, reference_table_find(&table, "T"));
+    TEST_ASSERT_EQUAL_PTR(entry, reference_table_insert(&table, "T"));
+    TEST_ASSERT_EQUAL_INT(5, entry->value);
+    TEST_ASSERT_EQUAL_UINT32(1, table.count);
+    TEST_ASSERT_EQUAL_PTR(entry, reference_table_at(&table, reference_table_index(&table, entry)));
+}
+
+void test_reference_table_full(void)
+{
+    char reference[REFERENCE_SIZE];
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        sprintf(reference, "F%d", i);
+        TEST_ASSERT_NOT_NULL(reference_table_insert(&table, reference));
+    }
+
+    TEST_ASSERT_NULL(reference_table_insert(&table, "F8"));
+    TEST_ASSERT_NULL(reference_table_find(&table, "F8"));
+    for (i = 0; i < 8; ++i) {
+        sprintf(reference, "F%d", i);
+        TEST_ASSERT_NOT_NULL(reference_table_find(&table, reference));
+    }
+}
+
+void test_reference_table_remove_keeps_colliding_entries(void)
+{
+    char reference[REFERENCE_SIZE];
+    int i;
+    int round;
+
+    /* Every removal from nearly full table is followed by lookups of all remaining entries */
+    for (round = 0; round < 7; ++round) {
+        reference_table_init(&table, storage, sizeof(entry_t), sizeof(storage) / sizeof(storage[0]));
+        for (i = 0; i < 7; ++i) {
+            sprintf(reference, "F%d", i);
+            ((entry_t*)reference_table_insert(&table, reference))->value = i;
+        }
+
+        sprintf(reference, "F%d", round);
+        reference_table_remove(&table, reference_table_find(&table, reference));
+        TEST_ASSERT_NULL(reference_table_find(&table, reference));
+        TEST_ASSERT_EQUAL_UINT32(6, table.count);
+
+        for (i = 0; i < 7; ++i) {
+            if (i == round) {
+                continue;
+            }
+
+            sprintf(reference, "F%d", i);
+            entry_t* entry = (entry_t*)reference_table_find(&table, reference);
+            TEST_ASSERT_NOT_NULL(entry);
+            TEST_ASSERT_EQUAL_INT(i, entry->value);
+        }
+    }
+}
+
+void test_reference_table_without_storage(void)
+{
+    reference_table_init(&table, NULL, sizeof(entry_t), 0);
+
+    TEST_ASSERT_NULL(reference_table_find(&table, "T"));
+    TEST_ASSERT_NULL(reference_table_insert(&table, "T"));
+}
+
+#endif // TEST
@@ -0,0 +1,81 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "string.h"
+
+#include "utility/sha256.h"
+
+
+static const uint8_t abc_hash[32] = {0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40,
+                                     0xde, 0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17,
+                                     0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+
+static const uint8_t two_blocks_hash[32] = {0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26,
+                                            0x93, 0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff,
+                                            0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1};
+
+static const uint8_t empty_hash[32] = {0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4,
+                                       0xc8, 0x99, 0x6f, 0xb9, 0x24, 0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b,
+                                       0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    sha256_set_implementation(SHA256_IMPLEMENTATION_PORTABLE);
+}
+
+
+static void assert_known_answers(void)
+{
+    uint8_t hash[32];
+
+    sha256("abc", 3, hash);
+    TEST_ASSERT_EQUAL_MEMORY(abc_hash, hash, sizeof(hash));
+
+    sha256("", 0, hash);
+    TEST_ASSERT_EQUAL_MEMORY(empty_hash, hash, sizeof(hash));
+
+    sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, hash);
+    TEST_ASSERT_EQUAL_MEMORY(two_blocks_hash, hash, sizeof(hash));
+}
+
+void test_sha256_portable_known_answers(void)
+{
+    TEST_ASSERT_TRUE(sha256_set_implementation(SHA256_IMPLEMENTATION_PORTABLE));
+    assert_known_answers();
+}
+
+void test_sha256_selected_implementation_matches_portable(void)
+{
+    static uint8_t data[1000];
+    uint8_t expected[32];
+    uint8_t hash[32];
+    sha256_context ctx;
+
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    sha256_select_implementation();
+    assert_known_answers();
+
+    for (size_t length = 0; length <= sizeof(data); length += 37) {
+        sha256_implementation_t implementation = sha256_get_implementation();
+        TEST_ASSERT_TRUE(sha256_set_implementation(SHA256_IMPLEMENTATION_PORTABLE));
+        sha256(data, length, expected);
+        TEST_ASSERT_TRUE(sha256_set_implementation(implementation));
+
+        /* Partial blocks across updates */
+        sha256_init(&ctx);
+        sha256_hash(&ctx, data, length / 3);
+        sha256_hash(&ctx, data + length / 3, length - length / 3);
+        sha256_done(&ctx, hash);
+        TEST_ASSERT_EQUAL_MEMORY(expected, hash, sizeof(hash));
+    }
+}
+
+#endif // TEST
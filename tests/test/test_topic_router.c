@@ -0,0 +1,92 @@
+#ifdef TEST
+
+#include "unity.h"
+
+#include "stdio.h"
+#include "string.h"
+
+#include "protocol/topic_router.h"
+
+
+static topic_router_t router;
+static int calls;
+static void* last_context;
+
+void setUp(void)
+{
+    calls = 0;
+    last_context = NULL;
+
+    topic_router_init(&router, "p2d/device/");
+}
+
+void tearDown(void)
+{
+}
+
+static void handler(void* context, char* payload, size_t payload_length)
+{
+    (void)payload;
+    (void)payload_length;
+
+    calls++;
+    last_context = context;
+}
+
+static const topic_route_t* find(const char* topic)
+{
+    return topic_router_find(&router, topic, strlen(topic));
+}
+
+
+void test_topic_router_finds_exact_message_type(void)
+{
+    int feed_values_context;
+    int parameters_context;
+
+    TEST_ASSERT_TRUE(topic_router_add(&router, "parameters", handler, &parameters_context));
+    TEST_ASSERT_TRUE(topic_router_add(&router, "feed_values", handler, &feed_values_context));
+    TEST_ASSERT_TRUE(topic_router_add(&router, "file_binary_response", handler, NULL));
+    TEST_ASSERT_EQUAL_UINT(3, router.number_of_routes);
+
+    const topic_route_t* route = find("p2d/device/feed_values");
+    TEST_ASSERT_NOT_NULL(route);
+    route->handler(route->context, NULL, 0);
+    TEST_ASSERT_EQUAL_PTR(&feed_values_context, last_context);
+
+    route = find("p2d/device/parameters");
+    TEST_ASSERT_NOT_NULL(route);
+    TEST_ASSERT_EQUAL_PTR(&parameters_context, route->context);
+
+    TEST_ASSERT_NULL(find("p2d/device/feed_value"));
+    TEST_ASSERT_NULL(find("p2d/device/feed_values/x"));
+    TEST_ASSERT_NULL(find("p2d/other/feed_values"));
+    TEST_ASSERT_NULL(find("p2d/device/"));
+}
+
+void test_topic_router_replaces_handler_and_limits_routes(void)
+{
+    char message_type[TOPIC_MESSAGE_TYPE_SIZE];
+    int context;
+    int i;
+
+    TEST_ASSERT_TRUE(topic_router_add(&router, "time", handler, NULL));
+    TEST_ASSERT_TRUE(topic_router_add(&router, "time", handler, &context));
+    TEST_ASSERT_EQUAL_UINT(1, router.number_of_routes);
+    TEST_ASSERT_EQUAL_PTR(&context, find("p2d/device/time")->context);
+
+    for (i = 1; i < TOPIC_ROUTES_MAX; ++i) {
+        sprintf(message_type, "custom_%02d", TOPIC_ROUTES_MAX - i);
+        TEST_ASSERT_TRUE(topic_router_add(&router, message_type, handler, NULL));
+    }
+    TEST_ASSERT_FALSE(topic_router_add(&router, "one_too_many", handler, NULL));
+
+    for (i = 1; i < TOPIC_ROUTES_MAX; ++i) {
+        char topic[TOPIC_SIZE];
+        sprintf(topic, "p2d/device/custom_%02d", i);
+        TEST_ASSERT_NOT_NULL(find(topic));
+    }
+    TEST_ASSERT_EQUAL_PTR(&context, find("p2d/device/time")->context);
+}
+
+#endif // TEST